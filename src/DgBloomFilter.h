@@ -0,0 +1,515 @@
+//@group Collections
+
+//! @file DgBloomFilter.h
+//!
+//! Class declaration: BloomFilter
+
+#ifndef DGBLOOMFILTER_H
+#define DGBLOOMFILTER_H
+
+#include <math.h>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "impl/DgFilterCommon.h"
+#include "DgBinaryReader.h"
+#include "DgBinaryWriter.h"
+#include "DgError.h"
+#include "DgOpenHashMap.h"
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class BloomFilter
+  //!
+  //! Blocked Bloom filter. Answers "definitely not present" or "possibly
+  //! present", so it can guard an expensive lookup.
+  //!
+  //! Each key maps to one 64-byte block (a cache line), and all of its bits are
+  //! set within that block. A query therefore touches a single cache line. The
+  //! bits for a key are built into an 8-word mask and tested with a fixed-length
+  //! loop, which compilers turn into vector instructions.
+  //!
+  //! HASHER is the same functor used by OpenHashMap; its result is mixed before
+  //! use, so the identity hasher is fine.
+  template<typename K, class HASHER = impl::OpenHashMap::SimpleHasher<K>>
+  class BloomFilter
+  {
+  public:
+
+    //! Size the filter for an expected number of keys and false positive rate.
+    BloomFilter(size_t expectedItems = 1024,
+                double falsePositiveRate = 0.01,
+                HASHER const & hasher = HASHER());
+    ~BloomFilter();
+
+    BloomFilter(BloomFilter const &);
+    BloomFilter & operator=(BloomFilter const &);
+
+    BloomFilter(BloomFilter &&) noexcept;
+    BloomFilter & operator=(BloomFilter &&) noexcept;
+
+    void insert(K const &);
+    void insert(K const * pKeys, size_t count);
+
+    //! False means the key was never inserted.
+    bool contains(K const &) const;
+
+    //! Writes one result per key to pOut.
+    //! @return Number of keys which are possibly present.
+    size_t contains(K const * pKeys, size_t count, bool * pOut) const;
+
+    void clear();
+
+    size_t block_count() const;
+    uint32_t hash_count() const;
+
+    ErrorCode Write(BinaryWriter &) const;
+
+    //! On failure the filter is left unchanged.
+    ErrorCode Read(BinaryReader &);
+
+  private:
+
+    static size_t const s_blockWords = 8;
+    static size_t const s_blockBits = s_blockWords * 64;
+    static uint32_t const s_maxHashes = 16;
+    static uint32_t const s_magic = 0x46424744; // 'DGBF'
+
+    struct alignas(64) Block
+    {
+      uint64_t words[s_blockWords];
+    };
+
+    //! Keys processed per batch in the bulk methods. Hashing a batch up front
+    //! lets the block loads overlap.
+    static size_t const s_batchSize = 16;
+
+    uint64_t Hash(K const &) const;
+    void MakeMask(uint64_t hash, uint64_t * pMask) const;
+    size_t BlockIndex(uint64_t hash) const;
+    static void InsertMask(Block &, uint64_t const * pMask);
+    static bool TestMask(Block const &, uint64_t const * pMask);
+
+    void Allocate(size_t nBlocks);
+    bool TryAllocate(size_t nBlocks);   // Returns false, leaving the filter empty, if out of memory
+    void Release();
+
+  private:
+
+    HASHER    m_hasher;
+    void *    m_pMemory;
+    Block *   m_pBlocks;
+    size_t    m_nBlocks;
+    uint32_t  m_nHashes;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::BloomFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER>::BloomFilter(size_t a_expectedItems, double a_falsePositiveRate, HASHER const & a_hasher)
+    : m_hasher(a_hasher)
+    , m_pMemory(nullptr)
+    , m_pBlocks(nullptr)
+    , m_nBlocks(0)
+    , m_nHashes(0)
+  {
+    if (!(a_falsePositiveRate > 0.0 && a_falsePositiveRate < 1.0))
+      throw std::invalid_argument("BloomFilter: false positive rate must be in (0, 1)");
+
+    if (a_expectedItems == 0)
+      a_expectedItems = 1;
+
+    double const ln2 = 0.69314718055994530942;
+    double bits = -static_cast<double>(a_expectedItems) * log(a_falsePositiveRate) / (ln2 * ln2);
+    double k = bits / static_cast<double>(a_expectedItems) * ln2;
+
+    //Keys spread unevenly over blocks, which raises the false positive rate of
+    //a blocked filter. Extra space brings it back near the request.
+    bits *= 1.1;
+
+    m_nHashes = static_cast<uint32_t>(k + 0.5);
+    if (m_nHashes < 1)
+      m_nHashes = 1;
+    if (m_nHashes > s_maxHashes)
+      m_nHashes = s_maxHashes;
+
+    Allocate(static_cast<size_t>(bits / static_cast<double>(s_blockBits)) + 1);
+  } //End: BloomFilter::BloomFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::~BloomFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER>::~BloomFilter()
+  {
+    Release();
+  } //End: BloomFilter::~BloomFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::BloomFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER>::BloomFilter(BloomFilter const & a_other)
+    : m_hasher(a_other.m_hasher)
+    , m_pMemory(nullptr)
+    , m_pBlocks(nullptr)
+    , m_nBlocks(0)
+    , m_nHashes(a_other.m_nHashes)
+  {
+    Allocate(a_other.m_nBlocks);
+    memcpy(m_pBlocks, a_other.m_pBlocks, m_nBlocks * sizeof(Block));
+  } //End: BloomFilter::BloomFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER> & BloomFilter<K, HASHER>::operator=(BloomFilter const & a_other)
+  {
+    if (this != &a_other)
+    {
+      if (m_nBlocks != a_other.m_nBlocks)
+      {
+        Release();
+        Allocate(a_other.m_nBlocks);
+      }
+      memcpy(m_pBlocks, a_other.m_pBlocks, m_nBlocks * sizeof(Block));
+      m_hasher = a_other.m_hasher;
+      m_nHashes = a_other.m_nHashes;
+    }
+    return *this;
+  } //End: BloomFilter::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::BloomFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER>::BloomFilter(BloomFilter && a_other) noexcept
+    : m_hasher(a_other.m_hasher)
+    , m_pMemory(a_other.m_pMemory)
+    , m_pBlocks(a_other.m_pBlocks)
+    , m_nBlocks(a_other.m_nBlocks)
+    , m_nHashes(a_other.m_nHashes)
+  {
+    a_other.m_pMemory = nullptr;
+    a_other.m_pBlocks = nullptr;
+    a_other.m_nBlocks = 0;
+  } //End: BloomFilter::BloomFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  BloomFilter<K, HASHER> & BloomFilter<K, HASHER>::operator=(BloomFilter && a_other) noexcept
+  {
+    if (this != &a_other)
+    {
+      Release();
+      m_hasher = a_other.m_hasher;
+      m_pMemory = a_other.m_pMemory;
+      m_pBlocks = a_other.m_pBlocks;
+      m_nBlocks = a_other.m_nBlocks;
+      m_nHashes = a_other.m_nHashes;
+
+      a_other.m_pMemory = nullptr;
+      a_other.m_pBlocks = nullptr;
+      a_other.m_nBlocks = 0;
+    }
+    return *this;
+  } //End: BloomFilter::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::Allocate()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::Allocate(size_t a_nBlocks)
+  {
+    if (!TryAllocate(a_nBlocks))
+      throw std::bad_alloc();
+  } //End: BloomFilter::Allocate()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::TryAllocate()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool BloomFilter<K, HASHER>::TryAllocate(size_t a_nBlocks)
+  {
+    //malloc does not promise cache line alignment, so over-allocate and align.
+    m_pMemory = malloc((a_nBlocks + 1) * sizeof(Block));
+    if (m_pMemory == nullptr)
+      return false;
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(m_pMemory);
+    addr = (addr + alignof(Block) - 1) & ~static_cast<uintptr_t>(alignof(Block) - 1);
+    m_pBlocks = reinterpret_cast<Block *>(addr);
+    m_nBlocks = a_nBlocks;
+    memset(m_pBlocks, 0, m_nBlocks * sizeof(Block));
+    return true;
+  } //End: BloomFilter::TryAllocate()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::Release()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::Release()
+  {
+    free(m_pMemory);
+    m_pMemory = nullptr;
+    m_pBlocks = nullptr;
+    m_nBlocks = 0;
+  } //End: BloomFilter::Release()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::clear()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::clear()
+  {
+    memset(m_pBlocks, 0, m_nBlocks * sizeof(Block));
+  } //End: BloomFilter::clear()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::block_count()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t BloomFilter<K, HASHER>::block_count() const
+  {
+    return m_nBlocks;
+  } //End: BloomFilter::block_count()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::hash_count()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  uint32_t BloomFilter<K, HASHER>::hash_count() const
+  {
+    return m_nHashes;
+  } //End: BloomFilter::hash_count()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::Hash()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  uint64_t BloomFilter<K, HASHER>::Hash(K const & a_key) const
+  {
+    return impl::Filter::Mix64(static_cast<uint64_t>(m_hasher(a_key)));
+  } //End: BloomFilter::Hash()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::BlockIndex()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t BloomFilter<K, HASHER>::BlockIndex(uint64_t a_hash) const
+  {
+    return static_cast<size_t>(impl::Filter::Reduce(static_cast<uint32_t>(a_hash >> 32), m_nBlocks));
+  } //End: BloomFilter::BlockIndex()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::MakeMask()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::MakeMask(uint64_t a_hash, uint64_t * a_pMask) const
+  {
+    for (size_t w = 0; w < s_blockWords; w++)
+      a_pMask[w] = 0;
+
+    //Double hashing within the block. The upper half of the hash picked the
+    //block, so derive the bit positions from the lower half.
+    uint32_t h1 = static_cast<uint32_t>(a_hash);
+    uint32_t h2 = static_cast<uint32_t>(impl::Filter::Mix64(a_hash) >> 32) | 1;
+    for (uint32_t i = 0; i < m_nHashes; i++)
+    {
+      uint32_t bit = (h1 + i * h2) & static_cast<uint32_t>(s_blockBits - 1);
+      a_pMask[bit >> 6] |= static_cast<uint64_t>(1) << (bit & 63);
+    }
+  } //End: BloomFilter::MakeMask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::InsertMask()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::InsertMask(Block & a_block, uint64_t const * a_pMask)
+  {
+    for (size_t w = 0; w < s_blockWords; w++)
+      a_block.words[w] |= a_pMask[w];
+  } //End: BloomFilter::InsertMask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::TestMask()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool BloomFilter<K, HASHER>::TestMask(Block const & a_block, uint64_t const * a_pMask)
+  {
+    //No early out, so the loop stays branch free.
+    uint64_t missing = 0;
+    for (size_t w = 0; w < s_blockWords; w++)
+      missing |= a_pMask[w] & ~a_block.words[w];
+    return missing == 0;
+  } //End: BloomFilter::TestMask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::insert()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::insert(K const & a_key)
+  {
+    uint64_t mask[s_blockWords];
+    uint64_t hash = Hash(a_key);
+    MakeMask(hash, mask);
+    InsertMask(m_pBlocks[BlockIndex(hash)], mask);
+  } //End: BloomFilter::insert()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::insert()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void BloomFilter<K, HASHER>::insert(K const * a_pKeys, size_t a_count)
+  {
+    uint64_t hashes[s_batchSize];
+    uint64_t mask[s_blockWords];
+
+    for (size_t base = 0; base < a_count; base += s_batchSize)
+    {
+      size_t n = a_count - base;
+      if (n > s_batchSize)
+        n = s_batchSize;
+
+      for (size_t i = 0; i < n; i++)
+        hashes[i] = Hash(a_pKeys[base + i]);
+
+      for (size_t i = 0; i < n; i++)
+      {
+        MakeMask(hashes[i], mask);
+        InsertMask(m_pBlocks[BlockIndex(hashes[i])], mask);
+      }
+    }
+  } //End: BloomFilter::insert()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::contains()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool BloomFilter<K, HASHER>::contains(K const & a_key) const
+  {
+    uint64_t mask[s_blockWords];
+    uint64_t hash = Hash(a_key);
+    MakeMask(hash, mask);
+    return TestMask(m_pBlocks[BlockIndex(hash)], mask);
+  } //End: BloomFilter::contains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::contains()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t BloomFilter<K, HASHER>::contains(K const * a_pKeys, size_t a_count, bool * a_pOut) const
+  {
+    uint64_t hashes[s_batchSize];
+    uint64_t mask[s_blockWords];
+    size_t nFound = 0;
+
+    for (size_t base = 0; base < a_count; base += s_batchSize)
+    {
+      size_t n = a_count - base;
+      if (n > s_batchSize)
+        n = s_batchSize;
+
+      for (size_t i = 0; i < n; i++)
+        hashes[i] = Hash(a_pKeys[base + i]);
+
+      for (size_t i = 0; i < n; i++)
+      {
+        MakeMask(hashes[i], mask);
+        bool found = TestMask(m_pBlocks[BlockIndex(hashes[i])], mask);
+        a_pOut[base + i] = found;
+        nFound += found ? 1 : 0;
+      }
+    }
+    return nFound;
+  } //End: BloomFilter::contains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::Write()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  ErrorCode BloomFilter<K, HASHER>::Write(BinaryWriter & a_writer) const
+  {
+    ErrorCode result;
+    uint32_t header[3] = {s_magic, impl::Filter::s_version, m_nHashes};
+    uint64_t nBlocks = static_cast<uint64_t>(m_nBlocks);
+    IO::myInt nWords = static_cast<IO::myInt>(m_nBlocks * s_blockWords);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint32_t>(header, 3), 3, ErrorCode::WriteError));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint64_t>(&nBlocks), 1, ErrorCode::WriteError));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint64_t>(&m_pBlocks[0].words[0], nWords), nWords, ErrorCode::WriteError));
+
+    result = ErrorCode::None;
+  epilogue:
+    return result;
+  } //End: BloomFilter::Write()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ BloomFilter::Read()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  ErrorCode BloomFilter<K, HASHER>::Read(BinaryReader & a_reader)
+  {
+    ErrorCode result;
+    uint32_t header[3] = {};
+    uint64_t nBlocks = 0;
+    IO::myInt nWords = 0;
+    BloomFilter temp(1, 0.5, m_hasher);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint32_t>(header, 3), 3, ErrorCode::IncorrectFileType));
+    DG_ERROR_IF(header[0] != s_magic || header[1] != impl::Filter::s_version, ErrorCode::IncorrectFileType);
+    DG_ERROR_IF(header[2] < 1 || header[2] > s_maxHashes, ErrorCode::InvalidInput);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint64_t>(&nBlocks), 1, ErrorCode::IncorrectFileType));
+    DG_ERROR_IF(nBlocks == 0 || nBlocks > SIZE_MAX / sizeof(Block) - 1, ErrorCode::InvalidInput);
+
+    //A corrupt count must not trigger a huge allocation before the short read is found.
+    DG_ERROR_IF(nBlocks > impl::Filter::RemainingBytes(a_reader) / sizeof(Block), ErrorCode::IncorrectFileType);
+
+    temp.Release();
+    DG_ERROR_IF(!temp.TryAllocate(static_cast<size_t>(nBlocks)), ErrorCode::FailedToAllocMem);
+    temp.m_nHashes = header[2];
+
+    nWords = static_cast<IO::myInt>(temp.m_nBlocks * s_blockWords);
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint64_t>(&temp.m_pBlocks[0].words[0], nWords), nWords, ErrorCode::IncorrectFileType));
+
+    *this = std::move(temp);
+    result = ErrorCode::None;
+  epilogue:
+    return result;
+  } //End: BloomFilter::Read()
+}
+
+#endif
@@ -0,0 +1,890 @@
+//@group Collections
+
+#ifndef DGCHUNKEDHYPERARRAY_H
+#define DGCHUNKEDHYPERARRAY_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+
+#include "DgHyperArray.h"
+#include "DgOpenHashMap.h"
+#include "DgStream.h"
+#include "DgWorkerPool.h"
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class ChunkedHyperArray
+  //!
+  //! A multi-dimensional array too large to hold in memory. The array is cut into
+  //! fixed-size chunks which live in a backing Stream, one after another in
+  //! row-major chunk order, with the elements of each chunk in row-major order.
+  //! At most maxResidentChunks chunks are held in memory; when a chunk is needed
+  //! and the cache is full, the least recently used chunk is evicted, and written
+  //! back if it was modified.
+  //!
+  //! Given a WorkerPool, chunks can be prefetched. A prefetched chunk is given a
+  //! cache slot straight away and loaded in the background; accessing it before
+  //! the load completes waits for it. Modified chunks are also written back in
+  //! the background: on eviction the chunk is copied to one of a few staging
+  //! buffers and the write is queued on the pool. Without a pool, evicted chunks
+  //! are written back by the evicting thread. All stream access is serialised by
+  //! an internal mutex, so the stream must not be used elsewhere while the array
+  //! exists.
+  //!
+  //! Element access is not thread safe. References returned by the accessors are
+  //! only valid until the next access, which may evict the chunk.
+  //!
+  //! T must be trivially copyable. Parts of the stream not yet written read as T().
+  template<typename T, size_t Dimensions>
+  class ChunkedHyperArray
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "ChunkedHyperArray elements must be trivially copyable");
+    static_assert(Dimensions > 0, "ChunkedHyperArray must have at least one dimension");
+
+    ChunkedHyperArray(ChunkedHyperArray const &) = delete;
+    ChunkedHyperArray & operator=(ChunkedHyperArray const &) = delete;
+
+  public:
+
+    typedef size_t SizeType;
+    typedef size_t IndexType;
+
+  public:
+
+    //! The stream must be readable, writable and seekable, and outlive the array.
+    //! pPool is optional; without it, prefetch requests are ignored.
+    ChunkedHyperArray(Stream * pStream,
+                      std::array<SizeType, Dimensions> const & dimensions,
+                      std::array<SizeType, Dimensions> const & chunkDimensions,
+                      size_t maxResidentChunks,
+                      WorkerPool * pPool = nullptr);
+
+    //! Waits for outstanding prefetches and write-backs, and writes back modified chunks.
+    ~ChunkedHyperArray();
+
+    SizeType length(size_t dimensionIndex) const;
+    SizeType chunk_length(size_t dimensionIndex) const;
+    size_t chunk_count() const;
+    size_t resident_chunk_count() const;
+
+    //! Access an element for writing. The containing chunk is marked as modified.
+    template <typename... Indices,
+              typename = std::enable_if_t<impl::are_all_integral<Indices...>::value && sizeof...(Indices) == Dimensions>
+             >
+    T & operator()(Indices... a_indices)
+    {
+      std::array<IndexType, Dimensions> indexArray = {{static_cast<IndexType>(a_indices)...}};
+      return Element(indexArray, true);
+    }
+
+    //! Access an element for reading. The containing chunk is not marked as modified.
+    template <typename... Indices,
+              typename = std::enable_if_t<impl::are_all_integral<Indices...>::value && sizeof...(Indices) == Dimensions>
+             >
+    T const & get(Indices... a_indices)
+    {
+      std::array<IndexType, Dimensions> indexArray = {{static_cast<IndexType>(a_indices)...}};
+      return Element(indexArray, false);
+    }
+
+    //! As operator(), with range checking.
+    template <typename... Indices,
+              typename = std::enable_if_t<impl::are_all_integral<Indices...>::value && sizeof...(Indices) == Dimensions>
+             >
+    T & at(Indices... a_indices)
+    {
+      std::array<IndexType, Dimensions> indexArray = {{static_cast<IndexType>(a_indices)...}};
+      RangeCheck(indexArray);
+      return Element(indexArray, true);
+    }
+
+    //! Start loading the chunk containing the element, if it is not resident.
+    void Prefetch(std::array<IndexType, Dimensions> const & index);
+
+    //! Start loading the chunks surrounding the chunk containing the element.
+    void PrefetchNeighbours(std::array<IndexType, Dimensions> const & index);
+
+    //! Write all modified chunks back to the stream. Also reports the failure of
+    //! any background write-back since the last call.
+    ErrorCode Flush();
+
+  private:
+
+    enum SlotState : uint32_t
+    {
+      SS_Empty,
+      SS_Loading,
+      SS_Ready,
+      SS_Failed
+    };
+
+    static uint32_t const INVALID_SLOT = 0xFFFFFFFF;
+
+    //! Most evicted chunks waiting to be written back at once.
+    static uint32_t const s_writeBackBuffers = 4;
+
+    struct Slot
+    {
+      size_t                chunk;
+      std::atomic<uint32_t> state;
+      bool                  dirty;
+      uint32_t              prev;   //Towards most recently used
+      uint32_t              next;   //Towards least recently used
+    };
+
+    //! A copy of an evicted chunk waiting to be written back. Only reused once the
+    //! write is done.
+    struct WriteBack
+    {
+      size_t                chunk;
+      std::atomic<uint32_t> busy;
+    };
+
+  private:
+
+    T & Element(std::array<IndexType, Dimensions> const &, bool markDirty);
+    void RangeCheck(std::array<IndexType, Dimensions> const &) const;
+
+    size_t ChunkIndex(std::array<IndexType, Dimensions> const &) const;
+    size_t LocalIndex(std::array<IndexType, Dimensions> const &) const;
+    T * SlotData(uint32_t) const;
+
+    //! Returns the slot holding the chunk, loading it if required.
+    uint32_t Acquire(size_t chunk);
+
+    //! Returns a free slot, evicting the least recently used chunk if needed.
+    uint32_t ClaimSlot();
+    void WaitForSlot(uint32_t);
+    void Touch(uint32_t);
+    void Unlink(uint32_t);
+    void PushFront(uint32_t);
+
+    //! The stream functions must be called with m_ioMutex held.
+    ErrorCode ReadChunk(uint32_t slot);
+    ErrorCode WriteChunk(size_t chunk, T const * pData);
+    ErrorCode WriteBackBuffer(uint32_t buffer);
+
+    void LoadTaskFn(uint32_t slot);
+    void WriteBackTaskFn(uint32_t buffer);
+
+    //! Copies the slot to a staging buffer and queues the write on the pool.
+    void QueueWriteBack(uint32_t slot);
+
+  private:
+
+    Stream *                            m_pStream;
+    WorkerPool *                        m_pPool;
+    std::array<SizeType, Dimensions>    m_lengths;
+    std::array<SizeType, Dimensions>    m_chunkLengths;
+    std::array<SizeType, Dimensions>    m_chunksPerDim;
+    std::array<SizeType, Dimensions>    m_chunkCoeffs;
+    std::array<SizeType, Dimensions>    m_localCoeffs;
+    size_t                              m_chunkElements;
+    size_t                              m_chunkCount;
+
+    size_t                              m_maxSlots;
+    size_t                              m_nSlots;
+    Slot *                              m_pSlots;
+    T *                                 m_pData;
+    uint32_t                            m_head;
+    uint32_t                            m_tail;
+
+    OpenHashMap<size_t, uint32_t>       m_chunkToSlot;
+    size_t                              m_lastChunk;
+    uint32_t                            m_lastSlot;
+
+    std::mutex                          m_ioMutex;
+    IO::myInt                           m_streamSize;
+    std::atomic<uint32_t>               m_pendingLoads;
+
+    T *                                 m_pWriteData;
+    WriteBack                           m_writeBacks[s_writeBackBuffers];
+    std::atomic<uint32_t>               m_pendingWrites;
+    std::atomic<ErrorCode>              m_writeError;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::ChunkedHyperArray()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ChunkedHyperArray<T, Dimensions>::ChunkedHyperArray(Stream * a_pStream,
+                                                      std::array<SizeType, Dimensions> const & a_dimensions,
+                                                      std::array<SizeType, Dimensions> const & a_chunkDimensions,
+                                                      size_t a_maxResidentChunks,
+                                                      WorkerPool * a_pPool)
+    : m_pStream(a_pStream)
+    , m_pPool(a_pPool)
+    , m_lengths(a_dimensions)
+    , m_chunkLengths(a_chunkDimensions)
+    , m_maxSlots(a_maxResidentChunks == 0 ? 1 : a_maxResidentChunks)
+    , m_nSlots(0)
+    , m_pSlots(nullptr)
+    , m_pData(nullptr)
+    , m_head(INVALID_SLOT)
+    , m_tail(INVALID_SLOT)
+    , m_lastChunk(0)
+    , m_lastSlot(INVALID_SLOT)
+    , m_streamSize(0)
+    , m_pendingLoads(0)
+    , m_pWriteData(nullptr)
+    , m_pendingWrites(0)
+    , m_writeError(ErrorCode::None)
+  {
+    if (m_pStream == nullptr || !m_pStream->IsReadable() || !m_pStream->IsWritable() || !m_pStream->IsSeekable())
+    {
+      throw std::invalid_argument("ChunkedHyperArray requires a readable, writable and seekable stream");
+    }
+
+    //Nothing else may use the stream, so its size only changes through WriteChunk().
+    IO::ReturnType rt = m_pStream->GetSize();
+    if (rt.error != ErrorCode::None)
+    {
+      throw std::runtime_error("ChunkedHyperArray failed to read the stream size");
+    }
+    m_streamSize = rt.value;
+
+    for (uint32_t i = 0; i < s_writeBackBuffers; i++)
+    {
+      m_writeBacks[i].chunk = 0;
+      m_writeBacks[i].busy.store(0, std::memory_order_relaxed);
+    }
+
+    m_chunkElements = 1;
+    m_chunkCount = 1;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      if (m_chunkLengths[i] == 0) m_chunkLengths[i] = 1;
+      m_chunksPerDim[i] = (m_lengths[i] + m_chunkLengths[i] - 1) / m_chunkLengths[i];
+      m_chunkElements *= m_chunkLengths[i];
+      m_chunkCount *= m_chunksPerDim[i];
+    }
+
+    m_chunkCoeffs[Dimensions - 1] = 1;
+    m_localCoeffs[Dimensions - 1] = 1;
+    for (size_t i = Dimensions - 1; i > 0; i--)
+    {
+      m_chunkCoeffs[i - 1] = m_chunkCoeffs[i] * m_chunksPerDim[i];
+      m_localCoeffs[i - 1] = m_localCoeffs[i] * m_chunkLengths[i];
+    }
+
+    m_pSlots = static_cast<Slot *>(malloc(m_maxSlots * sizeof(Slot)));
+    m_pData = static_cast<T *>(malloc(m_maxSlots * m_chunkElements * sizeof(T)));
+    if (m_pPool != nullptr)
+    {
+      m_pWriteData = static_cast<T *>(malloc(s_writeBackBuffers * m_chunkElements * sizeof(T)));
+    }
+    if (m_pSlots == nullptr || m_pData == nullptr || (m_pPool != nullptr && m_pWriteData == nullptr))
+    {
+      free(m_pSlots);
+      free(m_pData);
+      free(m_pWriteData);
+      throw std::bad_alloc();
+    }
+  } //End: ChunkedHyperArray::ChunkedHyperArray()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::~ChunkedHyperArray()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ChunkedHyperArray<T, Dimensions>::~ChunkedHyperArray()
+  {
+    Flush();
+    for (size_t i = 0; i < m_nSlots; i++)
+    {
+      m_pSlots[i].~Slot();
+    }
+    free(m_pSlots);
+    free(m_pData);
+    free(m_pWriteData);
+  } //End: ChunkedHyperArray::~ChunkedHyperArray()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::length()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::length(size_t a_dimensionIndex) const
+  {
+    if (a_dimensionIndex >= Dimensions)
+    {
+      throw std::out_of_range("The dimension index must be within [0, Dimensions-1]");
+    }
+    return m_lengths[a_dimensionIndex];
+  } //End: ChunkedHyperArray::length()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::chunk_length()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::chunk_length(size_t a_dimensionIndex) const
+  {
+    if (a_dimensionIndex >= Dimensions)
+    {
+      throw std::out_of_range("The dimension index must be within [0, Dimensions-1]");
+    }
+    return m_chunkLengths[a_dimensionIndex];
+  } //End: ChunkedHyperArray::chunk_length()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::chunk_count()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::chunk_count() const
+  {
+    return m_chunkCount;
+  } //End: ChunkedHyperArray::chunk_count()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::resident_chunk_count()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::resident_chunk_count() const
+  {
+    return m_chunkToSlot.size();
+  } //End: ChunkedHyperArray::resident_chunk_count()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::RangeCheck()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::RangeCheck(std::array<IndexType, Dimensions> const & a_index) const
+  {
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      if (a_index[i] >= m_lengths[i])
+      {
+        throw std::out_of_range("ChunkedHyperArray index out of range");
+      }
+    }
+  } //End: ChunkedHyperArray::RangeCheck()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::ChunkIndex()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::ChunkIndex(std::array<IndexType, Dimensions> const & a_index) const
+  {
+    size_t result = 0;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      result += (a_index[i] / m_chunkLengths[i]) * m_chunkCoeffs[i];
+    }
+    return result;
+  } //End: ChunkedHyperArray::ChunkIndex()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::LocalIndex()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  size_t ChunkedHyperArray<T, Dimensions>::LocalIndex(std::array<IndexType, Dimensions> const & a_index) const
+  {
+    size_t result = 0;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      result += (a_index[i] % m_chunkLengths[i]) * m_localCoeffs[i];
+    }
+    return result;
+  } //End: ChunkedHyperArray::LocalIndex()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::SlotData()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  T * ChunkedHyperArray<T, Dimensions>::SlotData(uint32_t a_slot) const
+  {
+    return m_pData + a_slot * m_chunkElements;
+  } //End: ChunkedHyperArray::SlotData()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Element()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  T & ChunkedHyperArray<T, Dimensions>::Element(std::array<IndexType, Dimensions> const & a_index, bool a_markDirty)
+  {
+    size_t chunk = ChunkIndex(a_index);
+
+    //Most accesses fall in the same chunk as the last one.
+    uint32_t slot = m_lastSlot;
+    if (slot == INVALID_SLOT || chunk != m_lastChunk)
+    {
+      slot = Acquire(chunk);
+      m_lastChunk = chunk;
+      m_lastSlot = slot;
+    }
+
+    if (a_markDirty)
+      m_pSlots[slot].dirty = true;
+
+    return SlotData(slot)[LocalIndex(a_index)];
+  } //End: ChunkedHyperArray::Element()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Acquire()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  uint32_t ChunkedHyperArray<T, Dimensions>::Acquire(size_t a_chunk)
+  {
+    uint32_t slot;
+    uint32_t * pSlot = m_chunkToSlot.at(a_chunk);
+    if (pSlot != nullptr)
+    {
+      slot = *pSlot;
+      if (m_pSlots[slot].state.load(std::memory_order_acquire) != SS_Failed)
+      {
+        WaitForSlot(slot);
+        Touch(slot);
+        return slot;
+      }
+
+      //A background load failed; retry it here so the error reaches the caller.
+      Unlink(slot);
+      m_chunkToSlot.erase(a_chunk);
+    }
+    else
+    {
+      slot = ClaimSlot();
+    }
+
+    m_pSlots[slot].chunk = a_chunk;
+    m_pSlots[slot].dirty = false;
+    m_chunkToSlot.insert(a_chunk, slot);
+    PushFront(slot);
+
+    ErrorCode result;
+    {
+      std::lock_guard<std::mutex> lock(m_ioMutex);
+      result = ReadChunk(slot);
+    }
+
+    if (result != ErrorCode::None)
+    {
+      m_pSlots[slot].state.store(SS_Failed, std::memory_order_relaxed);
+      throw std::runtime_error("ChunkedHyperArray failed to read chunk");
+    }
+
+    m_pSlots[slot].state.store(SS_Ready, std::memory_order_relaxed);
+    return slot;
+  } //End: ChunkedHyperArray::Acquire()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::WaitForSlot()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::WaitForSlot(uint32_t a_slot)
+  {
+    uint32_t state;
+    while ((state = m_pSlots[a_slot].state.load(std::memory_order_acquire)) == SS_Loading)
+    {
+      std::this_thread::yield();
+    }
+
+    if (state == SS_Failed)
+    {
+      throw std::runtime_error("ChunkedHyperArray failed to read chunk");
+    }
+  } //End: ChunkedHyperArray::WaitForSlot()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::ClaimSlot()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  uint32_t ChunkedHyperArray<T, Dimensions>::ClaimSlot()
+  {
+    if (m_nSlots < m_maxSlots)
+    {
+      uint32_t slot = static_cast<uint32_t>(m_nSlots);
+      new (&m_pSlots[slot]) Slot();
+      m_pSlots[slot].state.store(SS_Empty, std::memory_order_relaxed);
+      m_nSlots++;
+      return slot;
+    }
+
+    uint32_t slot = m_tail;
+    Slot & victim = m_pSlots[slot];
+
+    //A failed load is simply dropped. Anything else must have finished loading
+    //before the slot can be reused.
+    if (victim.state.load(std::memory_order_acquire) != SS_Failed)
+    {
+      WaitForSlot(slot);
+      if (m_writeError.exchange(ErrorCode::None, std::memory_order_relaxed) != ErrorCode::None)
+      {
+        throw std::runtime_error("ChunkedHyperArray failed to write chunk");
+      }
+
+      if (victim.dirty)
+      {
+        if (m_pPool != nullptr)
+        {
+          QueueWriteBack(slot);
+        }
+        else
+        {
+          ErrorCode result;
+          {
+            std::lock_guard<std::mutex> lock(m_ioMutex);
+            result = WriteChunk(victim.chunk, SlotData(slot));
+          }
+          if (result != ErrorCode::None)
+          {
+            throw std::runtime_error("ChunkedHyperArray failed to write chunk");
+          }
+        }
+      }
+    }
+
+    Unlink(slot);
+    m_chunkToSlot.erase(victim.chunk);
+    if (m_lastSlot == slot)
+      m_lastSlot = INVALID_SLOT;
+    victim.dirty = false;
+    victim.state.store(SS_Empty, std::memory_order_relaxed);
+    return slot;
+  } //End: ChunkedHyperArray::ClaimSlot()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Unlink()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::Unlink(uint32_t a_slot)
+  {
+    Slot & s = m_pSlots[a_slot];
+    if (s.prev != INVALID_SLOT)
+      m_pSlots[s.prev].next = s.next;
+    else
+      m_head = s.next;
+
+    if (s.next != INVALID_SLOT)
+      m_pSlots[s.next].prev = s.prev;
+    else
+      m_tail = s.prev;
+  } //End: ChunkedHyperArray::Unlink()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::PushFront()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::PushFront(uint32_t a_slot)
+  {
+    Slot & s = m_pSlots[a_slot];
+    s.prev = INVALID_SLOT;
+    s.next = m_head;
+    if (m_head != INVALID_SLOT)
+      m_pSlots[m_head].prev = a_slot;
+    else
+      m_tail = a_slot;
+    m_head = a_slot;
+  } //End: ChunkedHyperArray::PushFront()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Touch()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::Touch(uint32_t a_slot)
+  {
+    if (m_head == a_slot)
+      return;
+    Unlink(a_slot);
+    PushFront(a_slot);
+  } //End: ChunkedHyperArray::Touch()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::ReadChunk()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ErrorCode ChunkedHyperArray<T, Dimensions>::ReadChunk(uint32_t a_slot)
+  {
+    T * pData = SlotData(a_slot);
+    size_t chunk = m_pSlots[a_slot].chunk;
+    IO::myInt chunkBytes = static_cast<IO::myInt>(m_chunkElements * sizeof(T));
+    IO::myInt offset = static_cast<IO::myInt>(chunk) * chunkBytes;
+
+    //A chunk read back before its write-back has run is written out first. The
+    //lock is held, so a busy buffer's write has not started.
+    for (uint32_t i = 0; i < s_writeBackBuffers; i++)
+    {
+      WriteBack & wb = m_writeBacks[i];
+      if (wb.busy.load(std::memory_order_acquire) != 0 && wb.chunk == chunk)
+      {
+        ErrorCode result = WriteBackBuffer(i);
+        if (result != ErrorCode::None)
+          return result;
+      }
+    }
+
+    size_t nRead = 0;
+    if (m_streamSize > offset)
+    {
+      IO::ReturnType rt = m_pStream->Seek(offset, StreamSeekOrigin::begin);
+      if (rt.error != ErrorCode::None)
+        return rt.error;
+
+      rt = m_pStream->Read(pData, chunkBytes);
+      if (rt.error != ErrorCode::None)
+        return rt.error;
+      nRead = static_cast<size_t>(rt.value) / sizeof(T);
+    }
+
+    //Anything past the end of the stream has not been written yet.
+    for (size_t i = nRead; i < m_chunkElements; i++)
+    {
+      pData[i] = T();
+    }
+    return ErrorCode::None;
+  } //End: ChunkedHyperArray::ReadChunk()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::WriteChunk()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ErrorCode ChunkedHyperArray<T, Dimensions>::WriteChunk(size_t a_chunk, T const * a_pData)
+  {
+    IO::myInt chunkBytes = static_cast<IO::myInt>(m_chunkElements * sizeof(T));
+    IO::myInt offset = static_cast<IO::myInt>(a_chunk) * chunkBytes;
+
+    IO::ReturnType rt = m_pStream->Seek(offset, StreamSeekOrigin::begin);
+    if (rt.error != ErrorCode::None)
+      return rt.error;
+
+    rt = m_pStream->Write(a_pData, chunkBytes);
+    if (rt.error != ErrorCode::None)
+      return rt.error;
+
+    if (offset + chunkBytes > m_streamSize)
+      m_streamSize = offset + chunkBytes;
+    return ErrorCode::None;
+  } //End: ChunkedHyperArray::WriteChunk()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::WriteBackBuffer()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ErrorCode ChunkedHyperArray<T, Dimensions>::WriteBackBuffer(uint32_t a_buffer)
+  {
+    WriteBack & wb = m_writeBacks[a_buffer];
+    ErrorCode result = WriteChunk(wb.chunk, m_pWriteData + a_buffer * m_chunkElements);
+    if (result != ErrorCode::None)
+      m_writeError.store(result, std::memory_order_relaxed);
+    wb.busy.store(0, std::memory_order_release);
+    return result;
+  } //End: ChunkedHyperArray::WriteBackBuffer()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::QueueWriteBack()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::QueueWriteBack(uint32_t a_slot)
+  {
+    uint32_t buffer = INVALID_SLOT;
+    while (true)
+    {
+      for (uint32_t i = 0; i < s_writeBackBuffers; i++)
+      {
+        if (m_writeBacks[i].busy.load(std::memory_order_acquire) == 0)
+        {
+          buffer = i;
+          break;
+        }
+      }
+
+      if (buffer != INVALID_SLOT)
+        break;
+
+      //All buffers are waiting on the pool; lend it a hand.
+      if (!m_pPool->RunPendingTask())
+        std::this_thread::yield();
+    }
+
+    WriteBack & wb = m_writeBacks[buffer];
+    wb.chunk = m_pSlots[a_slot].chunk;
+    memcpy(m_pWriteData + buffer * m_chunkElements, SlotData(a_slot), m_chunkElements * sizeof(T));
+    wb.busy.store(1, std::memory_order_release);
+
+    //A task finding its buffer already written, by ReadChunk(), does nothing.
+    m_pendingWrites.fetch_add(1, std::memory_order_relaxed);
+    auto task = [this, buffer]() { WriteBackTaskFn(buffer); };
+    if (m_pPool->AddTask(task) != ErrorCode::None)
+    {
+      task();
+    }
+  } //End: ChunkedHyperArray::QueueWriteBack()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::WriteBackTaskFn()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::WriteBackTaskFn(uint32_t a_buffer)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_ioMutex);
+      if (m_writeBacks[a_buffer].busy.load(std::memory_order_acquire) != 0)
+        WriteBackBuffer(a_buffer);
+    }
+    m_pendingWrites.fetch_sub(1, std::memory_order_release);
+  } //End: ChunkedHyperArray::WriteBackTaskFn()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::LoadTaskFn()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::LoadTaskFn(uint32_t a_slot)
+  {
+    ErrorCode result;
+    {
+      std::lock_guard<std::mutex> lock(m_ioMutex);
+      result = ReadChunk(a_slot);
+    }
+
+    m_pSlots[a_slot].state.store(result == ErrorCode::None ? SS_Ready : SS_Failed, std::memory_order_release);
+    m_pendingLoads.fetch_sub(1, std::memory_order_release);
+  } //End: ChunkedHyperArray::LoadTaskFn()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Prefetch()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::Prefetch(std::array<IndexType, Dimensions> const & a_index)
+  {
+    if (m_pPool == nullptr)
+      return;
+
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      if (a_index[i] >= m_lengths[i])
+        return;
+    }
+
+    size_t chunk = ChunkIndex(a_index);
+    if (m_chunkToSlot.at(chunk) != nullptr)
+      return;
+
+    //Never evict the chunk currently being accessed for a speculative load.
+    if (m_nSlots == m_maxSlots && (m_maxSlots == 1 || m_tail == m_lastSlot))
+      return;
+
+    uint32_t slot = ClaimSlot();
+    Slot & s = m_pSlots[slot];
+    s.chunk = chunk;
+    s.dirty = false;
+    s.state.store(SS_Loading, std::memory_order_relaxed);
+    m_chunkToSlot.insert(chunk, slot);
+    PushFront(slot);
+
+    m_pendingLoads.fetch_add(1, std::memory_order_relaxed);
+    auto task = [this, slot]() { LoadTaskFn(slot); };
+    if (m_pPool->AddTask(task) != ErrorCode::None)
+    {
+      //Fall back to a synchronous load.
+      task();
+    }
+  } //End: ChunkedHyperArray::Prefetch()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::PrefetchNeighbours()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  void ChunkedHyperArray<T, Dimensions>::PrefetchNeighbours(std::array<IndexType, Dimensions> const & a_index)
+  {
+    //Walk the 3^D block of chunks around the one containing the index.
+    std::array<int, Dimensions> offset;
+    offset.fill(-1);
+    while (true)
+    {
+      bool valid = true;
+      bool centre = true;
+      std::array<IndexType, Dimensions> index;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        IndexType chunkCoord = a_index[i] / m_chunkLengths[i];
+        if ((offset[i] < 0 && chunkCoord == 0) || (offset[i] > 0 && chunkCoord + 1 >= m_chunksPerDim[i]))
+        {
+          valid = false;
+          break;
+        }
+        if (offset[i] != 0)
+          centre = false;
+        index[i] = (chunkCoord + offset[i]) * m_chunkLengths[i];
+      }
+
+      if (valid && !centre)
+        Prefetch(index);
+
+      size_t d = Dimensions;
+      while (d > 0)
+      {
+        d--;
+        offset[d]++;
+        if (offset[d] <= 1)
+          break;
+        offset[d] = -1;
+        if (d == 0)
+          return;
+      }
+    }
+  } //End: ChunkedHyperArray::PrefetchNeighbours()
+
+
+  //-------------------------------------------------------------------------------
+  //	@	ChunkedHyperArray::Flush()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions>
+  ErrorCode ChunkedHyperArray<T, Dimensions>::Flush()
+  {
+    while (m_pendingLoads.load(std::memory_order_acquire) != 0
+        || m_pendingWrites.load(std::memory_order_acquire) != 0)
+    {
+      std::this_thread::yield();
+    }
+
+    ErrorCode result = m_writeError.exchange(ErrorCode::None, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_ioMutex);
+    for (uint32_t slot = m_head; slot != INVALID_SLOT; slot = m_pSlots[slot].next)
+    {
+      if (m_pSlots[slot].dirty)
+      {
+        ErrorCode code = WriteChunk(m_pSlots[slot].chunk, SlotData(slot));
+        if (code != ErrorCode::None)
+          result = code;
+        else
+          m_pSlots[slot].dirty = false;
+      }
+    }
+    return result;
+  } //End: ChunkedHyperArray::Flush()
+}
+
+#endif
@@ -30,7 +30,7 @@ namespace Dg
   //!
   //! @author Frank B. Hart
   //! @date 25/08/2016
-  template<typename T>
+  template<typename T, typename POOL = PoolSizeMngr_Default>
   class CircularDoublyLinkedList
   {
   private:
@@ -201,7 +201,7 @@ namespace Dg
 
   private:
 
-    PoolSizeMngr_Default m_poolSize;
+    POOL m_poolSize;
     Node *          m_pNodes;      //Pre-allocated block of memory to hold items
     size_t          m_nItems;     //Number of items currently in the CircularDoublyLinkedList
   };
@@ -209,56 +209,56 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		const_iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  CircularDoublyLinkedList<T>::const_iterator::const_iterator(Node const * a_pNode)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::const_iterator::const_iterator(Node const * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::const_iterator::const_iterator()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::const_iterator::const_iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::const_iterator::~const_iterator()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::const_iterator::const_iterator(const_iterator const & a_it)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::const_iterator::const_iterator(const_iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator &
-    CircularDoublyLinkedList<T>::const_iterator::operator=(const_iterator const & a_other)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator &
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator=(const_iterator const & a_other)
   {
     m_pNode = a_other.m_pNode;
     return *this;
   }
 
-  template<typename T>
-  bool CircularDoublyLinkedList<T>::const_iterator::operator==(const_iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool CircularDoublyLinkedList<T, POOL>::const_iterator::operator==(const_iterator const & a_it) const 
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename T>
-  bool CircularDoublyLinkedList<T>::const_iterator::operator!=(const_iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool CircularDoublyLinkedList<T, POOL>::const_iterator::operator!=(const_iterator const & a_it) const 
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator
-    CircularDoublyLinkedList<T>::const_iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator+(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -268,9 +268,9 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator
-    CircularDoublyLinkedList<T>::const_iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator-(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -280,9 +280,9 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator &
-    CircularDoublyLinkedList<T>::const_iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator &
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->m_pNext;
@@ -290,9 +290,9 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator &
-    CircularDoublyLinkedList<T>::const_iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator &
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->m_pPrev;
@@ -300,50 +300,50 @@ namespace Dg
     return *this;
   }
   
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator &
-    CircularDoublyLinkedList<T>::const_iterator::operator++()
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator &
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator++()
   {
     m_pNode = m_pNode->pNext;
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator
-    CircularDoublyLinkedList<T>::const_iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator &
-    CircularDoublyLinkedList<T>::const_iterator::operator--()
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator &
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator--()
   {
     m_pNode = m_pNode->pPrev;
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator
-    CircularDoublyLinkedList<T>::const_iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T const *
-    CircularDoublyLinkedList<T>::const_iterator::operator->() const 
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator->() const 
   {
     return &m_pNode->data;
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T const &
-    CircularDoublyLinkedList<T>::const_iterator::operator*() const 
+    CircularDoublyLinkedList<T, POOL>::const_iterator::operator*() const 
   {
     return m_pNode->data;
   }
@@ -351,56 +351,56 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  CircularDoublyLinkedList<T>::iterator::iterator(Node * a_pNode)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::iterator::iterator(Node * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::iterator::iterator()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::iterator::iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::iterator::~iterator()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::iterator::iterator(iterator const & a_it)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::iterator::iterator(iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator &
-    CircularDoublyLinkedList<T>::iterator::operator=(iterator const & a_other)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator &
+    CircularDoublyLinkedList<T, POOL>::iterator::operator=(iterator const & a_other)
   {
     m_pNode = a_other.m_pNode;
     return *this;
   }
 
-  template<typename T>
-  bool CircularDoublyLinkedList<T>::iterator::operator==(iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool CircularDoublyLinkedList<T, POOL>::iterator::operator==(iterator const & a_it) const 
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename T>
-  bool CircularDoublyLinkedList<T>::iterator::operator!=(iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool CircularDoublyLinkedList<T, POOL>::iterator::operator!=(iterator const & a_it) const 
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::iterator::operator+(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -410,9 +410,9 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::iterator::operator-(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -422,9 +422,9 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator &
-    CircularDoublyLinkedList<T>::iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator &
+    CircularDoublyLinkedList<T, POOL>::iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->m_pNext;
@@ -432,9 +432,9 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator &
-    CircularDoublyLinkedList<T>::iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator &
+    CircularDoublyLinkedList<T, POOL>::iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->m_pPrev;
@@ -442,57 +442,57 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator &
-    CircularDoublyLinkedList<T>::iterator::operator++()
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator &
+    CircularDoublyLinkedList<T, POOL>::iterator::operator++()
   {
     m_pNode = m_pNode->pNext;
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator &
-    CircularDoublyLinkedList<T>::iterator::operator--()
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator &
+    CircularDoublyLinkedList<T, POOL>::iterator::operator--()
   {
     m_pNode = m_pNode->pPrev;
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T *
-    CircularDoublyLinkedList<T>::iterator::operator->()
+    CircularDoublyLinkedList<T, POOL>::iterator::operator->()
   {
     return &(m_pNode->data);
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T &
-    CircularDoublyLinkedList<T>::iterator::operator*()
+    CircularDoublyLinkedList<T, POOL>::iterator::operator*()
   {
     return m_pNode->data;
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::iterator::operator
-    typename CircularDoublyLinkedList<T>::const_iterator() const
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::iterator::operator
+    typename CircularDoublyLinkedList<T, POOL>::const_iterator() const
   {
     return const_iterator(m_pNode);
   }
@@ -500,8 +500,8 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		CircularDoublyLinkedList
   //--------------------------------------------------------------------------------
-  template<typename T>
-  CircularDoublyLinkedList<T>::CircularDoublyLinkedList()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::CircularDoublyLinkedList()
     : m_nItems(0)
     , m_pNodes(nullptr)
   {
@@ -509,8 +509,8 @@ namespace Dg
     InitHead();
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::CircularDoublyLinkedList(size_t a_size)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::CircularDoublyLinkedList(size_t a_size)
     : m_nItems(0)
     , m_pNodes(nullptr)
   {
@@ -519,15 +519,15 @@ namespace Dg
     InitHead();
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::~CircularDoublyLinkedList()
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::~CircularDoublyLinkedList()
   {
     DestructAll();
     free(m_pNodes);
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::CircularDoublyLinkedList(CircularDoublyLinkedList const & a_other)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::CircularDoublyLinkedList(CircularDoublyLinkedList const & a_other)
     : m_poolSize(a_other.m_poolSize)
     , m_nItems(0)
     , m_pNodes(nullptr)
@@ -536,9 +536,9 @@ namespace Dg
     Init(a_other);
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T> & 
-    CircularDoublyLinkedList<T>::operator=(CircularDoublyLinkedList const & a_other)
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL> & 
+    CircularDoublyLinkedList<T, POOL>::operator=(CircularDoublyLinkedList const & a_other)
   {
     if (this != &a_other)
     {
@@ -561,8 +561,8 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T>::CircularDoublyLinkedList(CircularDoublyLinkedList && a_other) noexcept
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL>::CircularDoublyLinkedList(CircularDoublyLinkedList && a_other) noexcept
     : m_poolSize(a_other.m_poolSize)
     , m_nItems(a_other.m_nItems)
     , m_pNodes(a_other.m_pNodes)
@@ -571,9 +571,9 @@ namespace Dg
     a_other.m_nItems = 0;
   }
 
-  template<typename T>
-  CircularDoublyLinkedList<T> & 
-    CircularDoublyLinkedList<T>::operator=(CircularDoublyLinkedList && a_other) noexcept
+  template<typename T, typename POOL>
+  CircularDoublyLinkedList<T, POOL> & 
+    CircularDoublyLinkedList<T, POOL>::operator=(CircularDoublyLinkedList && a_other) noexcept
   {
     if (this != &a_other)
     {
@@ -587,71 +587,71 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator 
-    CircularDoublyLinkedList<T>::head() 
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator 
+    CircularDoublyLinkedList<T, POOL>::head() 
   {
     return iterator(m_pNodes);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::const_iterator
-    CircularDoublyLinkedList<T>::chead() const 
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::const_iterator
+    CircularDoublyLinkedList<T, POOL>::chead() const 
   {
     return const_iterator(m_pNodes);
   }
 
-  template<typename T>
-  size_t CircularDoublyLinkedList<T>::size() const 
+  template<typename T, typename POOL>
+  size_t CircularDoublyLinkedList<T, POOL>::size() const 
   {
     return m_nItems;
   }
 
-  template<typename T>
-  bool CircularDoublyLinkedList<T>::empty() const 
+  template<typename T, typename POOL>
+  bool CircularDoublyLinkedList<T, POOL>::empty() const 
   {
     return m_nItems == 0;
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::push_back(T const & a_item)
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::push_back(T const & a_item)
   {
     InsertNewAfter(m_pNodes[0].pPrev, a_item);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::insert(iterator const & a_position, T const & a_item)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::insert(iterator const & a_position, T const & a_item)
   {
     Node * pNode = InsertNewAfter(a_position.m_pNode->pPrev, a_item);
     return iterator(pNode);
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::iterator
-    CircularDoublyLinkedList<T>::erase(iterator const & a_position)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::iterator
+    CircularDoublyLinkedList<T, POOL>::erase(iterator const & a_position)
   {
     Node * pNode = Remove(a_position.m_pNode);
     return iterator(pNode);
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::clear()
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::clear()
   {
     DestructAll();
     InitHead();
     m_nItems = 0;
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::resize(size_t a_newSize)
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::resize(size_t a_newSize)
   {
     DestructAll();
     Init(a_newSize);
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::Extend()
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::Extend()
   {
     Node * pOldNodes(m_pNodes);
     size_t oldSize = m_poolSize.GetSize();
@@ -676,9 +676,9 @@ namespace Dg
     }
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::Node *
-    CircularDoublyLinkedList<T>::InsertNewAfter(Node * a_pNode, T const & a_data)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::Node *
+    CircularDoublyLinkedList<T, POOL>::InsertNewAfter(Node * a_pNode, T const & a_data)
   {
     if (m_nItems == (m_poolSize.GetSize() - 1))
     {
@@ -701,23 +701,23 @@ namespace Dg
     return newNode;
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::DestructAll()
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::DestructAll()
   {
     for (size_t i = 0; i < m_nItems; i++)
       m_pNodes[i].data.~T();
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::InitMemory()
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::InitMemory()
   {
     m_pNodes = static_cast<Node*> (realloc(m_pNodes, m_poolSize.GetSize() * sizeof(Node)));
     if (m_pNodes == nullptr)
       throw std::bad_alloc();
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::Init(CircularDoublyLinkedList const & a_other)
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::Init(CircularDoublyLinkedList const & a_other)
   {
     m_nItems = a_other.m_nItems;
 
@@ -740,16 +740,16 @@ namespace Dg
     m_pNodes[m_nItems - 1].pNext = m_pNodes;
   }
 
-  template<typename T>
-  void CircularDoublyLinkedList<T>::InitHead()
+  template<typename T, typename POOL>
+  void CircularDoublyLinkedList<T, POOL>::InitHead()
   {
     m_pNodes[0].pNext = &m_pNodes[0];
     m_pNodes[0].pPrev = &m_pNodes[0];
   }
 
-  template<typename T>
-  typename CircularDoublyLinkedList<T>::Node *
-    CircularDoublyLinkedList<T>::Remove(Node * a_pNode)
+  template<typename T, typename POOL>
+  typename CircularDoublyLinkedList<T, POOL>::Node *
+    CircularDoublyLinkedList<T, POOL>::Remove(Node * a_pNode)
   {
     Node * pNext(a_pNode->pNext);
 
@@ -0,0 +1,526 @@
+//@group Misc
+
+//! @file DgConcurrentIDManager.h
+//!
+//! Class declaration: ConcurrentIDManager
+
+#ifndef DGCONCURRENTIDMANAGER_H
+#define DGCONCURRENTIDMANAGER_H
+
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+
+#include "DgBit.h"
+#include "DgDynamicArray.h"
+
+namespace Dg
+{
+  //! @ingroup DgUtility
+  //!
+  //! @class ConcurrentIDManager
+  //!
+  //! Serves unique IDs to many threads. Each thread owns a LocalCache which takes
+  //! blocks of IDs from the manager and serves them without any synchronisation.
+  //! Fresh blocks are carved from the ID range with a single compare-and-swap.
+  //! IDs returned to a cache are kept locally; once a cache holds more than two
+  //! blocks, one block is handed back to the manager, where it is served to the
+  //! next cache which runs dry. Handed back blocks are kept in batches on a
+  //! lock-free stack, so no thread ever waits on another.
+  //!
+  //! A range holding more than SIZE_MAX IDs is cut short to SIZE_MAX IDs.
+  //! IDs returned from outside the range are ignored.
+  template<typename T>
+  class ConcurrentIDManager
+  {
+    ConcurrentIDManager(ConcurrentIDManager const &) = delete;
+    ConcurrentIDManager & operator=(ConcurrentIDManager const &) = delete;
+
+  public:
+
+    //! Per-thread front end to the manager. A cache must only be used by one
+    //! thread at a time, and must not outlive the manager. IDs held by the cache
+    //! are returned to the manager on destruction.
+    class LocalCache
+    {
+      LocalCache(LocalCache const &) = delete;
+      LocalCache & operator=(LocalCache const &) = delete;
+
+    public:
+
+      LocalCache(ConcurrentIDManager<T> &);
+      ~LocalCache();
+
+      //! Get the next available ID.
+      //!
+      //! @return 0 if no more IDs are available.
+      T GetID();
+
+      //! Mark an ID as available. The ID must have been served by this manager.
+      void ReturnID(T);
+
+      //! Hand all IDs held by this cache back to the manager.
+      void Flush();
+
+    private:
+
+      ConcurrentIDManager<T> &  m_rManager;
+      DynamicArray<T>           m_ids;
+    };
+
+  public:
+
+    //! Construct the manager with a lower and upper limit to the ID pool.
+    //! IDs are moved between threads blockSize at a time.
+    ConcurrentIDManager(T lower, T upper, size_t blockSize = 64);
+    ~ConcurrentIDManager();
+
+    //! Get an ID without a cache. This always touches shared state.
+    //!
+    //! @return 0 if no more IDs are available.
+    T GetID();
+
+    //! Return an ID without a cache. This always touches shared state.
+    void ReturnID(T);
+
+    size_t GetBlockSize() const;
+
+  private:
+
+    typedef typename std::make_unsigned<T>::type UnsignedT;
+
+    //! Up to m_blockSize returned IDs. Batches are referred to by handle, their
+    //! index + 1, so that 0 can mean none. A batch is never freed before the
+    //! manager, so a thread which loses a race may still read it safely.
+    struct Batch
+    {
+      std::atomic<uint32_t> next;   // Handle of the batch below this one in its stack
+      size_t                count;
+      T *                   pIDs;
+    };
+
+    //! Chunk c holds the 2^c batches with handles [2^c, 2^(c+1)).
+    static uint32_t const s_maxChunks = 32;
+
+    bool IsInRange(T) const;
+
+    Batch & GetBatch(uint32_t handle);
+
+    //! Pops a batch off the free stack, or makes a new one.
+    uint32_t NewBatch();
+
+    //! Treiber stack operations. A stack head holds the top handle in its low
+    //! 32 bits and a tag, bumped on every change, in its high 32 bits, so a
+    //! compare-and-swap made on a stale view of the stack fails (ABA).
+    void Push(std::atomic<uint64_t> & head, uint32_t handle);
+    uint32_t Pop(std::atomic<uint64_t> & head);
+
+    //! Appends up to m_blockSize IDs to the output.
+    //! @return Number of IDs added.
+    size_t FetchBlock(DynamicArray<T> &);
+
+    //! Moves count IDs from the back of the input to the returned pool.
+    void StoreBlock(DynamicArray<T> &, size_t count);
+
+    //! Reserves up to count fresh IDs.
+    //! @return Number of IDs reserved, starting at the first ID.
+    size_t ReserveFresh(size_t count, T & first);
+
+  private:
+
+    T                     m_lower;
+    T                     m_upper;
+    size_t                m_count;
+    size_t                m_blockSize;
+    std::atomic<size_t>   m_nextOffset;
+    std::atomic<uint64_t> m_fullBatches;
+    std::atomic<uint64_t> m_freeBatches;
+    std::atomic<uint32_t> m_batchCount;
+    std::atomic<Batch *>  m_chunks[s_maxChunks];
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::LocalCache::LocalCache()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  ConcurrentIDManager<T>::LocalCache::LocalCache(ConcurrentIDManager<T> & a_manager)
+    : m_rManager(a_manager)
+    , m_ids(2 * a_manager.GetBlockSize() + 1)
+  {
+
+  } //End: ConcurrentIDManager::LocalCache::LocalCache()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::LocalCache::~LocalCache()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  ConcurrentIDManager<T>::LocalCache::~LocalCache()
+  {
+    Flush();
+  } //End: ConcurrentIDManager::LocalCache::~LocalCache()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::LocalCache::GetID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  T ConcurrentIDManager<T>::LocalCache::GetID()
+  {
+    if (m_ids.size() == 0 && m_rManager.FetchBlock(m_ids) == 0)
+    {
+      return static_cast<T>(0);
+    }
+
+    T result = m_ids.back();
+    m_ids.pop_back();
+    return result;
+  } //End: ConcurrentIDManager::LocalCache::GetID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::LocalCache::ReturnID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void ConcurrentIDManager<T>::LocalCache::ReturnID(T a_id)
+  {
+    if (!m_rManager.IsInRange(a_id))
+    {
+      return;
+    }
+
+    m_ids.push_back(a_id);
+    if (m_ids.size() > 2 * m_rManager.m_blockSize)
+    {
+      m_rManager.StoreBlock(m_ids, m_rManager.m_blockSize);
+    }
+  } //End: ConcurrentIDManager::LocalCache::ReturnID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::LocalCache::Flush()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void ConcurrentIDManager<T>::LocalCache::Flush()
+  {
+    if (m_ids.size() != 0)
+    {
+      m_rManager.StoreBlock(m_ids, m_ids.size());
+    }
+  } //End: ConcurrentIDManager::LocalCache::Flush()
+
+
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::ConcurrentIDManager()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  ConcurrentIDManager<T>::ConcurrentIDManager(T a_lower, T a_upper, size_t a_blockSize)
+    : m_lower(a_lower)
+    , m_upper(a_upper)
+    , m_count(0)
+    , m_blockSize(a_blockSize == 0 ? 1 : a_blockSize)
+    , m_nextOffset(0)
+    , m_fullBatches(0)
+    , m_freeBatches(0)
+    , m_batchCount(0)
+  {
+    if (m_upper < m_lower) m_upper = m_lower;
+
+    //The full range of a 64-bit T holds one ID more than a size_t can count.
+    UnsignedT span = static_cast<UnsignedT>(m_upper) - static_cast<UnsignedT>(m_lower);
+    if (static_cast<uintmax_t>(span) >= static_cast<uintmax_t>(SIZE_MAX))
+    {
+      m_count = SIZE_MAX;
+      m_upper = static_cast<T>(static_cast<UnsignedT>(m_lower) + static_cast<UnsignedT>(SIZE_MAX - 1));
+    }
+    else
+    {
+      m_count = static_cast<size_t>(span) + 1;
+    }
+
+    for (uint32_t i = 0; i < s_maxChunks; i++)
+    {
+      m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+  } //End: ConcurrentIDManager::ConcurrentIDManager()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::~ConcurrentIDManager()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  ConcurrentIDManager<T>::~ConcurrentIDManager()
+  {
+    for (uint32_t i = 0; i < s_maxChunks; i++)
+    {
+      Batch * pChunk = m_chunks[i].load(std::memory_order_relaxed);
+      if (pChunk != nullptr)
+      {
+        //Batch 0 of a chunk points at the start of the chunk's ID storage.
+        delete[] pChunk[0].pIDs;
+        delete[] pChunk;
+      }
+    }
+  } //End: ConcurrentIDManager::~ConcurrentIDManager()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::GetBlockSize()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t ConcurrentIDManager<T>::GetBlockSize() const
+  {
+    return m_blockSize;
+  } //End: ConcurrentIDManager::GetBlockSize()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::GetID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  T ConcurrentIDManager<T>::GetID()
+  {
+    T result;
+    if (ReserveFresh(1, result) == 1)
+    {
+      return result;
+    }
+
+    uint32_t handle = Pop(m_fullBatches);
+    if (handle == 0)
+    {
+      return static_cast<T>(0);
+    }
+
+    Batch & batch = GetBatch(handle);
+    batch.count--;
+    result = batch.pIDs[batch.count];
+    Push(batch.count == 0 ? m_freeBatches : m_fullBatches, handle);
+    return result;
+  } //End: ConcurrentIDManager::GetID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::ReturnID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void ConcurrentIDManager<T>::ReturnID(T a_id)
+  {
+    if (!IsInRange(a_id))
+    {
+      return;
+    }
+
+    //Top up the batch on top of the stack if it has room.
+    uint32_t handle = Pop(m_fullBatches);
+    if (handle != 0)
+    {
+      Batch & batch = GetBatch(handle);
+      if (batch.count < m_blockSize)
+      {
+        batch.pIDs[batch.count] = a_id;
+        batch.count++;
+        Push(m_fullBatches, handle);
+        return;
+      }
+      Push(m_fullBatches, handle);
+    }
+
+    handle = NewBatch();
+    Batch & batch = GetBatch(handle);
+    batch.pIDs[0] = a_id;
+    batch.count = 1;
+    Push(m_fullBatches, handle);
+  } //End: ConcurrentIDManager::ReturnID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::IsInRange()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool ConcurrentIDManager<T>::IsInRange(T a_id) const
+  {
+    return !(a_id < m_lower) && !(m_upper < a_id);
+  } //End: ConcurrentIDManager::IsInRange()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::GetBatch()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  typename ConcurrentIDManager<T>::Batch & ConcurrentIDManager<T>::GetBatch(uint32_t a_handle)
+  {
+    uint32_t chunk = HighestBit(a_handle) - 1;
+    Batch * pChunk = m_chunks[chunk].load(std::memory_order_acquire);
+    return pChunk[a_handle - (uint32_t(1) << chunk)];
+  } //End: ConcurrentIDManager::GetBatch()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::NewBatch()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  uint32_t ConcurrentIDManager<T>::NewBatch()
+  {
+    uint32_t handle = Pop(m_freeBatches);
+    if (handle != 0)
+    {
+      return handle;
+    }
+
+    handle = m_batchCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint32_t chunk = HighestBit(handle) - 1;
+    if (m_chunks[chunk].load(std::memory_order_acquire) == nullptr)
+    {
+      size_t nBatches = size_t(1) << chunk;
+      Batch * pChunk = new Batch[nBatches];
+      T * pIDs = new T[nBatches * m_blockSize];
+      for (size_t i = 0; i < nBatches; i++)
+      {
+        pChunk[i].next.store(0, std::memory_order_relaxed);
+        pChunk[i].count = 0;
+        pChunk[i].pIDs = pIDs + i * m_blockSize;
+      }
+
+      //Another thread may have made this chunk in the meantime.
+      Batch * pExpected = nullptr;
+      if (!m_chunks[chunk].compare_exchange_strong(pExpected, pChunk, std::memory_order_acq_rel))
+      {
+        delete[] pIDs;
+        delete[] pChunk;
+      }
+    }
+    return handle;
+  } //End: ConcurrentIDManager::NewBatch()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::Push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void ConcurrentIDManager<T>::Push(std::atomic<uint64_t> & a_head, uint32_t a_handle)
+  {
+    Batch & batch = GetBatch(a_handle);
+    uint64_t head = a_head.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do
+    {
+      batch.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+      newHead = ((head >> 32) + 1) << 32 | a_handle;
+    } while (!a_head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+  } //End: ConcurrentIDManager::Push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::Pop()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  uint32_t ConcurrentIDManager<T>::Pop(std::atomic<uint64_t> & a_head)
+  {
+    uint64_t head = a_head.load(std::memory_order_acquire);
+    uint32_t handle;
+    uint64_t newHead;
+    do
+    {
+      handle = static_cast<uint32_t>(head);
+      if (handle == 0)
+      {
+        return 0;
+      }
+
+      //The batch may be popped and reused by another thread before we read
+      //this; the tag then makes the compare-and-swap below fail.
+      uint32_t next = GetBatch(handle).next.load(std::memory_order_relaxed);
+      newHead = ((head >> 32) + 1) << 32 | next;
+    } while (!a_head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire));
+    return handle;
+  } //End: ConcurrentIDManager::Pop()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::ReserveFresh()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t ConcurrentIDManager<T>::ReserveFresh(size_t a_count, T & a_first)
+  {
+    size_t offset = m_nextOffset.load(std::memory_order_relaxed);
+    size_t n = 0;
+    do
+    {
+      if (offset >= m_count)
+      {
+        return 0;
+      }
+
+      n = m_count - offset;
+      if (n > a_count) n = a_count;
+    } while (!m_nextOffset.compare_exchange_weak(offset, offset + n, std::memory_order_relaxed));
+
+    a_first = static_cast<T>(static_cast<UnsignedT>(m_lower) + static_cast<UnsignedT>(offset));
+    return n;
+  } //End: ConcurrentIDManager::ReserveFresh()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::FetchBlock()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t ConcurrentIDManager<T>::FetchBlock(DynamicArray<T> & a_out)
+  {
+    //Prefer recycled IDs so the fresh range lasts as long as possible.
+    uint32_t handle = Pop(m_fullBatches);
+    if (handle != 0)
+    {
+      Batch & batch = GetBatch(handle);
+      size_t n = batch.count;
+      for (size_t i = 0; i < n; i++)
+      {
+        a_out.push_back(batch.pIDs[i]);
+      }
+      batch.count = 0;
+      Push(m_freeBatches, handle);
+      if (n != 0)
+      {
+        return n;
+      }
+    }
+
+    T first;
+    size_t n = ReserveFresh(m_blockSize, first);
+
+    //Push in reverse so the cache serves IDs in ascending order.
+    for (size_t i = n; i > 0; i--)
+    {
+      a_out.push_back(static_cast<T>(static_cast<UnsignedT>(first) + static_cast<UnsignedT>(i - 1)));
+    }
+    return n;
+  } //End: ConcurrentIDManager::FetchBlock()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ ConcurrentIDManager::StoreBlock()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void ConcurrentIDManager<T>::StoreBlock(DynamicArray<T> & a_in, size_t a_count)
+  {
+    while (a_count != 0)
+    {
+      uint32_t handle = NewBatch();
+      Batch & batch = GetBatch(handle);
+      size_t n = a_count < m_blockSize ? a_count : m_blockSize;
+      for (size_t i = 0; i < n; i++)
+      {
+        batch.pIDs[i] = a_in.back();
+        a_in.pop_back();
+      }
+      batch.count = n;
+      Push(m_fullBatches, handle);
+      a_count -= n;
+    }
+  } //End: ConcurrentIDManager::StoreBlock()
+}
+
+#endif
@@ -0,0 +1,635 @@
+//@group Collections
+
+//! @file DgCuckooFilter.h
+//!
+//! Class declaration: CuckooFilter
+
+#ifndef DGCUCKOOFILTER_H
+#define DGCUCKOOFILTER_H
+
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "impl/DgFilterCommon.h"
+#include "DgBinaryReader.h"
+#include "DgBinaryWriter.h"
+#include "DgError.h"
+#include "DgOpenHashMap.h"
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class CuckooFilter
+  //!
+  //! Cuckoo filter. Like a Bloom filter it answers "definitely not present" or
+  //! "possibly present", but keys can also be erased.
+  //!
+  //! Each key is stored as a 16-bit fingerprint in one of two buckets of 4 slots.
+  //! A bucket is 8 bytes, so it is tested for a fingerprint with a few integer
+  //! operations on a single word. The false positive rate is about 8 / 2^16.
+  //!
+  //! Only erase keys which were inserted; erasing anything else may remove the
+  //! fingerprint of a different key. Inserting the same key more than twice per
+  //! bucket pair (8 times) will fill its buckets.
+  //!
+  //! HASHER is the same functor used by OpenHashMap; its result is mixed before
+  //! use, so the identity hasher is fine.
+  template<typename K, class HASHER = impl::OpenHashMap::SimpleHasher<K>>
+  class CuckooFilter
+  {
+  public:
+
+    //! Size the filter to hold at least maxItems keys.
+    CuckooFilter(size_t maxItems = 1024, HASHER const & hasher = HASHER());
+    ~CuckooFilter();
+
+    CuckooFilter(CuckooFilter const &);
+    CuckooFilter & operator=(CuckooFilter const &);
+
+    CuckooFilter(CuckooFilter &&) noexcept;
+    CuckooFilter & operator=(CuckooFilter &&) noexcept;
+
+    //! Returns false if the filter is full and the key could not be added.
+    bool insert(K const &);
+
+    //! Inserts keys in order, stopping if the filter fills.
+    //! @return Number of keys inserted.
+    size_t insert(K const * pKeys, size_t count);
+
+    //! False means the key is not in the filter.
+    bool contains(K const &) const;
+
+    //! Writes one result per key to pOut.
+    //! @return Number of keys which are possibly present.
+    size_t contains(K const * pKeys, size_t count, bool * pOut) const;
+
+    //! Returns false if no matching fingerprint was found.
+    bool erase(K const &);
+
+    void clear();
+
+    size_t size() const;
+    size_t bucket_count() const;
+
+    ErrorCode Write(BinaryWriter &) const;
+
+    //! On failure the filter is left unchanged.
+    ErrorCode Read(BinaryReader &);
+
+  private:
+
+    static size_t const s_slotsPerBucket = 4;
+    static uint32_t const s_maxKicks = 500;
+    static uint32_t const s_magic = 0x46434744; // 'DGCF'
+
+    //! Keys processed per batch in the bulk query.
+    static size_t const s_batchSize = 16;
+
+    struct Victim
+    {
+      bool      used;
+      uint16_t  fingerprint;
+      size_t    index;
+    };
+
+    uint64_t Hash(K const &) const;
+    static uint16_t Fingerprint(uint64_t hash);
+    size_t PrimaryIndex(uint64_t hash) const;
+    size_t AltIndex(size_t index, uint16_t fingerprint) const;
+
+    bool BucketContains(size_t index, uint16_t fingerprint) const;
+    bool BucketInsert(size_t index, uint16_t fingerprint);
+    bool BucketErase(size_t index, uint16_t fingerprint);
+    bool Query(uint64_t hash) const;
+    uint32_t NextRandom();
+
+    void Allocate(size_t nBuckets);
+    bool TryAllocate(size_t nBuckets);  // Returns false, leaving the filter empty, if out of memory
+    void Release();
+
+  private:
+
+    HASHER      m_hasher;
+    uint16_t *  m_pSlots;
+    size_t      m_nBuckets;
+    size_t      m_count;
+    Victim      m_victim;
+    uint32_t    m_rng;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::CuckooFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER>::CuckooFilter(size_t a_maxItems, HASHER const & a_hasher)
+    : m_hasher(a_hasher)
+    , m_pSlots(nullptr)
+    , m_nBuckets(0)
+    , m_count(0)
+    , m_victim{false, 0, 0}
+    , m_rng(0x9E3779B9)
+  {
+    //Cuckoo hashing with 4-slot buckets reliably reaches about 95% occupancy.
+    size_t needed = (a_maxItems + a_maxItems / 19) / s_slotsPerBucket + 1;
+    size_t nBuckets = 2;
+    while (nBuckets < needed)
+      nBuckets <<= 1;
+
+    Allocate(nBuckets);
+  } //End: CuckooFilter::CuckooFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::~CuckooFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER>::~CuckooFilter()
+  {
+    Release();
+  } //End: CuckooFilter::~CuckooFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::CuckooFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER>::CuckooFilter(CuckooFilter const & a_other)
+    : m_hasher(a_other.m_hasher)
+    , m_pSlots(nullptr)
+    , m_nBuckets(0)
+    , m_count(a_other.m_count)
+    , m_victim(a_other.m_victim)
+    , m_rng(a_other.m_rng)
+  {
+    Allocate(a_other.m_nBuckets);
+    memcpy(m_pSlots, a_other.m_pSlots, m_nBuckets * s_slotsPerBucket * sizeof(uint16_t));
+  } //End: CuckooFilter::CuckooFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER> & CuckooFilter<K, HASHER>::operator=(CuckooFilter const & a_other)
+  {
+    if (this != &a_other)
+    {
+      if (m_nBuckets != a_other.m_nBuckets)
+      {
+        Release();
+        Allocate(a_other.m_nBuckets);
+      }
+      memcpy(m_pSlots, a_other.m_pSlots, m_nBuckets * s_slotsPerBucket * sizeof(uint16_t));
+      m_hasher = a_other.m_hasher;
+      m_count = a_other.m_count;
+      m_victim = a_other.m_victim;
+      m_rng = a_other.m_rng;
+    }
+    return *this;
+  } //End: CuckooFilter::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::CuckooFilter()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER>::CuckooFilter(CuckooFilter && a_other) noexcept
+    : m_hasher(a_other.m_hasher)
+    , m_pSlots(a_other.m_pSlots)
+    , m_nBuckets(a_other.m_nBuckets)
+    , m_count(a_other.m_count)
+    , m_victim(a_other.m_victim)
+    , m_rng(a_other.m_rng)
+  {
+    a_other.m_pSlots = nullptr;
+    a_other.m_nBuckets = 0;
+    a_other.m_count = 0;
+    a_other.m_victim.used = false;
+  } //End: CuckooFilter::CuckooFilter()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  CuckooFilter<K, HASHER> & CuckooFilter<K, HASHER>::operator=(CuckooFilter && a_other) noexcept
+  {
+    if (this != &a_other)
+    {
+      Release();
+      m_hasher = a_other.m_hasher;
+      m_pSlots = a_other.m_pSlots;
+      m_nBuckets = a_other.m_nBuckets;
+      m_count = a_other.m_count;
+      m_victim = a_other.m_victim;
+      m_rng = a_other.m_rng;
+
+      a_other.m_pSlots = nullptr;
+      a_other.m_nBuckets = 0;
+      a_other.m_count = 0;
+      a_other.m_victim.used = false;
+    }
+    return *this;
+  } //End: CuckooFilter::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Allocate()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void CuckooFilter<K, HASHER>::Allocate(size_t a_nBuckets)
+  {
+    if (!TryAllocate(a_nBuckets))
+      throw std::bad_alloc();
+  } //End: CuckooFilter::Allocate()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::TryAllocate()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::TryAllocate(size_t a_nBuckets)
+  {
+    m_pSlots = static_cast<uint16_t *>(calloc(a_nBuckets * s_slotsPerBucket, sizeof(uint16_t)));
+    if (m_pSlots == nullptr)
+      return false;
+    m_nBuckets = a_nBuckets;
+    return true;
+  } //End: CuckooFilter::TryAllocate()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Release()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void CuckooFilter<K, HASHER>::Release()
+  {
+    free(m_pSlots);
+    m_pSlots = nullptr;
+    m_nBuckets = 0;
+  } //End: CuckooFilter::Release()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::clear()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  void CuckooFilter<K, HASHER>::clear()
+  {
+    memset(m_pSlots, 0, m_nBuckets * s_slotsPerBucket * sizeof(uint16_t));
+    m_count = 0;
+    m_victim.used = false;
+  } //End: CuckooFilter::clear()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::size()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::size() const
+  {
+    return m_count;
+  } //End: CuckooFilter::size()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::bucket_count()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::bucket_count() const
+  {
+    return m_nBuckets;
+  } //End: CuckooFilter::bucket_count()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Hash()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  uint64_t CuckooFilter<K, HASHER>::Hash(K const & a_key) const
+  {
+    return impl::Filter::Mix64(static_cast<uint64_t>(m_hasher(a_key)));
+  } //End: CuckooFilter::Hash()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Fingerprint()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  uint16_t CuckooFilter<K, HASHER>::Fingerprint(uint64_t a_hash)
+  {
+    //Zero marks an empty slot.
+    uint16_t fp = static_cast<uint16_t>(a_hash);
+    return fp == 0 ? 1 : fp;
+  } //End: CuckooFilter::Fingerprint()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::PrimaryIndex()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::PrimaryIndex(uint64_t a_hash) const
+  {
+    return static_cast<size_t>(a_hash >> 32) & (m_nBuckets - 1);
+  } //End: CuckooFilter::PrimaryIndex()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::AltIndex()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::AltIndex(size_t a_index, uint16_t a_fingerprint) const
+  {
+    //Depends only on the fingerprint, so either bucket can find the other.
+    return (a_index ^ static_cast<size_t>(impl::Filter::Mix64(a_fingerprint))) & (m_nBuckets - 1);
+  } //End: CuckooFilter::AltIndex()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::BucketContains()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::BucketContains(size_t a_index, uint16_t a_fingerprint) const
+  {
+    //Test all four 16-bit slots at once: xor with the broadcast fingerprint,
+    //then look for a zero lane.
+    uint64_t const lo = 0x0001000100010001ull;
+    uint64_t const hi = 0x8000800080008000ull;
+
+    uint64_t bucket;
+    memcpy(&bucket, &m_pSlots[a_index * s_slotsPerBucket], sizeof(bucket));
+    uint64_t x = bucket ^ (lo * a_fingerprint);
+    return ((x - lo) & ~x & hi) != 0;
+  } //End: CuckooFilter::BucketContains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::BucketInsert()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::BucketInsert(size_t a_index, uint16_t a_fingerprint)
+  {
+    uint16_t * pBucket = &m_pSlots[a_index * s_slotsPerBucket];
+    for (size_t i = 0; i < s_slotsPerBucket; i++)
+    {
+      if (pBucket[i] == 0)
+      {
+        pBucket[i] = a_fingerprint;
+        return true;
+      }
+    }
+    return false;
+  } //End: CuckooFilter::BucketInsert()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::BucketErase()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::BucketErase(size_t a_index, uint16_t a_fingerprint)
+  {
+    uint16_t * pBucket = &m_pSlots[a_index * s_slotsPerBucket];
+    for (size_t i = 0; i < s_slotsPerBucket; i++)
+    {
+      if (pBucket[i] == a_fingerprint)
+      {
+        pBucket[i] = 0;
+        return true;
+      }
+    }
+    return false;
+  } //End: CuckooFilter::BucketErase()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::NextRandom()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  uint32_t CuckooFilter<K, HASHER>::NextRandom()
+  {
+    //xorshift32; only used to pick which fingerprint to evict.
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 17;
+    m_rng ^= m_rng << 5;
+    return m_rng;
+  } //End: CuckooFilter::NextRandom()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::insert()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::insert(K const & a_key)
+  {
+    //A pending victim means the last insert could not settle; the filter is full.
+    if (m_victim.used)
+      return false;
+
+    uint64_t hash = Hash(a_key);
+    uint16_t fp = Fingerprint(hash);
+    size_t i1 = PrimaryIndex(hash);
+    size_t i2 = AltIndex(i1, fp);
+
+    m_count++;
+    if (BucketInsert(i1, fp) || BucketInsert(i2, fp))
+      return true;
+
+    size_t index = (NextRandom() & 1) ? i1 : i2;
+    for (uint32_t kick = 0; kick < s_maxKicks; kick++)
+    {
+      uint16_t & slot = m_pSlots[index * s_slotsPerBucket + (NextRandom() & (s_slotsPerBucket - 1))];
+      uint16_t evicted = slot;
+      slot = fp;
+      fp = evicted;
+
+      index = AltIndex(index, fp);
+      if (BucketInsert(index, fp))
+        return true;
+    }
+
+    //The key is stored; the last fingerprint evicted waits here until space frees.
+    m_victim.used = true;
+    m_victim.fingerprint = fp;
+    m_victim.index = index;
+    return true;
+  } //End: CuckooFilter::insert()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::insert()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::insert(K const * a_pKeys, size_t a_count)
+  {
+    size_t n = 0;
+    while (n < a_count && insert(a_pKeys[n]))
+      n++;
+    return n;
+  } //End: CuckooFilter::insert()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Query()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::Query(uint64_t a_hash) const
+  {
+    uint16_t fp = Fingerprint(a_hash);
+    size_t i1 = PrimaryIndex(a_hash);
+    size_t i2 = AltIndex(i1, fp);
+
+    if (m_victim.used && m_victim.fingerprint == fp && (m_victim.index == i1 || m_victim.index == i2))
+      return true;
+
+    return BucketContains(i1, fp) || BucketContains(i2, fp);
+  } //End: CuckooFilter::Query()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::contains()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::contains(K const & a_key) const
+  {
+    return Query(Hash(a_key));
+  } //End: CuckooFilter::contains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::contains()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  size_t CuckooFilter<K, HASHER>::contains(K const * a_pKeys, size_t a_count, bool * a_pOut) const
+  {
+    uint64_t hashes[s_batchSize];
+    size_t nFound = 0;
+
+    for (size_t base = 0; base < a_count; base += s_batchSize)
+    {
+      size_t n = a_count - base;
+      if (n > s_batchSize)
+        n = s_batchSize;
+
+      for (size_t i = 0; i < n; i++)
+        hashes[i] = Hash(a_pKeys[base + i]);
+
+      for (size_t i = 0; i < n; i++)
+      {
+        bool found = Query(hashes[i]);
+        a_pOut[base + i] = found;
+        nFound += found ? 1 : 0;
+      }
+    }
+    return nFound;
+  } //End: CuckooFilter::contains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::erase()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  bool CuckooFilter<K, HASHER>::erase(K const & a_key)
+  {
+    uint64_t hash = Hash(a_key);
+    uint16_t fp = Fingerprint(hash);
+    size_t i1 = PrimaryIndex(hash);
+    size_t i2 = AltIndex(i1, fp);
+
+    if (BucketErase(i1, fp) || BucketErase(i2, fp))
+    {
+      m_count--;
+
+      //There is room now, so try to settle the victim.
+      if (m_victim.used)
+      {
+        size_t alt = AltIndex(m_victim.index, m_victim.fingerprint);
+        if (BucketInsert(m_victim.index, m_victim.fingerprint) || BucketInsert(alt, m_victim.fingerprint))
+          m_victim.used = false;
+      }
+      return true;
+    }
+
+    if (m_victim.used && m_victim.fingerprint == fp && (m_victim.index == i1 || m_victim.index == i2))
+    {
+      m_victim.used = false;
+      m_count--;
+      return true;
+    }
+
+    return false;
+  } //End: CuckooFilter::erase()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Write()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  ErrorCode CuckooFilter<K, HASHER>::Write(BinaryWriter & a_writer) const
+  {
+    ErrorCode result;
+    uint32_t header[3] = {s_magic, impl::Filter::s_version, m_victim.used ? 1u : 0u};
+    uint64_t sizes[3] = {static_cast<uint64_t>(m_nBuckets), static_cast<uint64_t>(m_count), static_cast<uint64_t>(m_victim.index)};
+    uint16_t victimFp = m_victim.fingerprint;
+    IO::myInt nSlots = static_cast<IO::myInt>(m_nBuckets * s_slotsPerBucket);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint32_t>(header, 3), 3, ErrorCode::WriteError));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint64_t>(sizes, 3), 3, ErrorCode::WriteError));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint16_t>(&victimFp), 1, ErrorCode::WriteError));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_writer.Write<uint16_t>(m_pSlots, nSlots), nSlots, ErrorCode::WriteError));
+
+    result = ErrorCode::None;
+  epilogue:
+    return result;
+  } //End: CuckooFilter::Write()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ CuckooFilter::Read()
+  //-------------------------------------------------------------------------------
+  template<typename K, class HASHER>
+  ErrorCode CuckooFilter<K, HASHER>::Read(BinaryReader & a_reader)
+  {
+    ErrorCode result;
+    uint32_t header[3] = {};
+    uint64_t sizes[3] = {};
+    uint16_t victimFp = 0;
+    IO::myInt nSlots = 0;
+    CuckooFilter temp(0, m_hasher);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint32_t>(header, 3), 3, ErrorCode::IncorrectFileType));
+    DG_ERROR_IF(header[0] != s_magic || header[1] != impl::Filter::s_version, ErrorCode::IncorrectFileType);
+
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint64_t>(sizes, 3), 3, ErrorCode::IncorrectFileType));
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint16_t>(&victimFp), 1, ErrorCode::IncorrectFileType));
+
+    //Bucket count must be a power of two, at least 2.
+    DG_ERROR_IF(sizes[0] < 2 || (sizes[0] & (sizes[0] - 1)) != 0, ErrorCode::InvalidInput);
+    DG_ERROR_IF(sizes[0] > SIZE_MAX / (s_slotsPerBucket * sizeof(uint16_t)), ErrorCode::InvalidInput);
+    DG_ERROR_IF(sizes[1] > sizes[0] * s_slotsPerBucket + 1, ErrorCode::InvalidInput);
+    DG_ERROR_IF(header[2] != 0 && (sizes[2] >= sizes[0] || victimFp == 0), ErrorCode::InvalidInput);
+
+    //A corrupt count must not trigger a huge allocation before the short read is found.
+    DG_ERROR_IF(sizes[0] > impl::Filter::RemainingBytes(a_reader) / (s_slotsPerBucket * sizeof(uint16_t)), ErrorCode::IncorrectFileType);
+
+    temp.Release();
+    DG_ERROR_IF(!temp.TryAllocate(static_cast<size_t>(sizes[0])), ErrorCode::FailedToAllocMem);
+    temp.m_count = static_cast<size_t>(sizes[1]);
+    temp.m_victim.used = header[2] != 0;
+    temp.m_victim.index = static_cast<size_t>(sizes[2]);
+    temp.m_victim.fingerprint = victimFp;
+
+    nSlots = static_cast<IO::myInt>(temp.m_nBuckets * s_slotsPerBucket);
+    DG_ERROR_CHECK(impl::Filter::CheckIO(a_reader.Read<uint16_t>(temp.m_pSlots, nSlots), nSlots, ErrorCode::IncorrectFileType));
+
+    *this = std::move(temp);
+    result = ErrorCode::None;
+  epilogue:
+    return result;
+  } //End: CuckooFilter::Read()
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include <exception>
 
 #include "impl/DgPoolSizeManager.h"
+#include "impl/DgContainerStats.h"
 
 namespace Dg
 {
@@ -32,7 +33,7 @@ namespace Dg
   //!
   //! @author Frank B. Hart
   //! @date 25/08/2016
-  template<typename T>
+  template<typename T, typename POOL = PoolSizeMngr_Default>
   class DoublyLinkedList
   {
   private:
@@ -247,6 +248,13 @@ namespace Dg
     //Used to determin if the memory block allocation has changed when reallocating
     void const * data();
 
+    //! Reduce the reserve to the smallest pool size which holds the current elements.
+    //! Invalidates iterators.
+    void shrink_to_fit();
+
+    //! Memory and occupancy snapshot.
+    ContainerStats GetStats() const;
+
   private:
 
     template<class Compare>
@@ -254,6 +262,10 @@ namespace Dg
 
     // Increases the size of the underlying memory block
     void Extend();
+
+    // Moves the nodes to a block of the new size and fixes up the links.
+    // Assumes the new size holds all current nodes.
+    void Reallocate(POOL const &);
     void Move(Node * a_pDest, Node * a_pSrc);
     Node * InsertNewAfter(Node * a_pNode, T const & a_data);
     void DestructAll();
@@ -268,7 +280,7 @@ namespace Dg
 
   private:
 
-    PoolSizeMngr_Default m_poolSize;
+    POOL m_poolSize;
 	  Node *          m_pNodes;      //Pre-allocated block of memory to hold items
 	  size_t          m_nItems;     //Number of items currently in the DoublyLinkedList
   };
@@ -276,56 +288,56 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		const_iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  DoublyLinkedList<T>::const_iterator::const_iterator(Node const * a_pNode)
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::const_iterator::const_iterator(Node const * a_pNode)
   : m_pNode(a_pNode)
   {
 
   }
   
-  template<typename T>
-  DoublyLinkedList<T>::const_iterator::const_iterator()
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::const_iterator::const_iterator()
     : m_pNode(nullptr) 
   {
 
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::const_iterator::~const_iterator()
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::const_iterator::const_iterator(const_iterator const & a_it)
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::const_iterator::const_iterator(const_iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator &
-    DoublyLinkedList<T>::const_iterator::operator=(const_iterator const & a_other)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator &
+    DoublyLinkedList<T, POOL>::const_iterator::operator=(const_iterator const & a_other)
   {
     m_pNode = a_other.m_pNode;
     return *this;
   }
 
-  template<typename T>
-  bool DoublyLinkedList<T>::const_iterator::operator==(const_iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool DoublyLinkedList<T, POOL>::const_iterator::operator==(const_iterator const & a_it) const 
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename T>
-  bool DoublyLinkedList<T>::const_iterator::operator!=(const_iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool DoublyLinkedList<T, POOL>::const_iterator::operator!=(const_iterator const & a_it) const 
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator
-    DoublyLinkedList<T>::const_iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator
+    DoublyLinkedList<T, POOL>::const_iterator::operator+(size_t a_val) const
   {
     Node const * pNode = m_pNode;
 
@@ -335,9 +347,9 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator
-    DoublyLinkedList<T>::const_iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator
+    DoublyLinkedList<T, POOL>::const_iterator::operator-(size_t a_val) const
   {
     Node const * pNode = m_pNode;
 
@@ -347,9 +359,9 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator &
-    DoublyLinkedList<T>::const_iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator &
+    DoublyLinkedList<T, POOL>::const_iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->pNext;
@@ -357,9 +369,9 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator &
-    DoublyLinkedList<T>::const_iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator &
+    DoublyLinkedList<T, POOL>::const_iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->pPrev;
@@ -367,50 +379,50 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator &
-    DoublyLinkedList<T>::const_iterator::operator++()
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator &
+    DoublyLinkedList<T, POOL>::const_iterator::operator++()
   {
     m_pNode = m_pNode->pNext;
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator
-    DoublyLinkedList<T>::const_iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator
+    DoublyLinkedList<T, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator &
-    DoublyLinkedList<T>::const_iterator::operator--()
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator &
+    DoublyLinkedList<T, POOL>::const_iterator::operator--()
   {
     m_pNode = m_pNode->pPrev;
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::const_iterator
-    DoublyLinkedList<T>::const_iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::const_iterator
+    DoublyLinkedList<T, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T const *
-    DoublyLinkedList<T>::const_iterator::operator->() const 
+    DoublyLinkedList<T, POOL>::const_iterator::operator->() const 
   {
     return &(m_pNode->data);
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T const &
-    DoublyLinkedList<T>::const_iterator::operator*() const 
+    DoublyLinkedList<T, POOL>::const_iterator::operator*() const 
   {
     return m_pNode->data;
   }
@@ -418,56 +430,56 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  DoublyLinkedList<T>::iterator::iterator(Node * a_pNode)
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::iterator::iterator(Node * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::iterator::iterator()
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::iterator::iterator()
     : m_pNode(nullptr) 
   {
 
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::iterator::~iterator()
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::iterator::iterator(iterator const & a_it)
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::iterator::iterator(iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator &
-    DoublyLinkedList<T>::iterator::operator=(iterator const & a_other)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator &
+    DoublyLinkedList<T, POOL>::iterator::operator=(iterator const & a_other)
   {
     m_pNode = a_other.m_pNode;
     return *this;
   }
 
-  template<typename T>
-  bool DoublyLinkedList<T>::iterator::operator==(iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool DoublyLinkedList<T, POOL>::iterator::operator==(iterator const & a_it) const 
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename T>
-  bool DoublyLinkedList<T>::iterator::operator!=(iterator const & a_it) const 
+  template<typename T, typename POOL>
+  bool DoublyLinkedList<T, POOL>::iterator::operator!=(iterator const & a_it) const 
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator
-    DoublyLinkedList<T>::iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator
+    DoublyLinkedList<T, POOL>::iterator::operator+(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -477,9 +489,9 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator
-    DoublyLinkedList<T>::iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator
+    DoublyLinkedList<T, POOL>::iterator::operator-(size_t a_val) const
   {
     Node * pNode = m_pNode;
 
@@ -489,9 +501,9 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator &
-    DoublyLinkedList<T>::iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator &
+    DoublyLinkedList<T, POOL>::iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->pNext;
@@ -499,9 +511,9 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator &
-    DoublyLinkedList<T>::iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator &
+    DoublyLinkedList<T, POOL>::iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->pPrev;
@@ -509,57 +521,57 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator &
-    DoublyLinkedList<T>::iterator::operator++()
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator &
+    DoublyLinkedList<T, POOL>::iterator::operator++()
   {
     m_pNode = m_pNode->pNext;
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator
-    DoublyLinkedList<T>::iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator
+    DoublyLinkedList<T, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator &
-    DoublyLinkedList<T>::iterator::operator--()
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator &
+    DoublyLinkedList<T, POOL>::iterator::operator--()
   {
     m_pNode = m_pNode->pPrev;
     return *this;
   }
 
-  template<typename T>
-  typename DoublyLinkedList<T>::iterator
-    DoublyLinkedList<T>::iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename DoublyLinkedList<T, POOL>::iterator
+    DoublyLinkedList<T, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T *
-    DoublyLinkedList<T>::iterator::operator->()
+    DoublyLinkedList<T, POOL>::iterator::operator->()
   {
     return &(m_pNode->data);
   }
 
-  template<typename T>
+  template<typename T, typename POOL>
   T &
-    DoublyLinkedList<T>::iterator::operator*()
+    DoublyLinkedList<T, POOL>::iterator::operator*()
   {
     return m_pNode->data;
   }
 
-  template<typename T>
-  DoublyLinkedList<T>::iterator::operator
-    typename DoublyLinkedList<T>::const_iterator() const
+  template<typename T, typename POOL>
+  DoublyLinkedList<T, POOL>::iterator::operator
+    typename DoublyLinkedList<T, POOL>::const_iterator() const
   {
     return const_iterator(m_pNode);
   }
@@ -567,8 +579,8 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		DoublyLinkedList
   //--------------------------------------------------------------------------------
-  template<typename T>
-   DoublyLinkedList<T>::DoublyLinkedList()
+  template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL>::DoublyLinkedList()
     : m_nItems(0)
     , m_pNodes(nullptr)
   {
@@ -576,8 +588,8 @@ namespace Dg
     InitEndNode();
   }
 
-   template<typename T>
-   DoublyLinkedList<T>::DoublyLinkedList(size_t a_size)
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL>::DoublyLinkedList(size_t a_size)
      : m_nItems(0)
      , m_pNodes(nullptr)
    {
@@ -586,15 +598,15 @@ namespace Dg
      InitEndNode();
    }
 
-   template<typename T>
-   DoublyLinkedList<T>::~DoublyLinkedList()
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL>::~DoublyLinkedList()
    {
      DestructAll();
      free(m_pNodes);
    }
 
-   template<typename T>
-   DoublyLinkedList<T>::DoublyLinkedList(DoublyLinkedList const & a_other)
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL>::DoublyLinkedList(DoublyLinkedList const & a_other)
      : m_poolSize(a_other.m_poolSize)
      , m_nItems(0)
      , m_pNodes(nullptr)
@@ -603,8 +615,8 @@ namespace Dg
      Init(a_other);
    }
 
-   template<typename T>
-   DoublyLinkedList<T> & DoublyLinkedList<T>::operator=(DoublyLinkedList const & a_other)
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL> & DoublyLinkedList<T, POOL>::operator=(DoublyLinkedList const & a_other)
    {
      if (this != &a_other)
      {
@@ -627,8 +639,8 @@ namespace Dg
      return *this;
    }
 
-   template<typename T>
-   DoublyLinkedList<T>::DoublyLinkedList(DoublyLinkedList && a_other) noexcept
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL>::DoublyLinkedList(DoublyLinkedList && a_other) noexcept
      : m_poolSize(a_other.m_poolSize)
      , m_nItems(a_other.m_nItems)
      , m_pNodes(a_other.m_pNodes)
@@ -637,9 +649,9 @@ namespace Dg
      a_other.m_nItems = 0;
    }
 
-   template<typename T>
-   DoublyLinkedList<T> & 
-     DoublyLinkedList<T>::operator=(DoublyLinkedList && a_other) noexcept
+   template<typename T, typename POOL>
+   DoublyLinkedList<T, POOL> & 
+     DoublyLinkedList<T, POOL>::operator=(DoublyLinkedList && a_other) noexcept
    {
      if (this != &a_other)
      {
@@ -653,141 +665,155 @@ namespace Dg
      return *this;
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::iterator 
-     DoublyLinkedList<T>::begin() 
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::iterator 
+     DoublyLinkedList<T, POOL>::begin() 
    {
      return iterator(m_pNodes[0].pNext);
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::iterator
-     DoublyLinkedList<T>::end() 
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::iterator
+     DoublyLinkedList<T, POOL>::end() 
    {
      return iterator(m_pNodes); 
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::const_iterator
-     DoublyLinkedList<T>::cbegin() const 
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::const_iterator
+     DoublyLinkedList<T, POOL>::cbegin() const 
    {
      return const_iterator(m_pNodes[0].pNext);
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::const_iterator
-     DoublyLinkedList<T>::cend() const 
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::const_iterator
+     DoublyLinkedList<T, POOL>::cend() const 
    {
      return const_iterator(m_pNodes); 
    }
 
-   template<typename T>
-   size_t DoublyLinkedList<T>::size() const 
+   template<typename T, typename POOL>
+   size_t DoublyLinkedList<T, POOL>::size() const 
    {
      return m_nItems;
    }
 
-   template<typename T>
-   bool DoublyLinkedList<T>::empty() const 
+   template<typename T, typename POOL>
+   bool DoublyLinkedList<T, POOL>::empty() const 
    {
      return m_nItems == 0;
    }
 
-   template<typename T>
-   T & DoublyLinkedList<T>::back() 
+   template<typename T, typename POOL>
+   T & DoublyLinkedList<T, POOL>::back() 
    { 
      return m_pNodes[0].pPrev->data;
    }
 
-   template<typename T>
-   T & DoublyLinkedList<T>::front() 
+   template<typename T, typename POOL>
+   T & DoublyLinkedList<T, POOL>::front() 
    { 
      return m_pNodes[0].pNext->data;
    }
 
-   template<typename T>
-   T const & DoublyLinkedList<T>::back() const 
+   template<typename T, typename POOL>
+   T const & DoublyLinkedList<T, POOL>::back() const 
    { 
      return m_pNodes[0].pPrev->data;
    }
 
-   template<typename T>
-   T const & DoublyLinkedList<T>::front() const 
+   template<typename T, typename POOL>
+   T const & DoublyLinkedList<T, POOL>::front() const 
    { 
      return m_pNodes[0].pNext->data; 
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::push_back(T const & a_item)
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::push_back(T const & a_item)
    {
      InsertNewAfter(m_pNodes[0].pPrev, a_item);
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::push_front(T const & a_item)
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::push_front(T const & a_item)
    {
      InsertNewAfter(m_pNodes, a_item);
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::iterator
-     DoublyLinkedList<T>::insert(iterator const & a_position, T const & a_item)
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::iterator
+     DoublyLinkedList<T, POOL>::insert(iterator const & a_position, T const & a_item)
    {
      Node * pNode = InsertNewAfter(a_position.m_pNode->pPrev, a_item);
      return iterator(pNode);
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::pop_back()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::pop_back()
    {
      Remove(m_pNodes[0].pPrev);
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::pop_front()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::pop_front()
    {
      Remove(m_pNodes[0].pNext);
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::iterator
-     DoublyLinkedList<T>::erase(iterator const & a_position)
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::iterator
+     DoublyLinkedList<T, POOL>::erase(iterator const & a_position)
    {
      Node * pNode = Remove(a_position.m_pNode);
      return iterator(pNode);
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::clear()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::clear()
    {
      DestructAll();
      m_nItems = 0;
      InitEndNode();
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::resize(size_t a_newSize)
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::resize(size_t a_newSize)
    {
      DestructAll();
      Init(a_newSize);
    }
 
-   template<typename T>
-   void const * DoublyLinkedList<T>::data()
+   template<typename T, typename POOL>
+   void const * DoublyLinkedList<T, POOL>::data()
    {
      return m_pNodes;
    }
 
-   template<typename T>
+   template<typename T, typename POOL>
+   ContainerStats DoublyLinkedList<T, POOL>::GetStats() const
+   {
+     //One node is reserved as the end node.
+     ContainerStats stats;
+     stats.elementCount = m_nItems;
+     stats.capacity = m_poolSize.GetSize() - 1;
+     stats.bytesReserved = m_poolSize.GetSize() * sizeof(Node);
+     stats.bytesUsed = (m_nItems + 1) * sizeof(Node);
+     stats.poolSizeIndex = m_poolSize.GetIndex();
+     stats.poolResizes = m_poolSize.GetResizeCount();
+     return stats;
+   }
+
+   template<typename T, typename POOL>
    template<class Compare>
-   void DoublyLinkedList<T>::sort(Compare a_cmp)
+   void DoublyLinkedList<T, POOL>::sort(Compare a_cmp)
    {
      sort(m_pNodes[0].pNext, m_pNodes, a_cmp);
    }
 
-   template<typename T>
+   template<typename T, typename POOL>
    template<class Compare>
-   void DoublyLinkedList<T>::sort(Node * a_pFirst, Node * a_pLast, Compare & a_cmp)
+   void DoublyLinkedList<T, POOL>::sort(Node * a_pFirst, Node * a_pLast, Compare & a_cmp)
    {
      if (a_pFirst == a_pLast)
        return;
@@ -807,8 +833,8 @@ namespace Dg
      sort(pPrev->pNext, a_pFirst, a_cmp);
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::Move(Node * a_pDest, Node * a_pSrc)
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::Move(Node * a_pDest, Node * a_pSrc)
    {
      //Break the src from the chain
      a_pSrc->pPrev->pNext = a_pSrc->pNext;
@@ -823,21 +849,35 @@ namespace Dg
      a_pDest->pPrev = a_pSrc;
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::Extend()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::Extend()
+   {
+     POOL poolSize(m_poolSize);
+     poolSize.SetNextPoolSize();
+     Reallocate(poolSize);
+   }
+
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::shrink_to_fit()
+   {
+     //Keep room for the end node.
+     POOL poolSize(m_poolSize);
+     poolSize.SetSize(m_nItems + 1);
+     if (poolSize.GetSize() < m_poolSize.GetSize())
+       Reallocate(poolSize);
+   }
+
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::Reallocate(POOL const & a_poolSize)
    {
      Node * pOldNodes(m_pNodes);
-     size_t oldSize = m_poolSize.GetSize();
-     m_poolSize.SetNextPoolSize();
 
-     Node * pNodesTemp = static_cast<Node *>(realloc(m_pNodes, (m_poolSize.GetSize()) * sizeof(Node)));
+     Node * pNodesTemp = static_cast<Node *>(realloc(m_pNodes, (a_poolSize.GetSize()) * sizeof(Node)));
      if (pNodesTemp == nullptr)
-     {
-       m_poolSize.SetSize(oldSize);
        throw std::bad_alloc();
-     }
 
      m_pNodes = pNodesTemp;
+     m_poolSize = a_poolSize;
 
      if (pOldNodes != m_pNodes)
      {
@@ -849,9 +889,9 @@ namespace Dg
      }
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::Node *
-     DoublyLinkedList<T>::InsertNewAfter(Node * a_pNode, T const & a_data)
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::Node *
+     DoublyLinkedList<T, POOL>::InsertNewAfter(Node * a_pNode, T const & a_data)
    {
      if (m_nItems == (m_poolSize.GetSize() - 1))
      {
@@ -873,15 +913,15 @@ namespace Dg
      return newNode;
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::DestructAll()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::DestructAll()
    {
      for (size_t i = 1; i <= m_nItems; i++)
        m_pNodes[i].data.~T();
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::InitMemory()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::InitMemory()
    {
      Node * pTemp = static_cast<Node*> (realloc(m_pNodes, m_poolSize.GetSize() * sizeof(Node)));
      if (pTemp == nullptr)
@@ -889,8 +929,8 @@ namespace Dg
      m_pNodes = pTemp;
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::Init(DoublyLinkedList const & a_other)
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::Init(DoublyLinkedList const & a_other)
    {
      m_nItems = a_other.m_nItems;
 
@@ -913,16 +953,16 @@ namespace Dg
      m_pNodes[m_nItems].pNext = m_pNodes;
    }
 
-   template<typename T>
-   void DoublyLinkedList<T>::InitEndNode()
+   template<typename T, typename POOL>
+   void DoublyLinkedList<T, POOL>::InitEndNode()
    {
      m_pNodes[0].pNext = m_pNodes;
      m_pNodes[0].pPrev = m_pNodes;
    }
 
-   template<typename T>
-   typename DoublyLinkedList<T>::Node *
-     DoublyLinkedList<T>::Remove(Node * a_pNode)
+   template<typename T, typename POOL>
+   typename DoublyLinkedList<T, POOL>::Node *
+     DoublyLinkedList<T, POOL>::Remove(Node * a_pNode)
    {
      Node * pNext(a_pNode->pNext);
 
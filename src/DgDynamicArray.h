@@ -19,10 +19,12 @@
 #include <stdint.h>
 
 #include "impl/DgPoolSizeManager.h"
+#include "impl/DgContainerStats.h"
+#include "impl/DgLargeAlloc.h"
 
 namespace Dg
 {
-  template<typename T>
+  template<typename T, typename POOL = PoolSizeMngr_Default>
   class DynamicArray
   {
   public:
@@ -151,6 +153,17 @@ namespace Dg
     //! Add element to the back of the array.
     void push_back(T const &);
 
+    //! Increase the size by count and return a pointer to the first new element.
+    //! The new elements are NOT constructed, so use for pod types or construct
+    //! them in place before use.
+    T * append_uninitialized(size_t count);
+
+    //! Make sure the array can hold at least count elements without reallocating.
+    void reserve(size_t count);
+
+    //! Reduce the reserve to the smallest pool size which holds the current elements.
+    void shrink_to_fit();
+
     //! Remove element from the back of the array.
     void pop_back();
 
@@ -170,142 +183,148 @@ namespace Dg
     //! Calling this on an empty DynamicArray will no doubt cause a crash.
     void erase_swap(size_t a_ind);
 
+    //! Memory and occupancy snapshot.
+    ContainerStats GetStats() const;
+
   private:
     //! Exteneds the total size of the array (current + reserve) by a factor of 2
     void extend();
     void init(DynamicArray const &);
 
+    //! Move the buffer to a new pool size. Elements are relocated with memcpy.
+    void Reallocate(POOL const &);
+
   private:
     //Data members
     T*              m_pData;
     size_t          m_nItems;
-    PoolSizeMngr_Default m_poolSize;
+    POOL            m_poolSize;
   };
 
   //------------------------------------------------------------------------------------------------
   // const_iterator
   //------------------------------------------------------------------------------------------------
-  template<typename T>
-  DynamicArray<T>::const_iterator::const_iterator(T const* a_pData)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::const_iterator::const_iterator(T const* a_pData)
     : m_pData(a_pData)
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::const_iterator::const_iterator()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::const_iterator::const_iterator()
     : m_pData(nullptr)
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::const_iterator::~const_iterator()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::const_iterator::const_iterator(const_iterator const& a_it)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::const_iterator::const_iterator(const_iterator const& a_it)
     : m_pData(a_it.m_pData)
   {
 
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator&
-    DynamicArray<T>::const_iterator::operator=(const_iterator const& a_it)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator&
+    DynamicArray<T, POOL>::const_iterator::operator=(const_iterator const& a_it)
   {
     m_pData = a_it.m_pData;
     return *this;
   }
 
-  template<typename T>
-  bool DynamicArray<T>::const_iterator::operator==(const_iterator const& a_it) const
+  template<typename T, typename POOL>
+  bool DynamicArray<T, POOL>::const_iterator::operator==(const_iterator const& a_it) const
   {
     return m_pData == a_it.m_pData;
   }
 
-  template<typename T>
-  bool DynamicArray<T>::const_iterator::operator!=(const_iterator const& a_it) const
+  template<typename T, typename POOL>
+  bool DynamicArray<T, POOL>::const_iterator::operator!=(const_iterator const& a_it) const
   {
     return m_pData != a_it.m_pData;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::const_iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::const_iterator::operator+(size_t a_val) const
   {
     T const * pData = m_pData + a_val;
     return const_iterator(pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::const_iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::const_iterator::operator-(size_t a_val) const
   {
     T const * pData = m_pData - a_val;
     return const_iterator(pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator&
-    DynamicArray<T>::const_iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator&
+    DynamicArray<T, POOL>::const_iterator::operator+=(size_t a_val)
   {
     m_pData += a_val;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator&
-    DynamicArray<T>::const_iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator&
+    DynamicArray<T, POOL>::const_iterator::operator-=(size_t a_val)
   {
     m_pData -= a_val;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator&
-    DynamicArray<T>::const_iterator::operator++()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator&
+    DynamicArray<T, POOL>::const_iterator::operator++()
   {
     m_pData++;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::const_iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator&
-    DynamicArray<T>::const_iterator::operator--()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator&
+    DynamicArray<T, POOL>::const_iterator::operator--()
   {
     m_pData--;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::const_iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
-  T const * DynamicArray<T>::const_iterator::operator->() const
+  template<typename T, typename POOL>
+  T const * DynamicArray<T, POOL>::const_iterator::operator->() const
   {
     return m_pData;
   }
 
-  template<typename T>
-  T const & DynamicArray<T>::const_iterator::operator*() const
+  template<typename T, typename POOL>
+  T const & DynamicArray<T, POOL>::const_iterator::operator*() const
   {
     return *m_pData;
   }
@@ -313,134 +332,134 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // iterator
   //------------------------------------------------------------------------------------------------
-  template<typename T>
-  DynamicArray<T>::iterator::iterator(T* a_pData)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::iterator::iterator(T* a_pData)
     : m_pData(a_pData)
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::iterator::iterator()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::iterator::iterator()
     : m_pData(nullptr)
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::iterator::~iterator()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename T>
-  DynamicArray<T>::iterator::iterator(iterator const& a_it)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::iterator::iterator(iterator const& a_it)
     : m_pData(a_it.m_pData)
   {
 
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator&
-    DynamicArray<T>::iterator::operator=(iterator const& a_it)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator&
+    DynamicArray<T, POOL>::iterator::operator=(iterator const& a_it)
   {
     m_pData = a_it.m_pData;
     return *this;
   }
 
-  template<typename T>
-  bool DynamicArray<T>::iterator::operator==(iterator const& a_it) const
+  template<typename T, typename POOL>
+  bool DynamicArray<T, POOL>::iterator::operator==(iterator const& a_it) const
   {
     return m_pData == a_it.m_pData;
   }
 
-  template<typename T>
-  bool DynamicArray<T>::iterator::operator!=(iterator const& a_it) const
+  template<typename T, typename POOL>
+  bool DynamicArray<T, POOL>::iterator::operator!=(iterator const& a_it) const
   {
     return m_pData != a_it.m_pData;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::iterator::operator+(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::iterator::operator+(size_t a_val) const
   {
     T* pData = m_pData + a_val;
     return iterator(pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::iterator::operator-(size_t a_val) const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::iterator::operator-(size_t a_val) const
   {
     T* pData = m_pData - a_val;
     return iterator(pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator&
-    DynamicArray<T>::iterator::operator+=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator&
+    DynamicArray<T, POOL>::iterator::operator+=(size_t a_val)
   {
     m_pData += a_val;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator&
-    DynamicArray<T>::iterator::operator-=(size_t a_val)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator&
+    DynamicArray<T, POOL>::iterator::operator-=(size_t a_val)
   {
     m_pData -= a_val;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator&
-    DynamicArray<T>::iterator::operator++()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator&
+    DynamicArray<T, POOL>::iterator::operator++()
   {
     m_pData++;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::iterator::operator++(int)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator&
-    DynamicArray<T>::iterator::operator--()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator&
+    DynamicArray<T, POOL>::iterator::operator--()
   {
     m_pData--;
     return *this;
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::iterator::operator--(int)
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
-  T * DynamicArray<T>::iterator::operator->()
+  template<typename T, typename POOL>
+  T * DynamicArray<T, POOL>::iterator::operator->()
   {
     return m_pData;
   }
 
-  template<typename T>
-  T & DynamicArray<T>::iterator::operator*()
+  template<typename T, typename POOL>
+  T & DynamicArray<T, POOL>::iterator::operator*()
   {
     return *m_pData;
   }
 
-  template<typename T>
-  DynamicArray<T>::iterator::operator
-    typename DynamicArray<T>::const_iterator() const
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::iterator::operator
+    typename DynamicArray<T, POOL>::const_iterator() const
   {
     return const_iterator(m_pData);
   }
@@ -449,60 +468,54 @@ namespace Dg
   //		DynamicArray
   //--------------------------------------------------------------------------------
 
-  template<typename T>
-  DynamicArray<T>::DynamicArray()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::DynamicArray()
     : m_pData(nullptr)
     , m_nItems(0)
   {
-    m_pData = static_cast<T*>(malloc(m_poolSize.GetSize() * sizeof(T)));
-    if (m_pData == nullptr)
-      throw std::bad_alloc();
+    Reallocate(m_poolSize);
   }
 
-  template<typename T>
-  DynamicArray<T>::DynamicArray(size_t a_size)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::DynamicArray(size_t a_size)
     : m_pData(nullptr)
     , m_nItems(0)
   {
-    m_poolSize.SetSize(a_size);
-    m_pData = static_cast<T*>(malloc(m_poolSize.GetSize() * sizeof(T)));
-    if (m_pData == nullptr)
-      throw std::bad_alloc();
+    //Sized at construction, so this does not count as a resize.
+    Reallocate(POOL(a_size));
   }
 
-  template<typename T>
-  DynamicArray<T>::~DynamicArray()
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::~DynamicArray()
   {
     for (size_t i = 0; i < m_nItems; i++)
       m_pData[i].~T();
 
-    free(m_pData);
+    impl::LargeAlloc::Free(m_pData, m_poolSize.GetSize() * sizeof(T));
   }
 
-  template<typename T>
-  DynamicArray<T>::DynamicArray(DynamicArray const & a_other)
-    : m_poolSize(a_other.m_poolSize)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::DynamicArray(DynamicArray const & a_other)
+    : m_poolSize(a_other.m_poolSize.GetSize())
     , m_pData(nullptr)
     , m_nItems(0)
   {
-    m_poolSize.SetSize(a_other.m_poolSize.GetSize());
     init(a_other);
   }
 
-  template<typename T>
-  DynamicArray<T> & DynamicArray<T>::operator= (DynamicArray const & a_other)
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL> & DynamicArray<T, POOL>::operator= (DynamicArray const & a_other)
   {
     if (this != &a_other)
     {
       clear();
-      m_poolSize = a_other.m_poolSize;
       init(a_other);
     }
     return *this;
   }
 
-  template<typename T>
-  DynamicArray<T>::DynamicArray(DynamicArray && a_other) noexcept
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL>::DynamicArray(DynamicArray && a_other) noexcept
     : m_poolSize(a_other.m_poolSize)
     , m_pData(a_other.m_pData)
     , m_nItems(a_other.m_nItems)
@@ -511,11 +524,16 @@ namespace Dg
     a_other.m_nItems = 0;
   }
 
-  template<typename T>
-  DynamicArray<T> & DynamicArray<T>::operator= (DynamicArray && a_other) noexcept
+  template<typename T, typename POOL>
+  DynamicArray<T, POOL> & DynamicArray<T, POOL>::operator= (DynamicArray && a_other) noexcept
   {
     if (this != &a_other)
     {
+      //Release what this holds
+      for (size_t i = 0; i < m_nItems; i++)
+        m_pData[i].~T();
+      impl::LargeAlloc::Free(m_pData, m_poolSize.GetSize() * sizeof(T));
+
       //Assign to this
       m_nItems = a_other.m_nItems;
       m_pData = a_other.m_pData;
@@ -528,84 +546,84 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  T & DynamicArray<T>::operator[](size_t i)				
+  template<typename T, typename POOL>
+  T & DynamicArray<T, POOL>::operator[](size_t i)				
   { 
     return m_pData[i]; 
   }
 
-  template<typename T>
-  T const & DynamicArray<T>::operator[](size_t i) const
+  template<typename T, typename POOL>
+  T const & DynamicArray<T, POOL>::operator[](size_t i) const
   { 
     return m_pData[i]; 
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::begin()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::begin()
   {
     return iterator(m_pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::iterator
-    DynamicArray<T>::end()
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::iterator
+    DynamicArray<T, POOL>::end()
   {
     return iterator(m_pData + m_nItems);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::cbegin() const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::cbegin() const
   {
     return const_iterator(m_pData);
   }
 
-  template<typename T>
-  typename DynamicArray<T>::const_iterator
-    DynamicArray<T>::cend() const
+  template<typename T, typename POOL>
+  typename DynamicArray<T, POOL>::const_iterator
+    DynamicArray<T, POOL>::cend() const
   {
     return const_iterator(m_pData + m_nItems);
   }
 
-  template<typename T>
-  T & DynamicArray<T>::back() 
+  template<typename T, typename POOL>
+  T & DynamicArray<T, POOL>::back() 
   { 
     return m_pData[m_nItems - 1]; 
   }
 
-  template<typename T>
-  T const & DynamicArray<T>::back() const
+  template<typename T, typename POOL>
+  T const & DynamicArray<T, POOL>::back() const
   { 
     return m_pData[m_nItems - 1]; 
   }
 
-  template<typename T>
-  size_t DynamicArray<T>::size() const			
+  template<typename T, typename POOL>
+  size_t DynamicArray<T, POOL>::size() const			
   { 
     return m_nItems; 
   }
 
-  template<typename T>
-  bool DynamicArray<T>::empty() const			
+  template<typename T, typename POOL>
+  bool DynamicArray<T, POOL>::empty() const			
   { 
     return m_nItems == 0; 
   }
 
-  template<typename T>
-  T * DynamicArray<T>::data()
+  template<typename T, typename POOL>
+  T * DynamicArray<T, POOL>::data()
   { 
     return m_pData; 
   }
 
-  template<typename T>
-  T const * DynamicArray<T>::data() const
+  template<typename T, typename POOL>
+  T const * DynamicArray<T, POOL>::data() const
   { 
     return m_pData; 
   }
 
-  template<typename T>
-  void DynamicArray<T>::push_back(T const &a_item)
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::push_back(T const &a_item)
   {
     if (m_nItems == m_poolSize.GetSize())
       extend();
@@ -614,8 +632,50 @@ namespace Dg
     m_nItems++;
   }
 
-  template<typename T>
-  void DynamicArray<T>::insert(size_t a_position, T const &a_item)
+  template<typename T, typename POOL>
+  T * DynamicArray<T, POOL>::append_uninitialized(size_t a_count)
+  {
+    reserve(m_nItems + a_count);
+    T * result = m_pData + m_nItems;
+    m_nItems += a_count;
+    return result;
+  }
+
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::reserve(size_t a_count)
+  {
+    if (a_count <= m_poolSize.GetSize())
+      return;
+
+    POOL poolSize(m_poolSize);
+    poolSize.SetSize(a_count);
+    Reallocate(poolSize);
+  }
+
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::shrink_to_fit()
+  {
+    POOL poolSize(m_poolSize);
+    poolSize.SetSize(m_nItems);
+    if (poolSize.GetSize() < m_poolSize.GetSize())
+      Reallocate(poolSize);
+  }
+
+  template<typename T, typename POOL>
+  ContainerStats DynamicArray<T, POOL>::GetStats() const
+  {
+    ContainerStats stats;
+    stats.elementCount = m_nItems;
+    stats.capacity = m_poolSize.GetSize();
+    stats.bytesReserved = m_poolSize.GetSize() * sizeof(T);
+    stats.bytesUsed = m_nItems * sizeof(T);
+    stats.poolSizeIndex = m_poolSize.GetIndex();
+    stats.poolResizes = m_poolSize.GetResizeCount();
+    return stats;
+  }
+
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::insert(size_t a_position, T const &a_item)
   {
     if (a_position > m_nItems)
       throw std::out_of_range("Index out of bounds when inserting element.");
@@ -630,8 +690,8 @@ namespace Dg
     m_nItems++;
   }
 
-  template<typename T>
-  void DynamicArray<T>::erase(size_t a_position)
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::erase(size_t a_position)
   {
     if (a_position > m_nItems)
       throw std::out_of_range("Index out of bounds when inserting element.");
@@ -644,40 +704,39 @@ namespace Dg
     m_nItems--;
   }
 
-  template<typename T>
-  void DynamicArray<T>::pop_back()
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::pop_back()
   {
-    m_pData[m_poolSize.GetSize() - 1].~T();
+    m_pData[m_nItems - 1].~T();
     --m_nItems;
   }
 
-  template<typename T>
-  void DynamicArray<T>::clear()
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::clear()
   {
     for (size_t i = 0; i < m_nItems; i++)
       m_pData[i].~T();
     m_nItems = 0;
   }
 
-  template<typename T>
-  void DynamicArray<T>::resize(size_t a_size)
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::resize(size_t a_size)
   {
-    pool_size(a_size);
+    POOL poolSize(m_poolSize);
+    poolSize.SetSize(a_size);
 
-    if (m_poolSize.GetSize() < m_nItems)
+    if (poolSize.GetSize() < m_nItems)
     {
-      for (size_t i = m_poolSize.GetSize(); i < m_nItems; i++)
+      for (size_t i = poolSize.GetSize(); i < m_nItems; i++)
         m_pData[i].~T();
-      m_nItems = m_poolSize.GetSize();
+      m_nItems = poolSize.GetSize();
     }
 
-    m_pData = static_cast<T*>(realloc(m_pData, m_poolSize.GetSize() * sizeof(T)));
-    if (m_pData == nullptr)
-      throw std::bad_alloc();
+    Reallocate(poolSize);
   }
 
-  template<typename T>
-  void DynamicArray<T>::erase_swap(size_t a_ind)
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::erase_swap(size_t a_ind)
   {
     m_pData[a_ind].~T();
 
@@ -687,26 +746,37 @@ namespace Dg
     --m_nItems;
   }
 
-  template<typename T>
-  void DynamicArray<T>::extend()
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::extend()
+  {
+    POOL poolSize(m_poolSize);
+    poolSize.SetNextPoolSize();
+    Reallocate(poolSize);
+  }
+
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::Reallocate(POOL const & a_poolSize)
   {
-    m_poolSize.SetNextPoolSize();
-    m_pData = static_cast<T*>(realloc(m_pData, m_poolSize.GetSize() * sizeof(T)));
-    if (m_pData == nullptr)
+    size_t oldBytes = m_poolSize.GetSize() * sizeof(T);
+    void * pData = impl::LargeAlloc::Reallocate(m_pData, oldBytes, a_poolSize.GetSize() * sizeof(T));
+    if (pData == nullptr)
       throw std::bad_alloc();
+
+    m_pData = static_cast<T*>(pData);
+    m_poolSize = a_poolSize;
   }
 
   //TODO initializing from another can fail. If so, the array
   //should be left in its original state. Currently it is left 
   //in an invalid state.
-  template<typename T>
-  void DynamicArray<T>::init(DynamicArray const & a_other)
+  template<typename T, typename POOL>
+  void DynamicArray<T, POOL>::init(DynamicArray const & a_other)
   {
-    m_poolSize = a_other.m_poolSize;
+    //Take the other's size, but keep this array's own resize count.
+    POOL poolSize(m_poolSize);
+    poolSize.SetSize(a_other.m_poolSize.GetSize());
+    Reallocate(poolSize);
     m_nItems = a_other.m_nItems;
-    m_pData = static_cast<T*>(realloc(m_pData, m_poolSize.GetSize() * sizeof(T)));
-    if (m_pData == nullptr)
-      throw std::bad_alloc();
 
     for (size_t i = 0; i < m_nItems; i++)
       new (&m_pData[i]) T(a_other.m_pData[i]);
@@ -715,57 +785,63 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		Bool specialization
   //--------------------------------------------------------------------------------
-  template<>
-  class DynamicArray<bool>
+  namespace impl
   {
-  private:
-
-    template<int T>
-    struct Attr;
-
-    template<>
-    struct Attr<1>
+    namespace DynamicArray
     {
-      typedef uint8_t intType;
-      static intType const shift = 3;
-      static intType const mask = 7;
-      static intType const nBits = CHAR_BIT * sizeof(intType);
-    };
+      template<int T>
+      struct Attr;
 
-    template<>
-    struct Attr<2>
-    {
-      typedef uint16_t intType;
-      static intType const shift = 4;
-      static intType const mask = 15;
-      static intType const nBits = CHAR_BIT * sizeof(intType);
-    };
-
-    template<>
-    struct Attr<4>
-    {
-      typedef uint32_t intType;
-      static intType const shift = 5;
-      static intType const mask = 31;
-      static intType const nBits = CHAR_BIT * sizeof(intType);
-    };
+      template<>
+      struct Attr<1>
+      {
+        typedef uint8_t intType;
+        static intType const shift = 3;
+        static intType const mask = 7;
+        static intType const nBits = CHAR_BIT * sizeof(intType);
+      };
+
+      template<>
+      struct Attr<2>
+      {
+        typedef uint16_t intType;
+        static intType const shift = 4;
+        static intType const mask = 15;
+        static intType const nBits = CHAR_BIT * sizeof(intType);
+      };
+
+      template<>
+      struct Attr<4>
+      {
+        typedef uint32_t intType;
+        static intType const shift = 5;
+        static intType const mask = 31;
+        static intType const nBits = CHAR_BIT * sizeof(intType);
+      };
+
+      template<>
+      struct Attr<8>
+      {
+        typedef uint64_t intType;
+        static intType const shift = 6;
+        static intType const mask = 63;
+        static intType const nBits = CHAR_BIT * sizeof(intType);
+      };
+    }
+  }
 
-    template<>
-    struct Attr<8>
-    {
-      typedef uint64_t intType;
-      static intType const shift = 6;
-      static intType const mask = 63;
-      static intType const nBits = CHAR_BIT * sizeof(intType);
-    };
+  template<typename POOL>
+  class DynamicArray<bool, POOL>
+  {
+  private:
 
-    typedef Attr<8> TypeTraits;
+    typedef impl::DynamicArray::Attr<8> TypeTraits;
 
   public:
 
     class reference 
     {
-      friend class DynamicArray<bool>;
+      friend class DynamicArray<bool, POOL>;
       reference(TypeTraits::intType & a_rBucket, int a_bitIndex)
         : m_rBucket(a_rBucket)
         , m_bitIndex(a_bitIndex)
@@ -815,10 +891,10 @@ namespace Dg
 
     //! Construct with a set size
     DynamicArray(TypeTraits::intType a_size)
-      : m_pBuckets(nullptr)
+      : m_poolSize(a_size)
+      , m_pBuckets(nullptr)
       , m_nItems(0)
     {
-      m_poolSize.SetSize(a_size);
       m_pBuckets = static_cast<TypeTraits::intType*>(malloc(m_poolSize.GetSize() * sizeof(TypeTraits::intType)));
       if (m_pBuckets == nullptr)
         throw std::bad_alloc();
@@ -831,7 +907,7 @@ namespace Dg
 
     //! Copy constructor
     DynamicArray(DynamicArray const & a_other)
-      : m_poolSize(a_other.m_poolSize)
+      : m_poolSize(a_other.m_poolSize.GetSize())
       , m_pBuckets(nullptr)
     {
       init(a_other);
@@ -844,7 +920,6 @@ namespace Dg
         return *this;
 
       clear();
-      m_poolSize = a_other.m_poolSize;
       init(a_other);
 
       return *this;
@@ -865,6 +940,8 @@ namespace Dg
     {
       if (this != &a_other)
       {
+        free(m_pBuckets);
+
         //Assign to this
         m_nItems = a_other.m_nItems;
         m_pBuckets = a_other.m_pBuckets;
@@ -959,6 +1036,19 @@ namespace Dg
       m_pBuckets = tempBuckets;
     }
 
+    //! Memory and occupancy snapshot.
+    ContainerStats GetStats() const
+    {
+      ContainerStats stats;
+      stats.elementCount = m_nItems;
+      stats.capacity = m_poolSize.GetSize() * TypeTraits::nBits;
+      stats.bytesReserved = m_poolSize.GetSize() * sizeof(TypeTraits::intType);
+      stats.bytesUsed = ((m_nItems + TypeTraits::nBits - 1) / TypeTraits::nBits) * sizeof(TypeTraits::intType);
+      stats.poolSizeIndex = m_poolSize.GetIndex();
+      stats.poolResizes = m_poolSize.GetResizeCount();
+      return stats;
+    }
+
   private:
 
     //! Exteneds the total size of the array (current + reserve) by a factor of 2
@@ -981,7 +1071,7 @@ namespace Dg
 
   private:
     //Data members
-    PoolSizeMngr_Default          m_poolSize;
+    POOL                     m_poolSize;
     TypeTraits::intType *    m_pBuckets;
     TypeTraits::intType      m_nItems;
   };
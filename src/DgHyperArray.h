@@ -5,6 +5,9 @@
 
 #include <array>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 //TODO check for nullptr returns in realloc and throw
 namespace Dg
@@ -91,12 +94,236 @@ namespace Dg
     }
   }
 
-  template<typename T, size_t Dimensions>
+  /// Default storage layout. Elements are stored in row-major order; the last
+  /// index varies fastest.
+  class HyperArrayLayout_RowMajor
+  {
+  public:
+
+    /// Edge length used when iterating over tiles of an array with this layout.
+    static constexpr size_t s_defaultTileEdge = 8;
+
+    template<size_t Dimensions>
+    class Mapper
+    {
+    public:
+
+      void Set(std::array<size_t, Dimensions> const & a_dimensions)
+      {
+        m_dataLength = impl::ct_accumulate(a_dimensions,
+                                           0,
+                                           Dimensions,
+                                           static_cast<size_t>(1),
+                                           impl::ct_prod<size_t>);
+
+        m_indexCoeffs[Dimensions - 1] = 1;
+        for (size_t i = 0; i < (Dimensions - 1); ++i)
+        {
+          m_indexCoeffs[i] = impl::ct_accumulate(a_dimensions,
+                                                 i + 1,
+                                                 Dimensions - i - 1,
+                                                 static_cast<size_t>(1),
+                                                 impl::ct_prod<size_t>);
+        }
+      }
+
+      size_t DataLength() const
+      {
+        return m_dataLength;
+      }
+
+      size_t Index(std::array<size_t, Dimensions> const & a_indexArray) const
+      {
+        // I_{actual} = \sum_{i=0}^{N-1} {C_i \cdot I_i}
+        //
+        // where I_{actual} : actual index of the data in the data array
+        //       N          : Dimensions
+        //       C_i        : indexCoeffs[i]
+        //       I_i        : indexArray[i]
+        return impl::ct_inner_product(m_indexCoeffs, 0,
+                                      a_indexArray, 0,
+                                      Dimensions,
+                                      static_cast<size_t>(0),
+                                      impl::ct_plus<size_t>,
+                                      impl::ct_prod<size_t>);
+      }
+
+    private:
+
+      std::array<size_t, Dimensions> m_indexCoeffs;
+      size_t                         m_dataLength;
+    };
+  };
+
+  /// Elements are stored in blocks of EDGE^Dimensions elements. Blocks are laid out
+  /// in row-major order, as are the elements within a block. Each dimension is
+  /// padded up to a multiple of EDGE. A power of two EDGE lets the compiler replace
+  /// the divisions with shifts.
+  template<size_t EDGE>
+  class HyperArrayLayout_Tiled
+  {
+    static_assert(EDGE > 0, "Tile edge must be greater than zero");
+
+  public:
+
+    static constexpr size_t s_defaultTileEdge = EDGE;
+
+    template<size_t Dimensions>
+    class Mapper
+    {
+    public:
+
+      void Set(std::array<size_t, Dimensions> const & a_dimensions)
+      {
+        m_tileLength = 1;
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          m_tileLength *= EDGE;
+        }
+
+        std::array<size_t, Dimensions> nTiles;
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          nTiles[i] = (a_dimensions[i] + EDGE - 1) / EDGE;
+        }
+
+        m_tileCoeffs[Dimensions - 1] = m_tileLength;
+        m_localCoeffs[Dimensions - 1] = 1;
+        for (size_t i = Dimensions - 1; i > 0; i--)
+        {
+          m_tileCoeffs[i - 1] = m_tileCoeffs[i] * nTiles[i];
+          m_localCoeffs[i - 1] = m_localCoeffs[i] * EDGE;
+        }
+        m_dataLength = m_tileCoeffs[0] * nTiles[0];
+      }
+
+      size_t DataLength() const
+      {
+        return m_dataLength;
+      }
+
+      size_t Index(std::array<size_t, Dimensions> const & a_indexArray) const
+      {
+        size_t result = 0;
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          result += (a_indexArray[i] / EDGE) * m_tileCoeffs[i]
+                  + (a_indexArray[i] % EDGE) * m_localCoeffs[i];
+        }
+        return result;
+      }
+
+    private:
+
+      std::array<size_t, Dimensions> m_tileCoeffs;
+      std::array<size_t, Dimensions> m_localCoeffs;
+      size_t                         m_tileLength;
+      size_t                         m_dataLength;
+    };
+  };
+
+  /// Elements are stored in Morton (Z) order: the bits of the indices are
+  /// interleaved, so that elements close in space are close in memory. Each
+  /// dimension is padded up to a power of two, and dimensions may differ in length;
+  /// once the shorter dimensions run out of bits the remaining bits of the longer
+  /// dimensions are placed above them. Aligned power-of-two blocks no larger than
+  /// the shortest dimension are contiguous.
+  ///
+  /// The interleaving is done through one lookup table per dimension, so indexing
+  /// costs Dimensions loads and ORs.
+  class HyperArrayLayout_Morton
+  {
+  public:
+
+    static constexpr size_t s_defaultTileEdge = 8;
+
+    template<size_t Dimensions>
+    class Mapper
+    {
+    public:
+
+      void Set(std::array<size_t, Dimensions> const & a_dimensions)
+      {
+        std::array<size_t, Dimensions> nBits;
+        size_t maxBits = 0;
+        size_t totalBits = 0;
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          nBits[i] = 0;
+          while ((static_cast<size_t>(1) << nBits[i]) < a_dimensions[i])
+          {
+            nBits[i]++;
+          }
+          if (nBits[i] > maxBits) maxBits = nBits[i];
+          totalBits += nBits[i];
+        }
+
+        if (totalBits >= sizeof(size_t) * 8)
+        {
+          throw std::length_error("Morton index does not fit in size_t");
+        }
+
+        //Assign each bit of each dimension to a bit of the final index.
+        std::array<std::array<size_t, sizeof(size_t) * 8>, Dimensions> bitMap;
+        size_t outBit = 0;
+        for (size_t b = 0; b < maxBits; b++)
+        {
+          for (size_t i = Dimensions; i > 0; i--)
+          {
+            if (b < nBits[i - 1])
+            {
+              bitMap[i - 1][b] = outBit;
+              outBit++;
+            }
+          }
+        }
+
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          m_tables[i].resize(a_dimensions[i]);
+          for (size_t val = 0; val < a_dimensions[i]; val++)
+          {
+            size_t scattered = 0;
+            for (size_t b = 0; b < nBits[i]; b++)
+            {
+              scattered |= ((val >> b) & 1) << bitMap[i][b];
+            }
+            m_tables[i][val] = scattered;
+          }
+        }
+
+        m_dataLength = static_cast<size_t>(1) << totalBits;
+      }
+
+      size_t DataLength() const
+      {
+        return m_dataLength;
+      }
+
+      size_t Index(std::array<size_t, Dimensions> const & a_indexArray) const
+      {
+        size_t result = 0;
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          result |= m_tables[i][a_indexArray[i]];
+        }
+        return result;
+      }
+
+    private:
+
+      std::array<std::vector<size_t>, Dimensions> m_tables;
+      size_t                                      m_dataLength;
+    };
+  };
+
+  template<typename T, size_t Dimensions, typename Layout = HyperArrayLayout_RowMajor>
   class HyperArray
   {
   public:
     using SizeType  = size_t;  ///< used for measuring sizes and lengths
     using IndexType = size_t;  ///< used for indices
+    using LayoutType = Layout;
 
     class CompareBase
     {
@@ -109,6 +336,146 @@ namespace Dg
       }
     };
 
+    /// A block of the array, clipped to the array bounds.
+    struct Tile
+    {
+      std::array<IndexType, Dimensions> origin;
+      std::array<SizeType, Dimensions>  extent;
+    };
+
+    /// Visits the array in blocks of edge^Dimensions elements, in row-major order
+    /// of the blocks. With a tiled layout and matching edge length, each tile is
+    /// contiguous in memory.
+    class tile_iterator
+    {
+      friend class HyperArray;
+
+      tile_iterator(std::array<SizeType, Dimensions> const & a_dimensions,
+                    SizeType a_edge,
+                    bool a_end)
+        : m_dimensionLengths(a_dimensions)
+        , m_edge(a_edge)
+      {
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          m_tile.origin[i] = 0;
+        }
+
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          if (m_dimensionLengths[i] == 0)
+          {
+            a_end = true;
+          }
+        }
+
+        if (a_end)
+        {
+          m_tile.origin[0] = EndOrigin();
+        }
+        UpdateExtent();
+      }
+
+    public:
+
+      Tile const & operator*() const
+      {
+        return m_tile;
+      }
+
+      Tile const * operator->() const
+      {
+        return &m_tile;
+      }
+
+      bool operator==(tile_iterator const & a_other) const
+      {
+        return m_tile.origin == a_other.m_tile.origin;
+      }
+
+      bool operator!=(tile_iterator const & a_other) const
+      {
+        return !(*this == a_other);
+      }
+
+      tile_iterator & operator++()
+      {
+        for (size_t i = Dimensions; i > 0; i--)
+        {
+          m_tile.origin[i - 1] += m_edge;
+          if (m_tile.origin[i - 1] < m_dimensionLengths[i - 1] || i == 1)
+          {
+            break;
+          }
+          m_tile.origin[i - 1] = 0;
+        }
+
+        if (m_tile.origin[0] >= m_dimensionLengths[0])
+        {
+          m_tile.origin[0] = EndOrigin();
+        }
+        UpdateExtent();
+        return *this;
+      }
+
+      tile_iterator operator++(int)
+      {
+        tile_iterator result(*this);
+        ++(*this);
+        return result;
+      }
+
+    private:
+
+      IndexType EndOrigin() const
+      {
+        return ((m_dimensionLengths[0] + m_edge - 1) / m_edge) * m_edge;
+      }
+
+      void UpdateExtent()
+      {
+        for (size_t i = 0; i < Dimensions; i++)
+        {
+          SizeType remaining = m_tile.origin[i] < m_dimensionLengths[i] ? m_dimensionLengths[i] - m_tile.origin[i] : 0;
+          m_tile.extent[i] = remaining < m_edge ? remaining : m_edge;
+        }
+      }
+
+    private:
+
+      std::array<SizeType, Dimensions>  m_dimensionLengths;
+      SizeType                          m_edge;
+      Tile                              m_tile;
+    };
+
+    /// Range over the tiles of an array, for use in range-based for loops.
+    class TileRange
+    {
+    public:
+
+      TileRange(std::array<SizeType, Dimensions> const & a_dimensions, SizeType a_edge)
+        : m_dimensionLengths(a_dimensions)
+        , m_edge(a_edge == 0 ? 1 : a_edge)
+      {
+
+      }
+
+      tile_iterator begin() const
+      {
+        return tile_iterator(m_dimensionLengths, m_edge, false);
+      }
+
+      tile_iterator end() const
+      {
+        return tile_iterator(m_dimensionLengths, m_edge, true);
+      }
+
+    private:
+
+      std::array<SizeType, Dimensions>  m_dimensionLengths;
+      SizeType                          m_edge;
+    };
+
   public:
 
     //Default dimensions lengths are 1.
@@ -133,9 +500,9 @@ namespace Dg
 
     HyperArray(HyperArray&& a_other)
       : m_dimensionLengths(std::move(a_other.m_dimensionLengths))
-      , m_dataLength(a_other.m_dataLength)
-      , m_indexCoeffs(std::move(a_other.m_indexCoeffs))
       , m_pData(a_other.m_pData)
+      , m_dataLength(a_other.m_dataLength)
+      , m_mapper(std::move(a_other.m_mapper))
     {
       a_other.m_pData = nullptr;
     }
@@ -145,7 +512,7 @@ namespace Dg
       if (this != &a_other)
       {
         m_dimensionLengths = std::move(a_other.m_dimensionLengths);
-        m_indexCoeffs = std::move(a_other.m_indexCoeffs);
+        m_mapper = std::move(a_other.m_mapper);
         m_dataLength = a_other.m_dataLength;
         
         delete[] m_pData;
@@ -158,7 +525,7 @@ namespace Dg
     HyperArray(HyperArray const & a_other)
       : m_dimensionLengths(a_other.m_dimensionLengths)
       , m_dataLength(a_other.m_dataLength)
-      , m_indexCoeffs(a_other.m_indexCoeffs)
+      , m_mapper(a_other.m_mapper)
     {
       m_pData = new T[m_dataLength];
       for (size_t i = 0; i < m_dataLength; i++)
@@ -169,11 +536,11 @@ namespace Dg
     
     HyperArray & operator=(HyperArray const & a_other)
     {
-      if (this == & a_other)
+      if (this != &a_other)
       {
         m_dimensionLengths = a_other.m_dimensionLengths;
         m_dataLength = a_other.m_dataLength;
-        m_indexCoeffs = a_other.m_indexCoeffs;
+        m_mapper = a_other.m_mapper;
     
         delete[] m_pData;
         m_pData = new T[m_dataLength];
@@ -189,22 +556,10 @@ namespace Dg
     void Set(std::array<size_t, Dimensions> const & a_dimensions)
     {
       m_dimensionLengths = a_dimensions;
-      m_dataLength = impl::ct_accumulate(m_dimensionLengths,
-                                         0,
-                                         Dimensions,
-                                         static_cast<SizeType>(1),
-                                         impl::ct_prod<SizeType>);
-
-      m_indexCoeffs[Dimensions - 1] = 1;
-      for (SizeType i = 0; i < (Dimensions - 1); ++i)
-      {
-        m_indexCoeffs[i] = impl::ct_accumulate(m_dimensionLengths,
-                                               i + 1,
-                                               Dimensions - i - 1,
-                                               static_cast<SizeType>(1),
-                                               impl::ct_prod<SizeType>);
-      }
+      m_mapper.Set(m_dimensionLengths);
+      m_dataLength = m_mapper.DataLength();
 
+      delete[] m_pData;
       m_pData = new T[m_dataLength];
     }
 
@@ -216,32 +571,51 @@ namespace Dg
     template <IndexType Depth, typename = std::enable_if_t<Depth <= Dimensions>>
     void fill(T const & a_val, std::array<IndexType, Depth> const & a_index)
     {
-      for (IndexType i = 0; i < m_dimensionLengths[Depth]; i++)
+      if constexpr (Depth == Dimensions)
       {
-        std::array<IndexType, Depth + 1> index;
-
-        for (size_t j = 0; j < Depth; j++)
+        rangeCheck(a_index);
+        IndexType ind = rawIndex_noChecks(a_index);
+        m_pData[ind] = a_val;
+      }
+      else
+      {
+        for (IndexType i = 0; i < m_dimensionLengths[Depth]; i++)
         {
-          index[j] = a_index[j];
-        }
+          std::array<IndexType, Depth + 1> index;
+
+          for (size_t j = 0; j < Depth; j++)
+          {
+            index[j] = a_index[j];
+          }
 
-        index[Depth] = i;
+          index[Depth] = i;
 
-        fill<Depth + 1>(a_val, index);
+          fill<Depth + 1>(a_val, index);
+        }
       }
     }
 
-    template<>
-    void fill<Dimensions>(T const & a_val, std::array<IndexType, Dimensions> const & a_index)
+    ~HyperArray()
     {
-      rangeCheck(a_index);
-      IndexType ind = rawIndex_noChecks(a_index);
-      m_pData[ind] = a_val;
+      delete[] m_pData;
     }
 
-    ~HyperArray()
+    /// Raw element storage, in the order given by the layout. Storage may be padded,
+    /// see [dataLength()](@ref dataLength()).
+    T * data()
     {
-      delete[] m_pData;
+      return m_pData;
+    }
+
+    T const * data() const
+    {
+      return m_pData;
+    }
+
+    /// Number of elements in the underlying storage, including any layout padding.
+    SizeType dataLength() const
+    {
+      return m_dataLength;
     }
 
     /// Returns the length of a given dimension at run-time
@@ -344,30 +718,35 @@ namespace Dg
                  std::array<IndexType, Depth> const & a_index2,
                  CompareBase & a_cmp) const
     {
-      for (IndexType i = 0; i < m_dimensionLengths[Depth]; i++)
+      if constexpr (Depth == Dimensions)
       {
-        std::array<IndexType, Depth + 1> index1, index2;
-
-        for (size_t j = 0; j < Depth; j++)
+        return a_cmp(_at(a_index1), _at(a_index2));
+      }
+      else
+      {
+        for (IndexType i = 0; i < m_dimensionLengths[Depth]; i++)
         {
-          index1[j] = a_index1[j];
-          index2[j] = a_index2[j];
-        }
+          std::array<IndexType, Depth + 1> index1, index2;
 
-        index1[Depth] = i;
-        index2[Depth] = i;
+          for (size_t j = 0; j < Depth; j++)
+          {
+            index1[j] = a_index1[j];
+            index2[j] = a_index2[j];
+          }
 
-        if (!compare<Depth + 1>(index1, index2, a_cmp)) return false;
+          index1[Depth] = i;
+          index2[Depth] = i;
+
+          if (!compare<Depth + 1>(index1, index2, a_cmp)) return false;
+        }
+        return true;
       }
-      return true;
     }
 
-    template<>
-    bool compare<Dimensions>(std::array<IndexType, Dimensions> const & a_index1, 
-                             std::array<IndexType, Dimensions> const & a_index2,
-                             CompareBase & a_cmp) const
+    /// Iterate over the array in blocks. The default edge length matches the layout.
+    TileRange tiles(SizeType a_edge = Layout::s_defaultTileEdge) const
     {
-      return a_cmp(_at(a_index1), _at(a_index2));
+      return TileRange(m_dimensionLengths, a_edge);
     }
 
   private:
@@ -405,18 +784,7 @@ namespace Dg
 
     IndexType rawIndex_noChecks(std::array<IndexType, Dimensions> const & a_indexArray) const
     {
-      // I_{actual} = \sum_{i=0}^{N-1} {C_i \cdot I_i}
-      //
-      // where I_{actual} : actual index of the data in the data array
-      //       N          : Dimensions
-      //       C_i        : indexCoeffs[i]
-      //       I_i        : indexArray[i]
-      return impl::ct_inner_product(m_indexCoeffs, 0,
-                                    a_indexArray, 0,
-                                    Dimensions,
-                                    static_cast<IndexType>(0),
-                                    impl::ct_plus<IndexType>,
-                                    impl::ct_prod<IndexType>);
+      return m_mapper.Index(a_indexArray);
     }
 
     T const & _at(std::array<IndexType, Dimensions> const & a_indexArray) const
@@ -431,7 +799,7 @@ namespace Dg
     std::array<SizeType, Dimensions> m_dimensionLengths;
     T *                              m_pData;
     SizeType                         m_dataLength;
-    std::array<SizeType, Dimensions> m_indexCoeffs; 
+    typename Layout::template Mapper<Dimensions> m_mapper;
   };
 }
 
@@ -0,0 +1,430 @@
+//@group Collections
+
+#ifndef DGHYPERARRAYVIEW_H
+#define DGHYPERARRAYVIEW_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "DgHyperArray.h"
+
+namespace Dg
+{
+  /// Non-owning, strided view into a block of elements. Views are cheap to copy and
+  /// never allocate; slicing, sub-ranging and transposing only adjust the pointer,
+  /// lengths and strides. The viewed data must outlive the view.
+  ///
+  /// Use `HyperArrayView<T const, D>` for read-only views.
+  template<typename T, size_t Dimensions>
+  class HyperArrayView
+  {
+    static_assert(Dimensions > 0, "Views must have at least one dimension");
+
+  public:
+    using SizeType   = size_t;
+    using IndexType  = size_t;
+    using StrideType = ptrdiff_t;
+    using ValueType  = T;
+
+  public:
+
+    HyperArrayView()
+      : m_pData(nullptr)
+    {
+      m_lengths.fill(0);
+      m_strides.fill(0);
+    }
+
+    HyperArrayView(T * a_pData,
+                   std::array<SizeType, Dimensions> const & a_lengths,
+                   std::array<StrideType, Dimensions> const & a_strides)
+      : m_pData(a_pData)
+      , m_lengths(a_lengths)
+      , m_strides(a_strides)
+    {
+
+    }
+
+    /// View of densely packed row-major data.
+    HyperArrayView(T * a_pData, std::array<SizeType, Dimensions> const & a_lengths)
+      : m_pData(a_pData)
+      , m_lengths(a_lengths)
+    {
+      m_strides[Dimensions - 1] = 1;
+      for (size_t i = Dimensions - 1; i > 0; i--)
+      {
+        m_strides[i - 1] = m_strides[i] * static_cast<StrideType>(m_lengths[i]);
+      }
+    }
+
+    /// Allows a mutable view to be passed where a read-only view is expected.
+    template<typename U, typename = std::enable_if_t<std::is_same<T, U const>::value && !std::is_same<T, U>::value>>
+    HyperArrayView(HyperArrayView<U, Dimensions> const & a_other)
+      : m_pData(a_other.data())
+      , m_lengths(a_other.lengths())
+      , m_strides(a_other.strides())
+    {
+
+    }
+
+    T * data() const
+    {
+      return m_pData;
+    }
+
+    std::array<SizeType, Dimensions> const & lengths() const
+    {
+      return m_lengths;
+    }
+
+    std::array<StrideType, Dimensions> const & strides() const
+    {
+      return m_strides;
+    }
+
+    SizeType length(size_t a_dimensionIndex) const
+    {
+      return m_lengths[a_dimensionIndex];
+    }
+
+    StrideType stride(size_t a_dimensionIndex) const
+    {
+      return m_strides[a_dimensionIndex];
+    }
+
+    /// Total number of elements in the view.
+    SizeType size() const
+    {
+      SizeType result = 1;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        result *= m_lengths[i];
+      }
+      return result;
+    }
+
+    template <typename... Indices,
+              typename = std::enable_if_t<impl::are_all_integral<Indices...>::value && sizeof...(Indices) == Dimensions>
+             >
+    T & operator()(Indices... a_indices) const
+    {
+      std::array<IndexType, Dimensions> indexArray = {{static_cast<IndexType>(a_indices)...}};
+      return m_pData[Offset(indexArray)];
+    }
+
+    template <typename... Indices,
+              typename = std::enable_if_t<impl::are_all_integral<Indices...>::value && sizeof...(Indices) == Dimensions>
+             >
+    T & at(Indices... a_indices) const
+    {
+      std::array<IndexType, Dimensions> indexArray = {{static_cast<IndexType>(a_indices)...}};
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        if (indexArray[i] >= m_lengths[i])
+        {
+          throw std::out_of_range("HyperArrayView index out of range");
+        }
+      }
+      return m_pData[Offset(indexArray)];
+    }
+
+    /// Fixes one dimension at the given index, returning a view with one less dimension.
+    template<size_t D = Dimensions, typename = std::enable_if_t<(D > 1)>>
+    HyperArrayView<T, Dimensions - 1> Slice(size_t a_dimension, IndexType a_index) const
+    {
+      if (a_dimension >= Dimensions || a_index >= m_lengths[a_dimension])
+      {
+        throw std::out_of_range("HyperArrayView slice out of range");
+      }
+
+      std::array<SizeType, Dimensions - 1> lengths;
+      std::array<StrideType, Dimensions - 1> strides;
+      for (size_t i = 0, j = 0; i < Dimensions; i++)
+      {
+        if (i == a_dimension)
+        {
+          continue;
+        }
+        lengths[j] = m_lengths[i];
+        strides[j] = m_strides[i];
+        j++;
+      }
+      return HyperArrayView<T, Dimensions - 1>(m_pData + static_cast<StrideType>(a_index) * m_strides[a_dimension], lengths, strides);
+    }
+
+    /// The block starting at origin with the given extent.
+    HyperArrayView Subrange(std::array<IndexType, Dimensions> const & a_origin,
+                            std::array<SizeType, Dimensions> const & a_extent) const
+    {
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        if (a_origin[i] > m_lengths[i] || a_extent[i] > m_lengths[i] - a_origin[i])
+        {
+          throw std::out_of_range("HyperArrayView subrange out of range");
+        }
+      }
+      return HyperArrayView(m_pData + Offset(a_origin), a_extent, m_strides);
+    }
+
+    /// Swaps two dimensions.
+    HyperArrayView Transpose(size_t a_dim0, size_t a_dim1) const
+    {
+      if (a_dim0 >= Dimensions || a_dim1 >= Dimensions)
+      {
+        throw std::out_of_range("HyperArrayView dimension out of range");
+      }
+
+      HyperArrayView result(*this);
+      std::swap(result.m_lengths[a_dim0], result.m_lengths[a_dim1]);
+      std::swap(result.m_strides[a_dim0], result.m_strides[a_dim1]);
+      return result;
+    }
+
+  private:
+
+    StrideType Offset(std::array<IndexType, Dimensions> const & a_indexArray) const
+    {
+      StrideType result = 0;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        result += static_cast<StrideType>(a_indexArray[i]) * m_strides[i];
+      }
+      return result;
+    }
+
+  private:
+
+    T *                                 m_pData;
+    std::array<SizeType, Dimensions>    m_lengths;
+    std::array<StrideType, Dimensions>  m_strides;
+  };
+
+  /// View over a whole array. Only row-major arrays can be viewed.
+  template<typename T, size_t Dimensions>
+  HyperArrayView<T, Dimensions> MakeView(HyperArray<T, Dimensions, HyperArrayLayout_RowMajor> & a_array)
+  {
+    std::array<size_t, Dimensions> lengths;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      lengths[i] = a_array.length_noChecks(i);
+    }
+    return HyperArrayView<T, Dimensions>(a_array.data(), lengths);
+  }
+
+  template<typename T, size_t Dimensions>
+  HyperArrayView<T const, Dimensions> MakeView(HyperArray<T, Dimensions, HyperArrayLayout_RowMajor> const & a_array)
+  {
+    std::array<size_t, Dimensions> lengths;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      lengths[i] = a_array.length_noChecks(i);
+    }
+    return HyperArrayView<T const, Dimensions>(a_array.data(), lengths);
+  }
+
+  namespace impl
+  {
+    namespace HyperArrayView
+    {
+      /// A position within a view while walking its rows.
+      template<typename T, size_t Dimensions>
+      struct Cursor
+      {
+        T *                                       pData;
+        std::array<ptrdiff_t, Dimensions> const * pStrides;
+
+        Cursor Advance(size_t a_dimension, size_t a_index) const
+        {
+          return Cursor{pData + static_cast<ptrdiff_t>(a_index) * (*pStrides)[a_dimension], pStrides};
+        }
+
+        ptrdiff_t InnerStride() const
+        {
+          return (*pStrides)[Dimensions - 1];
+        }
+      };
+
+      template<typename T, size_t Dimensions>
+      Cursor<T, Dimensions> Begin(::Dg::HyperArrayView<T, Dimensions> const & a_view)
+      {
+        return Cursor<T, Dimensions>{a_view.data(), &a_view.strides()};
+      }
+
+      /// Calls a_fn(rowLength, cursors...) once for every row of the innermost
+      /// dimension. All views walk the same index space in lockstep.
+      template<size_t Depth, size_t Dimensions, typename RowFn, typename... Ts>
+      void ForEachRow(std::array<size_t, Dimensions> const & a_lengths, RowFn & a_fn, Cursor<Ts, Dimensions>... a_cursors)
+      {
+        if constexpr (Depth == Dimensions - 1)
+        {
+          a_fn(a_lengths[Depth], a_cursors...);
+        }
+        else
+        {
+          for (size_t i = 0; i < a_lengths[Depth]; i++)
+          {
+            ForEachRow<Depth + 1>(a_lengths, a_fn, a_cursors.Advance(Depth, i)...);
+          }
+        }
+      }
+
+      template<typename T, typename U, size_t Dimensions>
+      void CheckLengths(::Dg::HyperArrayView<T, Dimensions> const & a_0,
+                        ::Dg::HyperArrayView<U, Dimensions> const & a_1)
+      {
+        if (a_0.lengths() != a_1.lengths())
+        {
+          throw std::invalid_argument("HyperArrayView lengths do not match");
+        }
+      }
+    }
+  }
+
+  /// a_out(i...) = a_fn(a_in(i...)) for every element. a_out and a_in may be the
+  /// same view. Rows which are contiguous in both views are processed with a
+  /// unit-stride loop the compiler can vectorize.
+  template<typename T, typename U, size_t Dimensions, typename Fn>
+  void Map(HyperArrayView<T, Dimensions> const & a_out,
+           HyperArrayView<U, Dimensions> const & a_in,
+           Fn a_fn)
+  {
+    namespace ns = impl::HyperArrayView;
+    ns::CheckLengths(a_out, a_in);
+
+    auto row = [&a_fn](size_t a_n, ns::Cursor<T, Dimensions> a_o, ns::Cursor<U, Dimensions> a_i)
+    {
+      ptrdiff_t so = a_o.InnerStride();
+      ptrdiff_t si = a_i.InnerStride();
+      T * pOut = a_o.pData;
+      U * pIn = a_i.pData;
+      if (so == 1 && si == 1)
+      {
+        for (size_t k = 0; k < a_n; k++)
+        {
+          pOut[k] = a_fn(pIn[k]);
+        }
+      }
+      else
+      {
+        for (size_t k = 0; k < a_n; k++)
+        {
+          pOut[static_cast<ptrdiff_t>(k) * so] = a_fn(pIn[static_cast<ptrdiff_t>(k) * si]);
+        }
+      }
+    };
+
+    ns::ForEachRow<0>(a_out.lengths(), row, ns::Begin(a_out), ns::Begin(a_in));
+  }
+
+  /// a_out(i...) = a_fn(a_0(i...), a_1(i...)) for every element.
+  template<typename T, typename U, typename V, size_t Dimensions, typename Fn>
+  void Zip(HyperArrayView<T, Dimensions> const & a_out,
+           HyperArrayView<U, Dimensions> const & a_0,
+           HyperArrayView<V, Dimensions> const & a_1,
+           Fn a_fn)
+  {
+    namespace ns = impl::HyperArrayView;
+    ns::CheckLengths(a_out, a_0);
+    ns::CheckLengths(a_out, a_1);
+
+    auto row = [&a_fn](size_t a_n, ns::Cursor<T, Dimensions> a_o, ns::Cursor<U, Dimensions> a_c0, ns::Cursor<V, Dimensions> a_c1)
+    {
+      ptrdiff_t so = a_o.InnerStride();
+      ptrdiff_t s0 = a_c0.InnerStride();
+      ptrdiff_t s1 = a_c1.InnerStride();
+      T * pOut = a_o.pData;
+      U * p0 = a_c0.pData;
+      V * p1 = a_c1.pData;
+      if (so == 1 && s0 == 1 && s1 == 1)
+      {
+        for (size_t k = 0; k < a_n; k++)
+        {
+          pOut[k] = a_fn(p0[k], p1[k]);
+        }
+      }
+      else
+      {
+        for (size_t k = 0; k < a_n; k++)
+        {
+          ptrdiff_t ks = static_cast<ptrdiff_t>(k);
+          pOut[ks * so] = a_fn(p0[ks * s0], p1[ks * s1]);
+        }
+      }
+    };
+
+    ns::ForEachRow<0>(a_out.lengths(), row, ns::Begin(a_out), ns::Begin(a_0), ns::Begin(a_1));
+  }
+
+  /// Folds every element into an accumulator: acc = a_fn(acc, a_in(i...)).
+  ///
+  /// When R is the element type, contiguous rows are folded into several
+  /// independent accumulators which are combined at the end of the row, so the
+  /// loop is not one long dependency chain and the compiler can vectorize it.
+  /// This changes the order of evaluation, so a_fn must then be associative and
+  /// commutative, as for ParallelReduce(). Other rows are folded in order.
+  template<typename R, typename T, size_t Dimensions, typename Fn>
+  R Reduce(HyperArrayView<T, Dimensions> const & a_in, R a_init, Fn a_fn)
+  {
+    namespace ns = impl::HyperArrayView;
+
+    R acc = a_init;
+    auto row = [&acc, &a_fn](size_t a_n, ns::Cursor<T, Dimensions> a_c)
+    {
+      ptrdiff_t s = a_c.InnerStride();
+      T * p = a_c.pData;
+      R rowAcc = acc;
+      if (s == 1)
+      {
+        size_t k = 0;
+        if constexpr (std::is_same<R, typename std::remove_cv<T>::type>::value)
+        {
+          size_t const lanes = 4;
+          if (a_n >= 2 * lanes)
+          {
+            R lane[lanes];
+            for (size_t j = 0; j < lanes; j++)
+            {
+              lane[j] = p[j];
+            }
+
+            for (k = lanes; k + lanes <= a_n; k += lanes)
+            {
+              for (size_t j = 0; j < lanes; j++)
+              {
+                lane[j] = a_fn(lane[j], p[k + j]);
+              }
+            }
+
+            R combined = lane[0];
+            for (size_t j = 1; j < lanes; j++)
+            {
+              combined = a_fn(combined, lane[j]);
+            }
+            rowAcc = a_fn(rowAcc, combined);
+          }
+        }
+
+        for (; k < a_n; k++)
+        {
+          rowAcc = a_fn(rowAcc, p[k]);
+        }
+      }
+      else
+      {
+        for (size_t k = 0; k < a_n; k++)
+        {
+          rowAcc = a_fn(rowAcc, p[static_cast<ptrdiff_t>(k) * s]);
+        }
+      }
+      acc = rowAcc;
+    };
+
+    ns::ForEachRow<0>(a_in.lengths(), row, ns::Begin(a_in));
+    return acc;
+  }
+}
+
+#endif
@@ -0,0 +1,370 @@
+//@group Misc
+
+//! @file DgIDManager_AVL.h
+//!
+//! Class declaration: IDManager_AVL
+
+#ifndef DGIDMANAGER_AVL_H
+#define DGIDMANAGER_AVL_H
+
+#include "DgTree_AVL.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace IDManager_AVL
+    {
+      //! A range of available IDs, inclusive.
+      template<typename T>
+      struct Interval
+      {
+        T lower;
+        T upper;
+      };
+
+      template<typename T>
+      T GetLower(Interval<T> const & a_interval)
+      {
+        return a_interval.lower;
+      }
+    }
+  }
+
+  //! @ingroup DgUtility
+  //!
+  //! @class IDManager_AVL
+  //!
+  //! Same interface as IDManager, but the ranges of available IDs are stored in an
+  //! AVL tree keyed on the lower bound of each range. GetID, ReturnID, MarkAsUsed
+  //! and IsUsed are O(log n) in the number of ranges, so performance holds up when
+  //! the ID pool becomes heavily fragmented.
+  //!
+  //! Ranges are disjoint and never adjacent, so the bounds of a range can be
+  //! adjusted in place without breaking the ordering of the tree.
+  template<typename T>
+  class IDManager_AVL
+  {
+  public:
+
+    //! The default range will be simply 1
+    IDManager_AVL();
+
+    //! Construct the manager with a lower and upper limit to the ID pool
+    IDManager_AVL(T lower, T upper);
+
+    ~IDManager_AVL() {}
+    IDManager_AVL(IDManager_AVL<T> const &);
+    IDManager_AVL & operator=(IDManager_AVL<T> const &);
+
+    //! Initialize the ID manager with a lower and upper bound.
+    void Init(T lower, T upper);
+
+    //! Get the next available ID.
+    //!
+    //! @return 0 if no more IDs are available.
+    T GetID();
+
+    //! Get up to count available IDs, lowest first.
+    //!
+    //! @return The number of IDs written to pOut.
+    size_t GetIDs(T * pOut, size_t count);
+
+    //! Mark an ID as available.
+    void ReturnID(T);
+
+    //! Mark all IDs in the range [lower, upper] as available.
+    void ReturnIDs(T lower, T upper);
+
+    //! Mark an ID as in use.
+    //!
+    //! @return false if id already in use.
+    bool MarkAsUsed(T);
+
+    //! Check to see if an ID is in use.
+    bool IsUsed(T) const;
+
+  private:
+
+    typedef impl::IDManager_AVL::Interval<T> Interval;
+    typedef Tree_AVL<T, Interval, impl::IDManager_AVL::GetLower<T>> tree;
+    typedef typename tree::iterator iterator;
+
+    //! Returns the range containing the value, or end() if the value is not available.
+    iterator FindContaining(T) const;
+
+    tree      m_intervals;
+    Interval  m_bounds;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::IDManager_AVL()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  IDManager_AVL<T>::IDManager_AVL()
+  {
+    Init(static_cast<T>(1), static_cast<T>(1));
+  } //End: IDManager_AVL::IDManager_AVL()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::IDManager_AVL()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  IDManager_AVL<T>::IDManager_AVL(T a_lower, T a_upper)
+  {
+    Init(a_lower, a_upper);
+  } //End: IDManager_AVL::IDManager_AVL()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::IDManager_AVL()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  IDManager_AVL<T>::IDManager_AVL(IDManager_AVL<T> const & a_other)
+    : m_intervals(a_other.m_intervals)
+    , m_bounds(a_other.m_bounds)
+  {
+  } //End: IDManager_AVL::IDManager_AVL()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  IDManager_AVL<T> & IDManager_AVL<T>::operator=(IDManager_AVL<T> const & a_other)
+  {
+    if (this != &a_other)
+    {
+      m_intervals = a_other.m_intervals;
+      m_bounds = a_other.m_bounds;
+    }
+    return *this;
+  } //End: IDManager_AVL::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::Init()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void IDManager_AVL<T>::Init(T a_lower, T a_upper)
+  {
+    m_intervals.clear();
+    if (a_lower > a_upper) a_lower = a_upper;
+    m_bounds.lower = a_lower;
+    m_bounds.upper = a_upper;
+    m_intervals.insert(m_bounds);
+  } //End: IDManager_AVL::Init()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::FindContaining()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  typename IDManager_AVL<T>::iterator IDManager_AVL<T>::FindContaining(T a_val) const
+  {
+    iterator it = m_intervals.lower_bound(a_val);
+    if (it != const_cast<tree &>(m_intervals).end() && it->lower == a_val)
+      return it;
+
+    if (it == const_cast<tree &>(m_intervals).begin())
+      return const_cast<tree &>(m_intervals).end();
+
+    --it;
+    if (it->upper >= a_val)
+      return it;
+    return const_cast<tree &>(m_intervals).end();
+  } //End: IDManager_AVL::FindContaining()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::GetID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  T IDManager_AVL<T>::GetID()
+  {
+    if (m_intervals.empty())
+    {
+      return static_cast<T>(0);
+    }
+
+    iterator it = m_intervals.begin();
+    T result = it->lower;
+    if (it->lower == it->upper)
+      m_intervals.erase(it);
+    else
+      it->lower++;
+
+    return result;
+  } //End: IDManager_AVL::GetID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::GetIDs()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t IDManager_AVL<T>::GetIDs(T * a_pOut, size_t a_count)
+  {
+    size_t nIDs = 0;
+    while (nIDs < a_count && !m_intervals.empty())
+    {
+      iterator it = m_intervals.begin();
+      while (nIDs < a_count && it->lower != it->upper)
+      {
+        a_pOut[nIDs] = it->lower;
+        it->lower++;
+        nIDs++;
+      }
+
+      if (nIDs < a_count)
+      {
+        a_pOut[nIDs] = it->lower;
+        nIDs++;
+        m_intervals.erase(it);
+      }
+    }
+    return nIDs;
+  } //End: IDManager_AVL::GetIDs()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::ReturnID()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void IDManager_AVL<T>::ReturnID(T a_val)
+  {
+    //Check bounds
+    if (a_val < m_bounds.lower || a_val > m_bounds.upper)
+    {
+      return;
+    }
+
+    iterator it = m_intervals.lower_bound(a_val);
+    bool hasNext = (it != m_intervals.end());
+    if (hasNext && it->lower == a_val)
+      return;
+
+    iterator itp(it);
+    bool hasPrev = (it != m_intervals.begin());
+    if (hasPrev)
+    {
+      --itp;
+      if (itp->upper >= a_val)
+        return;
+    }
+
+    bool joinPrev = hasPrev && (itp->upper + static_cast<T>(1) == a_val);
+    bool joinNext = hasNext && (it->lower - static_cast<T>(1) == a_val);
+
+    if (joinPrev && joinNext)
+    {
+      itp->upper = it->upper;
+      m_intervals.erase(it);
+    }
+    else if (joinPrev)
+    {
+      itp->upper = a_val;
+    }
+    else if (joinNext)
+    {
+      it->lower = a_val;
+    }
+    else
+    {
+      m_intervals.insert(Interval{a_val, a_val});
+    }
+  } //End: IDManager_AVL::ReturnID()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::ReturnIDs()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void IDManager_AVL<T>::ReturnIDs(T a_lower, T a_upper)
+  {
+    if (a_lower < m_bounds.lower) a_lower = m_bounds.lower;
+    if (a_upper > m_bounds.upper) a_upper = m_bounds.upper;
+    if (a_lower > a_upper)
+      return;
+
+    //Absorb the range which overlaps or touches the lower end
+    iterator it = m_intervals.lower_bound(a_lower);
+    if (it != m_intervals.begin())
+    {
+      --it;
+      if (it->upper >= a_lower || it->upper + static_cast<T>(1) == a_lower)
+      {
+        a_lower = it->lower;
+        if (it->upper > a_upper) a_upper = it->upper;
+        m_intervals.erase(it);
+      }
+    }
+
+    //Absorb all ranges which overlap or touch the new range
+    while (true)
+    {
+      it = m_intervals.lower_bound(a_lower);
+      if (it == m_intervals.end())
+        break;
+      if (it->lower > a_upper && (it->lower - a_upper) > static_cast<T>(1))
+        break;
+
+      if (it->upper > a_upper) a_upper = it->upper;
+      m_intervals.erase(it);
+    }
+
+    m_intervals.insert(Interval{a_lower, a_upper});
+  } //End: IDManager_AVL::ReturnIDs()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::MarkAsUsed()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool IDManager_AVL<T>::MarkAsUsed(T a_val)
+  {
+    iterator it = FindContaining(a_val);
+    if (it == m_intervals.end())
+      return false;
+
+    if (it->lower == it->upper)
+    {
+      m_intervals.erase(it);
+    }
+    else if (a_val == it->lower)
+    {
+      it->lower++;
+    }
+    else if (a_val == it->upper)
+    {
+      it->upper--;
+    }
+    else
+    {
+      //Inserting can move nodes in memory, so finish with the iterator first.
+      T upper = it->upper;
+      it->upper = a_val - static_cast<T>(1);
+      m_intervals.insert(Interval{a_val + static_cast<T>(1), upper});
+    }
+    return true;
+  } //End: IDManager_AVL::MarkAsUsed()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ IDManager_AVL::IsUsed()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool IDManager_AVL<T>::IsUsed(T a_val) const
+  {
+    //Check bounds
+    if (a_val < m_bounds.lower || a_val > m_bounds.upper)
+    {
+      return false;
+    }
+
+    return FindContaining(a_val) == const_cast<tree &>(m_intervals).end();
+  } //End: IDManager_AVL::IsUsed()
+}
+
+#endif
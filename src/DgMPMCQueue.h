@@ -0,0 +1,354 @@
+//@group Collections
+
+//! @file DgMPMCQueue.h
+//!
+//! Class declaration: MPMCQueue
+
+#ifndef DGMPMCQUEUE_H
+#define DGMPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class MPMCQueue
+  //!
+  //! Bounded, lock-free queue for any number of producer and consumer threads.
+  //!
+  //! This is Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence
+  //! number which tells a producer whether the cell is free for the current lap
+  //! of the ring, and a consumer whether it has been filled. Producers and
+  //! consumers contend only on their own position counter, each on its own cache
+  //! line, and on the cell they are claiming; there is no shared lock.
+  //!
+  //! The capacity is rounded up to a power of two, with a minimum of 2.
+  template<typename T>
+  class MPMCQueue
+  {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    MPMCQueue(MPMCQueue const &) = delete;
+    MPMCQueue & operator=(MPMCQueue const &) = delete;
+
+  public:
+
+    MPMCQueue(size_t capacity);
+    ~MPMCQueue();
+
+    //! Returns false if the queue is full.
+    bool try_push(T const &);
+
+    //! Returns false if the queue is full.
+    bool try_push(T &&);
+
+    //! Returns false if the queue is empty.
+    bool try_pop(T &);
+
+    //! Pushes items in order until the queue is full.
+    //! @return Number of items pushed.
+    size_t try_push_n(T const * pItems, size_t count);
+
+    //! Pops items until count items have been popped or the queue is empty.
+    //! @return Number of items popped.
+    size_t try_pop_n(T * pOut, size_t count);
+
+    //! Blocks until the item has been pushed. Spins briefly, then yields.
+    void push(T const &);
+
+    //! Blocks until an item has been popped. Spins briefly, then yields.
+    void pop(T &);
+
+    //! Snapshot of the number of items; may be stale by the time it is used.
+    size_t size_approx() const;
+
+    size_t capacity() const;
+
+  private:
+
+    struct Cell
+    {
+      std::atomic<size_t> sequence;
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+      T * Get()
+      {
+        return reinterpret_cast<T *>(&storage);
+      }
+    };
+
+    //! Claims a cell to write into, or returns nullptr if the queue is full.
+    Cell * ClaimPush(size_t & pos);
+
+    //! Claims a cell to read from, or returns nullptr if the queue is empty.
+    Cell * ClaimPop(size_t & pos);
+
+    static void Backoff(uint32_t & spins);
+
+  private:
+
+    static size_t const s_cacheLineSize = 64;
+    static uint32_t const s_spinLimit = 64;
+
+    alignas(s_cacheLineSize) Cell *   m_pCells;
+    size_t                            m_mask;
+    alignas(s_cacheLineSize) std::atomic<size_t> m_enqueuePos;
+    alignas(s_cacheLineSize) std::atomic<size_t> m_dequeuePos;
+    char                              m_pad[s_cacheLineSize - sizeof(std::atomic<size_t>)];
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::MPMCQueue()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  MPMCQueue<T>::MPMCQueue(size_t a_capacity)
+    : m_pCells(nullptr)
+    , m_mask(0)
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+  {
+    size_t cap = 2;
+    while (cap < a_capacity)
+      cap <<= 1;
+
+    m_pCells = static_cast<Cell *>(malloc(cap * sizeof(Cell)));
+    if (m_pCells == nullptr)
+      throw std::bad_alloc();
+
+    for (size_t i = 0; i < cap; i++)
+      new (&m_pCells[i].sequence) std::atomic<size_t>(i);
+
+    m_mask = cap - 1;
+  } //End: MPMCQueue::MPMCQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::~MPMCQueue()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  MPMCQueue<T>::~MPMCQueue()
+  {
+    size_t pos;
+    Cell * pCell;
+    while ((pCell = ClaimPop(pos)) != nullptr)
+      pCell->Get()->~T();
+    free(m_pCells);
+  } //End: MPMCQueue::~MPMCQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::capacity()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t MPMCQueue<T>::capacity() const
+  {
+    return m_mask + 1;
+  } //End: MPMCQueue::capacity()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::size_approx()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t MPMCQueue<T>::size_approx() const
+  {
+    size_t enq = m_enqueuePos.load(std::memory_order_relaxed);
+    size_t deq = m_dequeuePos.load(std::memory_order_relaxed);
+    return enq > deq ? enq - deq : 0;
+  } //End: MPMCQueue::size_approx()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::ClaimPush()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  typename MPMCQueue<T>::Cell * MPMCQueue<T>::ClaimPush(size_t & a_pos)
+  {
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell * pCell = &m_pCells[pos & m_mask];
+      size_t seq = pCell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          a_pos = pos;
+          return pCell;
+        }
+      }
+      else if (diff < 0)
+      {
+        //The cell still holds an item from the previous lap.
+        return nullptr;
+      }
+      else
+      {
+        pos = m_enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  } //End: MPMCQueue::ClaimPush()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::ClaimPop()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  typename MPMCQueue<T>::Cell * MPMCQueue<T>::ClaimPop(size_t & a_pos)
+  {
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell * pCell = &m_pCells[pos & m_mask];
+      size_t seq = pCell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          a_pos = pos;
+          return pCell;
+        }
+      }
+      else if (diff < 0)
+      {
+        //The cell has not been filled yet.
+        return nullptr;
+      }
+      else
+      {
+        pos = m_dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  } //End: MPMCQueue::ClaimPop()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::try_push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool MPMCQueue<T>::try_push(T const & a_item)
+  {
+    size_t pos;
+    Cell * pCell = ClaimPush(pos);
+    if (pCell == nullptr)
+      return false;
+
+    new (pCell->Get()) T(a_item);
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  } //End: MPMCQueue::try_push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::try_push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool MPMCQueue<T>::try_push(T && a_item)
+  {
+    size_t pos;
+    Cell * pCell = ClaimPush(pos);
+    if (pCell == nullptr)
+      return false;
+
+    new (pCell->Get()) T(std::move(a_item));
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  } //End: MPMCQueue::try_push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::try_pop()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool MPMCQueue<T>::try_pop(T & a_out)
+  {
+    size_t pos;
+    Cell * pCell = ClaimPop(pos);
+    if (pCell == nullptr)
+      return false;
+
+    T * pItem = pCell->Get();
+    a_out = std::move(*pItem);
+    pItem->~T();
+    pCell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  } //End: MPMCQueue::try_pop()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::try_push_n()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t MPMCQueue<T>::try_push_n(T const * a_pItems, size_t a_count)
+  {
+    size_t n = 0;
+    while (n < a_count && try_push(a_pItems[n]))
+      n++;
+    return n;
+  } //End: MPMCQueue::try_push_n()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::try_pop_n()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t MPMCQueue<T>::try_pop_n(T * a_pOut, size_t a_count)
+  {
+    size_t n = 0;
+    while (n < a_count && try_pop(a_pOut[n]))
+      n++;
+    return n;
+  } //End: MPMCQueue::try_pop_n()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::Backoff()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void MPMCQueue<T>::Backoff(uint32_t & a_spins)
+  {
+    if (a_spins < s_spinLimit)
+    {
+      a_spins++;
+      return;
+    }
+    std::this_thread::yield();
+  } //End: MPMCQueue::Backoff()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void MPMCQueue<T>::push(T const & a_item)
+  {
+    uint32_t spins = 0;
+    while (!try_push(a_item))
+      Backoff(spins);
+  } //End: MPMCQueue::push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ MPMCQueue::pop()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void MPMCQueue<T>::pop(T & a_out)
+  {
+    uint32_t spins = 0;
+    while (!try_pop(a_out))
+      Backoff(spins);
+  } //End: MPMCQueue::pop()
+}
+
+#endif
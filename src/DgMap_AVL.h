@@ -16,8 +16,8 @@ namespace Dg
     U _Map_AVL_GetKey(T const &kv) { return kv.first; }
   }
 
-  template<typename KeyType, typename ValueType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>>
-  class _Map_AVL : public Tree_AVL<KeyType, ValueType, impl::_Map_AVL_GetKey<ValueType, KeyType>, Compare>
+  template<typename KeyType, typename ValueType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>, typename POOL = PoolSizeMngr_Default>
+  class _Map_AVL : public Tree_AVL<KeyType, ValueType, impl::_Map_AVL_GetKey<ValueType, KeyType>, Compare, POOL>
   {
   public:
 
@@ -54,8 +54,8 @@ namespace Dg
     }
   };
 
-  template<typename KeyType, typename ValueType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>>
-  using Map_AVL = _Map_AVL<KeyType, ::Dg::Pair<KeyType const, ValueType>, Compare>;
+  template<typename KeyType, typename ValueType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>, typename POOL = PoolSizeMngr_Default>
+  using Map_AVL = _Map_AVL<KeyType, ::Dg::Pair<KeyType const, ValueType>, Compare, POOL>;
 }
 
 #endif
\ No newline at end of file
@@ -18,6 +18,7 @@
 
 #include "DgPair.h"
 #include "impl/DgPoolSizeManager.h"
+#include "impl/DgContainerStats.h"
 #include "DgBit.h"
 
 namespace Dg
@@ -96,7 +97,8 @@ namespace Dg
   template<typename K, 
            typename V, 
            class HASHER = impl::OpenHashMap::SimpleHasher<K>, 
-           class EQUALTO = impl::OpenHashMap::EqualTo<K>>
+           class EQUALTO = impl::OpenHashMap::EqualTo<K>,
+           typename POOL = PoolSizeMngr_Prime>
   class OpenHashMap
   {
   private:
@@ -262,6 +264,14 @@ namespace Dg
     //Will choose the closest prime equal to or larger than input.
     void set_buckets(size_t bucketCount);
 
+    //! Rehash to the fewest buckets which hold the current items under the
+    //! max load factor. Invalidates iterators.
+    void shrink_to_fit();
+
+    //! Memory and occupancy snapshot, including a histogram of chain lengths.
+    //! Walks every bucket, so this is O(bucket_count + size).
+    ContainerStats GetStats() const;
+
     //Debug
     //void Print();
 
@@ -271,7 +281,7 @@ namespace Dg
     static bool IsValidLoadFactor(myFloat);
 
     //Assumes valid bucketCount and loadFactor
-    void Rehash(PoolSizeMngr_Prime, myFloat loadFactor);
+    void Rehash(POOL, myFloat loadFactor);
     void DestructAll(); //Destructs all objects, retains memory
     void FreeMemory();  //Destructs and frees memory
     
@@ -295,7 +305,7 @@ namespace Dg
     HASHER             m_hasher;
     EQUALTO            m_equalTo;
 
-    PoolSizeMngr_Prime m_poolSizeMngr;
+    POOL m_poolSizeMngr;
     DataNode *         m_pDataNodes;
     NodeIndex          m_nextFreeIndex;
                        
@@ -306,129 +316,129 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // const_iterator
   //------------------------------------------------------------------------------------------------
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::const_iterator(DataNode const* a_pNode)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::const_iterator(DataNode const* a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::const_iterator()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::const_iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::~const_iterator()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::const_iterator(const_iterator const& a_it)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::const_iterator(const_iterator const& a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator=(const_iterator const& a_it)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator=(const_iterator const& a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator==(const_iterator const& a_it) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator==(const_iterator const& a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator!=(const_iterator const& a_it) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator!=(const_iterator const& a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator+(size_t a_val) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator+(size_t a_val) const
   {
     DataNode const * pNode = m_pNode + a_val;
     return const_iterator(pNode);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator-(size_t a_val) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator-(size_t a_val) const
   {
     DataNode const * pNode = m_pNode - a_val;
     return const_iterator(pNode);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator+=(size_t a_val)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator+=(size_t a_val)
   {
     m_pNode += a_val;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator-=(size_t a_val)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator-=(size_t a_val)
   {
     m_pNode -= a_val;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator++()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator++()
   {
     m_pNode++;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator++(int)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator--()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator--()
   {
     m_pNode--;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator--(int)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::ValueType const*
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator->() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::ValueType const*
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator->() const
   {
     return &(m_pNode->kv);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::ValueType const&
-    OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator::operator*() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::ValueType const&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator::operator*() const
   {
     return m_pNode->kv;
   }
@@ -436,136 +446,136 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // iterator
   //------------------------------------------------------------------------------------------------
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::iterator::iterator(DataNode* a_pNode)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::iterator(DataNode* a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::iterator::iterator()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::iterator::~iterator()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::iterator::iterator(iterator const& a_it)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::iterator(iterator const& a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator=(iterator const& a_it)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator=(iterator const& a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator==(iterator const& a_it) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator==(iterator const& a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator!=(iterator const& a_it) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator!=(iterator const& a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator+(size_t a_val) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator+(size_t a_val) const
   {
     DataNode * pNode = m_pNode + a_val;
     return iterator(pNode);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator-(size_t a_val) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator-(size_t a_val) const
   {
     DataNode* pNode = m_pNode - a_val;
     return iterator(pNode);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator+=(size_t a_val)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator+=(size_t a_val)
   {
     m_pNode += a_val;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator-=(size_t a_val)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator-=(size_t a_val)
   {
     m_pNode -= a_val;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator++()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator++()
   {
     m_pNode++;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator++(int)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator--()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator--()
   {
     m_pNode--;
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator--(int)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::ValueType*
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator->()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::ValueType*
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator->()
   {
     return &(m_pNode->kv);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::ValueType&
-    OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator*()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::ValueType&
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator*()
   {
     return m_pNode->kv;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::iterator::operator
-    typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator::operator
+    typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator() const
   {
     return const_iterator(m_pNode);
   }
@@ -575,8 +585,8 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
 
   //! Default constructor.
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::OpenHashMap()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::OpenHashMap()
     : m_maxLoadFactor(impl::OpenHashMap::defaultLoadFactor)
     , m_hasher()
     , m_equalTo()
@@ -590,8 +600,8 @@ namespace Dg
     InitMemory();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::OpenHashMap(size_t a_nBuckets,
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::OpenHashMap(size_t a_nBuckets,
                                                   HASHER const& a_hasher,
                                                   EQUALTO const& a_equalTo)
     : m_maxLoadFactor(impl::OpenHashMap::defaultLoadFactor)
@@ -603,19 +613,19 @@ namespace Dg
     , m_nItems(0)
     , m_pBuckets(nullptr)
   {
-    PoolSizeMngr_Prime psm(a_nBuckets);
+    POOL psm(a_nBuckets);
     set_buckets(psm, m_maxLoadFactor);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::~OpenHashMap()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::~OpenHashMap()
   {
     DestructAll();
     FreeMemory();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::OpenHashMap(OpenHashMap const& a_other)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::OpenHashMap(OpenHashMap const& a_other)
     : m_maxLoadFactor(impl::OpenHashMap::defaultLoadFactor)
     , m_hasher()
     , m_equalTo()
@@ -629,8 +639,8 @@ namespace Dg
   }
 
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO> & OpenHashMap<K, V, HASHER, EQUALTO>::operator=(OpenHashMap const& a_other)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL> & OpenHashMap<K, V, HASHER, EQUALTO, POOL>::operator=(OpenHashMap const& a_other)
   {
     if (this != &a_other)
     {
@@ -641,8 +651,8 @@ namespace Dg
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>::OpenHashMap(OpenHashMap && a_other) noexcept
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>::OpenHashMap(OpenHashMap && a_other) noexcept
     : m_maxLoadFactor(a_other.m_maxLoadFactor)
     , m_hasher(a_other.m_hasher)
     , m_equalTo(a_other.m_equalTo)
@@ -657,8 +667,8 @@ namespace Dg
     a_other.m_nItems = 0;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  OpenHashMap<K, V, HASHER, EQUALTO>& OpenHashMap<K, V, HASHER, EQUALTO>::operator=(OpenHashMap && a_other) noexcept
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  OpenHashMap<K, V, HASHER, EQUALTO, POOL>& OpenHashMap<K, V, HASHER, EQUALTO, POOL>::operator=(OpenHashMap && a_other) noexcept
   {
     if (this != &a_other)
     {
@@ -681,21 +691,21 @@ namespace Dg
     return *this;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  V & OpenHashMap<K, V, HASHER, EQUALTO>::operator[](K const & a_key)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  V & OpenHashMap<K, V, HASHER, EQUALTO, POOL>::operator[](K const & a_key)
   {
     return *insert(a_key, V());
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  size_t OpenHashMap<K, V, HASHER, EQUALTO>::Index(K const& a_key) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  size_t OpenHashMap<K, V, HASHER, EQUALTO, POOL>::Index(K const& a_key) const
   {
     return m_hasher(a_key) % m_poolSizeMngr.GetSize();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  Pair<bool , typename OpenHashMap<K, V, HASHER, EQUALTO>::NodeIndex>
-    OpenHashMap<K, V, HASHER, EQUALTO>::FindNode(K const& a_key) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  Pair<bool , typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::NodeIndex>
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::FindNode(K const& a_key) const
   {
     size_t index = Index(a_key);
     if (m_pBuckets[index].next.IsNull())
@@ -723,8 +733,8 @@ namespace Dg
     return Pair<bool, NodeIndex>{found, dataIndex};
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  V * OpenHashMap<K, V, HASHER, EQUALTO>::at(K const & a_key)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  V * OpenHashMap<K, V, HASHER, EQUALTO, POOL>::at(K const & a_key)
   {
     Pair<bool, NodeIndex> result = FindNode(a_key);
     if (!result.first)
@@ -732,8 +742,8 @@ namespace Dg
     return &(m_pDataNodes[result.second].kv.second);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  V const * OpenHashMap<K, V, HASHER, EQUALTO>::at(K const& a_key) const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  V const * OpenHashMap<K, V, HASHER, EQUALTO, POOL>::at(K const& a_key) const
   {
     Pair<bool, NodeIndex> result = FindNode(a_key);
     if (!result.first)
@@ -741,44 +751,44 @@ namespace Dg
     return &(m_pDataNodes[result.second].kv.second);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::begin()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::begin()
   {
     return iterator(m_pDataNodes);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::end()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::end()
   {
     return iterator(&m_pDataNodes[m_nItems]);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::cbegin() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::cbegin() const
   {
     return const_iterator(m_pDataNodes);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::const_iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::cend() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::const_iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::cend() const
   {
     return const_iterator(&m_pDataNodes[m_nItems]);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::iterator
-    OpenHashMap<K, V, HASHER, EQUALTO>::erase(iterator a_it)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::iterator
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::erase(iterator a_it)
   {
     EraseAtIndex(static_cast<size_t>(a_it.m_pNode - m_pDataNodes));
     return a_it;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  V* OpenHashMap<K, V, HASHER, EQUALTO>::insert(K const& a_key, V const& a_value)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  V* OpenHashMap<K, V, HASHER, EQUALTO, POOL>::insert(K const& a_key, V const& a_value)
    {
     Pair<bool, NodeIndex> result = FindNode(a_key);
     if (result.first)
@@ -786,7 +796,7 @@ namespace Dg
 
     if ((m_nItems + 1) >= DataPoolSize())
     {
-      PoolSizeMngr_Prime psm(m_poolSizeMngr);
+      POOL psm(m_poolSizeMngr);
       psm.SetNextPoolSize();
       Rehash(psm, m_maxLoadFactor);
       result.~Pair<bool, NodeIndex>();
@@ -810,8 +820,8 @@ namespace Dg
     return &m_pDataNodes[newNode].kv.second;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::EraseAtIndex(size_t a_index)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::EraseAtIndex(size_t a_index)
   {
     m_pDataNodes[a_index].kv.~ValueType();
 
@@ -850,8 +860,8 @@ namespace Dg
     m_nItems--;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::erase(K const& a_key)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::erase(K const& a_key)
   {
     Pair<bool, NodeIndex> result = FindNode(a_key);
     if (!result.first)
@@ -860,55 +870,88 @@ namespace Dg
     EraseAtIndex(static_cast<size_t>(result.second.GetIndex()));
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  size_t OpenHashMap<K, V, HASHER, EQUALTO>::size() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  size_t OpenHashMap<K, V, HASHER, EQUALTO, POOL>::size() const
   {
     return m_nItems;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  size_t OpenHashMap<K, V, HASHER, EQUALTO>::bucket_count() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  size_t OpenHashMap<K, V, HASHER, EQUALTO, POOL>::bucket_count() const
   {
     return m_poolSizeMngr.GetSize();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::clear()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  ContainerStats OpenHashMap<K, V, HASHER, EQUALTO, POOL>::GetStats() const
+  {
+    size_t nBuckets = bucket_count();
+    size_t nNodes = DataPoolSize();
+
+    ContainerStats stats;
+    stats.elementCount = m_nItems;
+    stats.capacity = nNodes - 1;
+    stats.bytesReserved = nBuckets * sizeof(BucketNode) + nNodes * sizeof(DataNode);
+    stats.bytesUsed = nBuckets * sizeof(BucketNode) + m_nItems * sizeof(DataNode);
+    stats.poolSizeIndex = m_poolSizeMngr.GetIndex();
+    stats.poolResizes = m_poolSizeMngr.GetResizeCount();
+
+    for (size_t i = 0; i < nBuckets; i++)
+    {
+      size_t length = 0;
+      NodeIndex index = m_pBuckets[i].next;
+      while (!index.IsNull())
+      {
+        length++;
+        index = m_pDataNodes[index.GetIndex()].next;
+      }
+
+      if (length > stats.longestChain)
+        stats.longestChain = length;
+      if (length >= ContainerStats::s_chainHistogramSize)
+        length = ContainerStats::s_chainHistogramSize - 1;
+      stats.chainLengths[length]++;
+    }
+    return stats;
+  }
+
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::clear()
   {
     DestructAll();
     InitMemory();
     m_nItems = 0;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::empty() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::empty() const
   {
     return m_nItems == 0;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::myFloat
-    OpenHashMap<K, V, HASHER, EQUALTO>::load_factor() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::myFloat
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::load_factor() const
   {
     return static_cast<myFloat>(m_nItems) / bucket_count();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  typename OpenHashMap<K, V, HASHER, EQUALTO>::myFloat
-    OpenHashMap<K, V, HASHER, EQUALTO>::max_load_factor() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  typename OpenHashMap<K, V, HASHER, EQUALTO, POOL>::myFloat
+    OpenHashMap<K, V, HASHER, EQUALTO, POOL>::max_load_factor() const
   {
     return m_maxLoadFactor;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  bool OpenHashMap<K, V, HASHER, EQUALTO>::IsValidLoadFactor(myFloat a_lf)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  bool OpenHashMap<K, V, HASHER, EQUALTO, POOL>::IsValidLoadFactor(myFloat a_lf)
   {
     return ((a_lf >= impl::OpenHashMap::loadFactorBounds[0]) 
          && (a_lf <= impl::OpenHashMap::loadFactorBounds[1]));
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::set_max_load_factor(myFloat a_loadFactor)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::set_max_load_factor(myFloat a_loadFactor)
   {
     if (!IsValidLoadFactor(a_loadFactor))
       return;
@@ -916,10 +959,10 @@ namespace Dg
     Rehash(m_poolSizeMngr, a_loadFactor);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::set_buckets(size_t a_bucketCount)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::set_buckets(size_t a_bucketCount)
   {
-    PoolSizeMngr_Prime psm(a_bucketCount);
+    POOL psm(a_bucketCount);
 
     myFloat newLoadFactor = static_cast<myFloat>(m_nItems) / static_cast<myFloat>(psm.GetSize());
     if (newLoadFactor > m_maxLoadFactor)
@@ -928,8 +971,22 @@ namespace Dg
     Rehash(psm, m_maxLoadFactor);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  size_t OpenHashMap<K, V, HASHER, EQUALTO>::DataPoolSize(size_t a_bucketCount, myFloat a_maxLoadFactor)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::shrink_to_fit()
+  {
+    //Fewest buckets which hold the current items, with room for one more,
+    //under the max load factor.
+    POOL psm(m_poolSizeMngr);
+    psm.SetSize(static_cast<size_t>(static_cast<myFloat>(m_nItems) / m_maxLoadFactor));
+    while (DataPoolSize(psm.GetSize(), m_maxLoadFactor) <= m_nItems + 1 && psm.GetSize() < bucket_count())
+      psm.SetNextPoolSize();
+
+    if (psm.GetSize() < bucket_count())
+      Rehash(psm, m_maxLoadFactor);
+  }
+
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  size_t OpenHashMap<K, V, HASHER, EQUALTO, POOL>::DataPoolSize(size_t a_bucketCount, myFloat a_maxLoadFactor)
   {
     myFloat arraySize_float = static_cast<myFloat>(a_bucketCount) * a_maxLoadFactor;
 
@@ -944,14 +1001,14 @@ namespace Dg
     return arraySize_int;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  size_t OpenHashMap<K, V, HASHER, EQUALTO>::DataPoolSize() const
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  size_t OpenHashMap<K, V, HASHER, EQUALTO, POOL>::DataPoolSize() const
   {
     return DataPoolSize(bucket_count(), max_load_factor());
   }
 
   //template<typename K, typename V, class HASHER, class EQUALTO>
-  //void OpenHashMap<K, V, HASHER, EQUALTO>::Print()
+  //void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::Print()
   //{
   //  std::cout << "item count: " << size() << '\n';
   //  std::cout << "bucket count: " << bucket_count() << "\n";
@@ -986,8 +1043,8 @@ namespace Dg
   //  std::cout << "\n\n";
   //}
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::AllocateMemory()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::AllocateMemory()
   {
     BucketNode* pNewBucketArray = static_cast<BucketNode*>(malloc(bucket_count() * sizeof(BucketNode)));
     DataNode* pNewDataArray = static_cast<DataNode*>(malloc(DataPoolSize() * sizeof(DataNode)));
@@ -1003,8 +1060,8 @@ namespace Dg
     m_pDataNodes = pNewDataArray;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::Rehash(PoolSizeMngr_Prime a_bucketCount, myFloat a_maxLoadFactor)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::Rehash(POOL a_bucketCount, myFloat a_maxLoadFactor)
   {
     size_t arraySize = DataPoolSize(a_bucketCount.GetSize(), a_maxLoadFactor);
 
@@ -1016,7 +1073,7 @@ namespace Dg
     BucketNode* old_pBuckets = m_pBuckets;
     DataNode* old_pDataNodes = m_pDataNodes;
     myFloat old_maxLoadFactor = m_maxLoadFactor;
-    PoolSizeMngr_Prime old_poolSizeMngr = m_poolSizeMngr;
+    POOL old_poolSizeMngr = m_poolSizeMngr;
 
     //Set new state
     m_pBuckets = nullptr;
@@ -1051,15 +1108,15 @@ namespace Dg
     free(old_pDataNodes);
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::DestructAll()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::DestructAll()
   {
     for (size_t i = 0; i < m_nItems; i++)
       m_pDataNodes[i].kv.~ValueType();
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::FreeMemory()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::FreeMemory()
   {
     free(m_pBuckets);
     free(m_pDataNodes);
@@ -1067,8 +1124,8 @@ namespace Dg
     m_pDataNodes = nullptr;
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::InitMemory()
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::InitMemory()
   {
     if (DataPoolSize() > 0 && m_pDataNodes != nullptr)
     {
@@ -1093,8 +1150,8 @@ namespace Dg
     }
   }
 
-  template<typename K, typename V, class HASHER, class EQUALTO>
-  void OpenHashMap<K, V, HASHER, EQUALTO>::Init(OpenHashMap const & a_other)
+  template<typename K, typename V, class HASHER, class EQUALTO, typename POOL>
+  void OpenHashMap<K, V, HASHER, EQUALTO, POOL>::Init(OpenHashMap const & a_other)
   {
     m_maxLoadFactor = a_other.m_maxLoadFactor;
     m_poolSizeMngr = a_other.m_poolSizeMngr;
@@ -0,0 +1,210 @@
+//@group Misc
+
+#ifndef DGPARALLELFOR_H
+#define DGPARALLELFOR_H
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <type_traits>
+
+#include "DgWorkerPool.h"
+#include "impl/DgWorkerPoolDispatch.h"
+
+namespace Dg
+{
+  // How the range of a ParallelFor or ParallelReduce is cut into chunks.
+  enum class ParallelSchedule
+  {
+    Static,   // One equal chunk per participating thread (never smaller than the grain)
+    Dynamic,  // Chunks of grain elements, handed out first come first served
+    Guided    // Chunks start large and shrink towards the grain as the range runs out
+  };
+
+  namespace impl
+  {
+    // Hands out chunks of [0, count) to any number of threads.
+    class ParallelRange
+    {
+    public:
+
+      void Init(size_t a_count, size_t a_grain, ParallelSchedule a_schedule, size_t a_participants)
+      {
+        m_next.store(0, std::memory_order_relaxed);
+        m_count = a_count;
+        m_grain = a_grain == 0 ? 1 : a_grain;
+        m_schedule = a_schedule;
+        m_participants = a_participants;
+
+        m_chunk = m_grain;
+        if (a_schedule == ParallelSchedule::Static)
+        {
+          size_t share = (a_count + a_participants - 1) / a_participants;
+          if (share > m_chunk)
+            m_chunk = share;
+        }
+      }
+
+      bool Next(size_t & a_begin, size_t & a_end)
+      {
+        if (m_schedule == ParallelSchedule::Guided)
+        {
+          size_t begin = m_next.load(std::memory_order_relaxed);
+          size_t size;
+          do
+          {
+            if (begin >= m_count)
+              return false;
+            size = (m_count - begin) / (2 * m_participants);
+            if (size < m_grain)
+              size = m_grain;
+          } while (!m_next.compare_exchange_weak(begin, begin + size, std::memory_order_relaxed));
+
+          a_begin = begin;
+          a_end = (m_count - begin) < size ? m_count : begin + size;
+          return true;
+        }
+
+        size_t begin = m_next.fetch_add(m_chunk, std::memory_order_relaxed);
+        if (begin >= m_count)
+          return false;
+
+        a_begin = begin;
+        a_end = (m_count - begin) < m_chunk ? m_count : begin + m_chunk;
+        return true;
+      }
+
+      // Upper bound on the number of chunks.
+      size_t MaxChunks() const
+      {
+        return (m_count + m_grain - 1) / m_grain;
+      }
+
+    private:
+
+      std::atomic<size_t> m_next;
+      size_t              m_count;
+      size_t              m_grain;
+      size_t              m_chunk;
+      size_t              m_participants;
+      ParallelSchedule    m_schedule;
+    };
+
+    // Runs a_body over [0, a_count) on the pool and the calling thread.
+    // Body::Run(ParallelRange &) is called once per participating thread and
+    // should take chunks until the range is exhausted.
+    template<typename Body>
+    void ParallelRun(WorkerPool & a_pool, size_t a_count, size_t a_grain, ParallelSchedule a_schedule, Body & a_body)
+    {
+      if (a_count == 0)
+        return;
+
+      size_t participants = (size_t)a_pool.GetThreadCount() + 1;
+
+      ParallelRange range;
+      range.Init(a_count, a_grain, a_schedule, participants);
+
+      // The calling thread takes a share of the work, so one task fewer is needed.
+      size_t nTasks = range.MaxChunks() - 1;
+      if (nTasks > participants - 1)
+        nTasks = participants - 1;
+
+      auto work = [&a_body, &range]() { a_body.Run(range); };
+      DispatchWork(a_pool, nTasks, work);
+    }
+
+    template<typename Index, typename Fn>
+    struct ParallelForBody
+    {
+      Index       begin;
+      Fn const *  pFn;
+
+      void Run(ParallelRange & a_range)
+      {
+        size_t b, e;
+        while (a_range.Next(b, e))
+        {
+          for (size_t i = b; i < e; i++)
+            (*pFn)(static_cast<Index>(begin + static_cast<Index>(i)));
+        }
+      }
+    };
+
+    template<typename T, typename Index, typename MapFn, typename ReduceFn>
+    struct ParallelReduceBody
+    {
+      Index             begin;
+      T const *         pIdentity;
+      MapFn const *     pMap;
+      ReduceFn const *  pReduce;
+      T                 result;
+      std::mutex        mutex;
+
+      void Run(ParallelRange & a_range)
+      {
+        T partial(*pIdentity);
+        bool any = false;
+
+        size_t b, e;
+        while (a_range.Next(b, e))
+        {
+          any = true;
+          for (size_t i = b; i < e; i++)
+            partial = (*pReduce)(partial, (*pMap)(static_cast<Index>(begin + static_cast<Index>(i))));
+        }
+
+        // One lock per thread, not per chunk.
+        if (any)
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          result = (*pReduce)(result, partial);
+        }
+      }
+    };
+  }
+
+  // Calls a_fn(i) for every i in [a_begin, a_end), spread across the pool and
+  // the calling thread, and returns once every call has finished. a_grain is
+  // the smallest number of consecutive indices handed to a thread at once.
+  // There is no heap allocation per chunk.
+  //
+  // May be called from a pool task: while waiting, the caller runs other
+  // queued tasks rather than blocking a worker.
+  template<typename Index, typename Fn>
+  void ParallelFor(WorkerPool & a_pool, Index a_begin, Index a_end, size_t a_grain, Fn const & a_fn,
+                   ParallelSchedule a_schedule = ParallelSchedule::Dynamic)
+  {
+    static_assert(std::is_integral<Index>::value, "ParallelFor requires an integral index");
+
+    if (!(a_begin < a_end))
+      return;
+
+    impl::ParallelForBody<Index, Fn> body;
+    body.begin = a_begin;
+    body.pFn = &a_fn;
+    impl::ParallelRun(a_pool, static_cast<size_t>(a_end - a_begin), a_grain, a_schedule, body);
+  }
+
+  // Returns a_reduce applied over a_map(i) for every i in [a_begin, a_end),
+  // starting from a_identity. Each thread reduces its chunks into a private
+  // partial result; the partials are then combined. The order in which values
+  // are combined is not fixed, so a_reduce should be associative and commutative.
+  //
+  // Same threading rules as ParallelFor().
+  template<typename T, typename Index, typename MapFn, typename ReduceFn>
+  T ParallelReduce(WorkerPool & a_pool, Index a_begin, Index a_end, size_t a_grain, T const & a_identity,
+                   MapFn const & a_map, ReduceFn const & a_reduce,
+                   ParallelSchedule a_schedule = ParallelSchedule::Dynamic)
+  {
+    static_assert(std::is_integral<Index>::value, "ParallelReduce requires an integral index");
+
+    if (!(a_begin < a_end))
+      return a_identity;
+
+    impl::ParallelReduceBody<T, Index, MapFn, ReduceFn> body{a_begin, &a_identity, &a_map, &a_reduce, a_identity, {}};
+    impl::ParallelRun(a_pool, static_cast<size_t>(a_end - a_begin), a_grain, a_schedule, body);
+    return body.result;
+  }
+}
+
+#endif
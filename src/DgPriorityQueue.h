@@ -0,0 +1,568 @@
+//@group Collections
+
+//! @file DgPriorityQueue.h
+//!
+//! Class declaration: PriorityQueue
+
+#ifndef DGPRIORITYQUEUE_H
+#define DGPRIORITYQUEUE_H
+
+#include <stdexcept>
+#include <utility>
+
+#include "DgDynamicArray.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace PriorityQueue
+    {
+      template<typename K>
+      bool Less(K const & a_k0, K const & a_k1)
+      {
+        return a_k0 < a_k1;
+      }
+
+      template<typename K, typename V, bool TRACK_HANDLES>
+      struct Entry
+      {
+        K key;
+        V value;
+      };
+
+      template<typename K, typename V>
+      struct Entry<K, V, true>
+      {
+        K key;
+        V value;
+        size_t handle;
+      };
+    }
+  }
+
+  //! @ingroup DgContainers
+  //!
+  //! @class PriorityQueue
+  //!
+  //! Priority queue built on a D-ary heap stored in a contiguous DynamicArray.
+  //! The element at the top is the one for which Compare(key, other) holds
+  //! against every other key; with the default comparator this is the smallest.
+  //!
+  //! A wider heap (larger D) is shallower, so push and decrease_key do fewer
+  //! steps, at the cost of comparing more children when sifting down in pop.
+  //! D = 4 is a good default.
+  //!
+  //! If TRACK_HANDLES is true, push returns a handle which stays valid until the
+  //! element leaves the queue. Handles can be used to read, re-key or erase the
+  //! element in O(log n). Tracking costs one extra index per element; when it is
+  //! off, push returns INVALID_HANDLE and the handle methods are unavailable.
+  //!
+  //! As with DynamicArray, elements are relocated with memcpy.
+  template<typename K,
+           typename V,
+           size_t D = 4,
+           bool TRACK_HANDLES = false,
+           bool (*Compare)(K const &, K const &) = impl::PriorityQueue::Less<K>>
+  class PriorityQueue
+  {
+    static_assert(D >= 2, "PriorityQueue arity must be at least 2");
+
+  public:
+
+    typedef size_t Handle;
+    static constexpr Handle INVALID_HANDLE = static_cast<Handle>(-1);
+
+  public:
+
+    PriorityQueue();
+    ~PriorityQueue() {}
+
+    PriorityQueue(PriorityQueue const &);
+    PriorityQueue & operator=(PriorityQueue const &);
+
+    PriorityQueue(PriorityQueue &&) noexcept;
+    PriorityQueue & operator=(PriorityQueue &&) noexcept;
+
+    //! Add an element. O(log n).
+    //! @return A handle to the element if TRACK_HANDLES is set, otherwise INVALID_HANDLE.
+    Handle push(K const &, V const &);
+
+    //! Remove the top element. Calling this on an empty queue is undefined.
+    void pop();
+
+    //! Calling these on an empty queue is undefined.
+    K const & top_key() const;
+    V const & top_value() const;
+    V & top_value();
+
+    //! Replace the contents with count elements in O(count).
+    //! If TRACK_HANDLES is set, element i is given handle i.
+    void heapify(K const * pKeys, V const * pValues, size_t count);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+    void reserve(size_t);
+
+    //! Is the handle attached to an element in the queue?
+    bool contains(Handle) const;
+
+    K const & key(Handle) const;
+    V & value(Handle);
+    V const & value(Handle) const;
+
+    //! Give an element a key closer to the top. O(log n).
+    //! The new key must not compare worse than the current key.
+    void decrease_key(Handle, K const &);
+
+    //! Give an element any new key. O(log n).
+    void update_key(Handle, K const &);
+
+    //! Remove an element. O(log n).
+    void erase(Handle);
+
+  private:
+
+    typedef impl::PriorityQueue::Entry<K, V, TRACK_HANDLES> Entry;
+
+    static constexpr size_t INVALID_POSITION = static_cast<size_t>(-1);
+
+    void SiftUp(size_t);
+    void SiftDown(size_t);
+    void Place(size_t position, Entry const &);
+    void RemoveAt(size_t);
+    Handle NewHandle();
+    void CheckHandle(Handle) const;
+
+  private:
+
+    DynamicArray<Entry>   m_data;
+    DynamicArray<size_t>  m_positions;    //Heap position of each handle
+    DynamicArray<Handle>  m_freeHandles;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::PriorityQueue()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::PriorityQueue()
+  {
+
+  } //End: PriorityQueue::PriorityQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::PriorityQueue()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::PriorityQueue(PriorityQueue const & a_other)
+    : m_data(a_other.m_data)
+    , m_positions(a_other.m_positions)
+    , m_freeHandles(a_other.m_freeHandles)
+  {
+
+  } //End: PriorityQueue::PriorityQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  PriorityQueue<K, V, D, TRACK_HANDLES, Compare> & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::operator=(PriorityQueue const & a_other)
+  {
+    if (this != &a_other)
+    {
+      m_data = a_other.m_data;
+      m_positions = a_other.m_positions;
+      m_freeHandles = a_other.m_freeHandles;
+    }
+    return *this;
+  } //End: PriorityQueue::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::PriorityQueue()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::PriorityQueue(PriorityQueue && a_other) noexcept
+    : m_data(std::move(a_other.m_data))
+    , m_positions(std::move(a_other.m_positions))
+    , m_freeHandles(std::move(a_other.m_freeHandles))
+  {
+
+  } //End: PriorityQueue::PriorityQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  PriorityQueue<K, V, D, TRACK_HANDLES, Compare> & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::operator=(PriorityQueue && a_other) noexcept
+  {
+    if (this != &a_other)
+    {
+      m_data = std::move(a_other.m_data);
+      m_positions = std::move(a_other.m_positions);
+      m_freeHandles = std::move(a_other.m_freeHandles);
+    }
+    return *this;
+  } //End: PriorityQueue::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::size()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  size_t PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::size() const
+  {
+    return m_data.size();
+  } //End: PriorityQueue::size()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::empty()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  bool PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::empty() const
+  {
+    return m_data.empty();
+  } //End: PriorityQueue::empty()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::clear()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::clear()
+  {
+    m_data.clear();
+    m_positions.clear();
+    m_freeHandles.clear();
+  } //End: PriorityQueue::clear()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::reserve()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::reserve(size_t a_count)
+  {
+    m_data.reserve(a_count);
+    if constexpr (TRACK_HANDLES)
+      m_positions.reserve(a_count);
+  } //End: PriorityQueue::reserve()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::top_key()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  K const & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::top_key() const
+  {
+    return m_data[0].key;
+  } //End: PriorityQueue::top_key()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::top_value()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  V const & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::top_value() const
+  {
+    return m_data[0].value;
+  } //End: PriorityQueue::top_value()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::top_value()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  V & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::top_value()
+  {
+    return m_data[0].value;
+  } //End: PriorityQueue::top_value()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::Place()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::Place(size_t a_position, Entry const & a_entry)
+  {
+    m_data[a_position] = a_entry;
+    if constexpr (TRACK_HANDLES)
+      m_positions[a_entry.handle] = a_position;
+  } //End: PriorityQueue::Place()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::SiftUp()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::SiftUp(size_t a_position)
+  {
+    //Move the hole up rather than swapping at every level.
+    Entry entry = m_data[a_position];
+    while (a_position > 0)
+    {
+      size_t parent = (a_position - 1) / D;
+      if (!Compare(entry.key, m_data[parent].key))
+        break;
+      Place(a_position, m_data[parent]);
+      a_position = parent;
+    }
+    Place(a_position, entry);
+  } //End: PriorityQueue::SiftUp()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::SiftDown()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::SiftDown(size_t a_position)
+  {
+    size_t n = m_data.size();
+    Entry entry = m_data[a_position];
+    while (true)
+    {
+      size_t first = a_position * D + 1;
+      if (first >= n)
+        break;
+
+      size_t last = first + D;
+      if (last > n)
+        last = n;
+
+      size_t best = first;
+      for (size_t c = first + 1; c < last; c++)
+      {
+        if (Compare(m_data[c].key, m_data[best].key))
+          best = c;
+      }
+
+      if (!Compare(m_data[best].key, entry.key))
+        break;
+
+      Place(a_position, m_data[best]);
+      a_position = best;
+    }
+    Place(a_position, entry);
+  } //End: PriorityQueue::SiftDown()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::NewHandle()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  typename PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::Handle PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::NewHandle()
+  {
+    if (!m_freeHandles.empty())
+    {
+      Handle h = m_freeHandles.back();
+      m_freeHandles.pop_back();
+      return h;
+    }
+
+    m_positions.push_back(INVALID_POSITION);
+    return m_positions.size() - 1;
+  } //End: PriorityQueue::NewHandle()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::push()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  typename PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::Handle PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::push(K const & a_key, V const & a_value)
+  {
+    Entry entry;
+    entry.key = a_key;
+    entry.value = a_value;
+
+    Handle h = INVALID_HANDLE;
+    if constexpr (TRACK_HANDLES)
+    {
+      h = NewHandle();
+      entry.handle = h;
+      m_positions[h] = m_data.size();
+    }
+
+    m_data.push_back(entry);
+    SiftUp(m_data.size() - 1);
+    return h;
+  } //End: PriorityQueue::push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::RemoveAt()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::RemoveAt(size_t a_position)
+  {
+    if constexpr (TRACK_HANDLES)
+    {
+      Handle h = m_data[a_position].handle;
+      m_positions[h] = INVALID_POSITION;
+      m_freeHandles.push_back(h);
+    }
+
+    size_t last = m_data.size() - 1;
+    if (a_position != last)
+    {
+      Place(a_position, m_data[last]);
+      m_data.pop_back();
+
+      if (a_position > 0 && Compare(m_data[a_position].key, m_data[(a_position - 1) / D].key))
+        SiftUp(a_position);
+      else
+        SiftDown(a_position);
+    }
+    else
+    {
+      m_data.pop_back();
+    }
+  } //End: PriorityQueue::RemoveAt()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::pop()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::pop()
+  {
+    RemoveAt(0);
+  } //End: PriorityQueue::pop()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::heapify()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::heapify(K const * a_pKeys, V const * a_pValues, size_t a_count)
+  {
+    clear();
+
+    Entry * pEntries = m_data.append_uninitialized(a_count);
+    for (size_t i = 0; i < a_count; i++)
+    {
+      new (&pEntries[i]) Entry();
+      pEntries[i].key = a_pKeys[i];
+      pEntries[i].value = a_pValues[i];
+      if constexpr (TRACK_HANDLES)
+        pEntries[i].handle = i;
+    }
+
+    if constexpr (TRACK_HANDLES)
+    {
+      size_t * pPositions = m_positions.append_uninitialized(a_count);
+      for (size_t i = 0; i < a_count; i++)
+        pPositions[i] = i;
+    }
+
+    //Sift down every internal node, deepest first.
+    if (a_count > 1)
+    {
+      for (size_t i = (a_count - 2) / D + 1; i > 0; i--)
+        SiftDown(i - 1);
+    }
+  } //End: PriorityQueue::heapify()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::CheckHandle()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::CheckHandle(Handle a_handle) const
+  {
+    if (!contains(a_handle))
+      throw std::out_of_range("Invalid PriorityQueue handle");
+  } //End: PriorityQueue::CheckHandle()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::contains()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  bool PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::contains(Handle a_handle) const
+  {
+    static_assert(TRACK_HANDLES, "Handles require TRACK_HANDLES");
+    return a_handle < m_positions.size() && m_positions[a_handle] != INVALID_POSITION;
+  } //End: PriorityQueue::contains()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::key()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  K const & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::key(Handle a_handle) const
+  {
+    CheckHandle(a_handle);
+    return m_data[m_positions[a_handle]].key;
+  } //End: PriorityQueue::key()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::value()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  V & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::value(Handle a_handle)
+  {
+    CheckHandle(a_handle);
+    return m_data[m_positions[a_handle]].value;
+  } //End: PriorityQueue::value()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::value()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  V const & PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::value(Handle a_handle) const
+  {
+    CheckHandle(a_handle);
+    return m_data[m_positions[a_handle]].value;
+  } //End: PriorityQueue::value()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::decrease_key()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::decrease_key(Handle a_handle, K const & a_key)
+  {
+    CheckHandle(a_handle);
+    size_t position = m_positions[a_handle];
+    m_data[position].key = a_key;
+    SiftUp(position);
+  } //End: PriorityQueue::decrease_key()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::update_key()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::update_key(Handle a_handle, K const & a_key)
+  {
+    CheckHandle(a_handle);
+    size_t position = m_positions[a_handle];
+    bool towardsTop = Compare(a_key, m_data[position].key);
+    m_data[position].key = a_key;
+    if (towardsTop)
+      SiftUp(position);
+    else
+      SiftDown(position);
+  } //End: PriorityQueue::update_key()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ PriorityQueue::erase()
+  //-------------------------------------------------------------------------------
+  template<typename K, typename V, size_t D, bool TRACK_HANDLES, bool (*Compare)(K const &, K const &)>
+  void PriorityQueue<K, V, D, TRACK_HANDLES, Compare>::erase(Handle a_handle)
+  {
+    CheckHandle(a_handle);
+    RemoveAt(m_positions[a_handle]);
+  } //End: PriorityQueue::erase()
+}
+
+#endif
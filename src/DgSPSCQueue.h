@@ -0,0 +1,297 @@
+//@group Collections
+
+//! @file DgSPSCQueue.h
+//!
+//! Class declaration: SPSCQueue
+
+#ifndef DGSPSCQUEUE_H
+#define DGSPSCQUEUE_H
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <utility>
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class SPSCQueue
+  //!
+  //! Bounded, lock-free queue for passing items from exactly one producer thread
+  //! to exactly one consumer thread. Every operation completes in a bounded number
+  //! of steps: a full queue fails a push rather than waiting.
+  //!
+  //! The head (owned by the consumer) and tail (owned by the producer) live on
+  //! separate cache lines. Each side also keeps a private copy of the other side's
+  //! index, and only re-reads the shared one when the copy says the queue is full
+  //! (or empty). Batched push_n/pop_n publish many items with one store.
+  //!
+  //! The capacity is rounded up to a power of two.
+  template<typename T>
+  class SPSCQueue
+  {
+    SPSCQueue(SPSCQueue const &) = delete;
+    SPSCQueue & operator=(SPSCQueue const &) = delete;
+
+  public:
+
+    SPSCQueue(size_t capacity);
+    ~SPSCQueue();
+
+    //! Producer only. Returns false if the queue is full.
+    bool try_push(T const &);
+
+    //! Producer only. Returns false if the queue is full.
+    bool try_push(T &&);
+
+    //! Producer only. Pushes as many items as fit.
+    //! @return Number of items pushed.
+    size_t push_n(T const * pItems, size_t count);
+
+    //! Consumer only. Returns false if the queue is empty.
+    bool try_pop(T &);
+
+    //! Consumer only. Pops up to count items.
+    //! @return Number of items popped.
+    size_t pop_n(T * pOut, size_t count);
+
+    //! Number of items in the queue. Exact only when called from the producer or
+    //! consumer while the other side is idle.
+    size_t size_approx() const;
+
+    bool empty_approx() const;
+
+    size_t capacity() const;
+
+  private:
+
+    //! Producer side: ensure there is room for count items.
+    size_t FreeSlots(size_t tail, size_t count);
+
+    //! Consumer side: ensure count items are available.
+    size_t UsedSlots(size_t head, size_t count);
+
+  private:
+
+    static size_t const s_cacheLineSize = 64;
+
+    struct alignas(s_cacheLineSize) ProducerState
+    {
+      std::atomic<size_t> tail;
+      size_t              cachedHead;
+    };
+
+    struct alignas(s_cacheLineSize) ConsumerState
+    {
+      std::atomic<size_t> head;
+      size_t              cachedTail;
+    };
+
+    // Read-only after construction; shared by both sides.
+    alignas(s_cacheLineSize) T * m_pData;
+    size_t                       m_mask;
+
+    ProducerState   m_producer;
+    ConsumerState   m_consumer;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::SPSCQueue()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  SPSCQueue<T>::SPSCQueue(size_t a_capacity)
+    : m_pData(nullptr)
+    , m_mask(0)
+  {
+    size_t cap = 1;
+    while (cap < a_capacity)
+      cap <<= 1;
+
+    m_pData = static_cast<T *>(malloc(cap * sizeof(T)));
+    if (m_pData == nullptr)
+      throw std::bad_alloc();
+
+    m_mask = cap - 1;
+    m_producer.tail.store(0, std::memory_order_relaxed);
+    m_producer.cachedHead = 0;
+    m_consumer.head.store(0, std::memory_order_relaxed);
+    m_consumer.cachedTail = 0;
+  } //End: SPSCQueue::SPSCQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::~SPSCQueue()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  SPSCQueue<T>::~SPSCQueue()
+  {
+    size_t head = m_consumer.head.load(std::memory_order_relaxed);
+    size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+    for (; head != tail; head++)
+      m_pData[head & m_mask].~T();
+
+    free(m_pData);
+  } //End: SPSCQueue::~SPSCQueue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::capacity()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::capacity() const
+  {
+    return m_mask + 1;
+  } //End: SPSCQueue::capacity()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::size_approx()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::size_approx() const
+  {
+    size_t head = m_consumer.head.load(std::memory_order_acquire);
+    size_t tail = m_producer.tail.load(std::memory_order_acquire);
+    return tail - head;
+  } //End: SPSCQueue::size_approx()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::empty_approx()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool SPSCQueue<T>::empty_approx() const
+  {
+    return size_approx() == 0;
+  } //End: SPSCQueue::empty_approx()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::FreeSlots()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::FreeSlots(size_t a_tail, size_t a_count)
+  {
+    size_t nFree = capacity() - (a_tail - m_producer.cachedHead);
+    if (nFree < a_count)
+    {
+      m_producer.cachedHead = m_consumer.head.load(std::memory_order_acquire);
+      nFree = capacity() - (a_tail - m_producer.cachedHead);
+    }
+    return nFree;
+  } //End: SPSCQueue::FreeSlots()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::UsedSlots()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::UsedSlots(size_t a_head, size_t a_count)
+  {
+    size_t nUsed = m_consumer.cachedTail - a_head;
+    if (nUsed < a_count)
+    {
+      m_consumer.cachedTail = m_producer.tail.load(std::memory_order_acquire);
+      nUsed = m_consumer.cachedTail - a_head;
+    }
+    return nUsed;
+  } //End: SPSCQueue::UsedSlots()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::try_push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool SPSCQueue<T>::try_push(T const & a_item)
+  {
+    size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+    if (FreeSlots(tail, 1) == 0)
+      return false;
+
+    new (&m_pData[tail & m_mask]) T(a_item);
+    m_producer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  } //End: SPSCQueue::try_push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::try_push()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool SPSCQueue<T>::try_push(T && a_item)
+  {
+    size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+    if (FreeSlots(tail, 1) == 0)
+      return false;
+
+    new (&m_pData[tail & m_mask]) T(std::move(a_item));
+    m_producer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  } //End: SPSCQueue::try_push()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::push_n()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::push_n(T const * a_pItems, size_t a_count)
+  {
+    size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+    size_t n = FreeSlots(tail, a_count);
+    if (n > a_count)
+      n = a_count;
+
+    for (size_t i = 0; i < n; i++)
+      new (&m_pData[(tail + i) & m_mask]) T(a_pItems[i]);
+
+    if (n != 0)
+      m_producer.tail.store(tail + n, std::memory_order_release);
+    return n;
+  } //End: SPSCQueue::push_n()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::try_pop()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool SPSCQueue<T>::try_pop(T & a_out)
+  {
+    size_t head = m_consumer.head.load(std::memory_order_relaxed);
+    if (UsedSlots(head, 1) == 0)
+      return false;
+
+    T * pItem = &m_pData[head & m_mask];
+    a_out = std::move(*pItem);
+    pItem->~T();
+    m_consumer.head.store(head + 1, std::memory_order_release);
+    return true;
+  } //End: SPSCQueue::try_pop()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ SPSCQueue::pop_n()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  size_t SPSCQueue<T>::pop_n(T * a_pOut, size_t a_count)
+  {
+    size_t head = m_consumer.head.load(std::memory_order_relaxed);
+    size_t n = UsedSlots(head, a_count);
+    if (n > a_count)
+      n = a_count;
+
+    for (size_t i = 0; i < n; i++)
+    {
+      T * pItem = &m_pData[(head + i) & m_mask];
+      a_pOut[i] = std::move(*pItem);
+      pItem->~T();
+    }
+
+    if (n != 0)
+      m_consumer.head.store(head + n, std::memory_order_release);
+    return n;
+  } //End: SPSCQueue::pop_n()
+}
+
+#endif
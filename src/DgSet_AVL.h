@@ -13,8 +13,8 @@ namespace Dg
     U _Set_AVL_GetKey(T const &k) { return k; }
   }
 
-  template<typename KeyType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>>
-  using Set_AVL = Tree_AVL<KeyType, KeyType, impl::_Set_AVL_GetKey<KeyType, KeyType>, Compare>;
+  template<typename KeyType, bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>, typename POOL = PoolSizeMngr_Default>
+  using Set_AVL = Tree_AVL<KeyType, KeyType, impl::_Set_AVL_GetKey<KeyType, KeyType>, Compare, POOL>;
 }
 
 #endif
\ No newline at end of file
@@ -7,16 +7,107 @@
 #include <new>
 #include <cstring>
 #include <exception>
+#include <climits>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
 
 #include "impl/DgPoolSizeManager.h"
+#include "impl/DgContainerStats.h"
+#include "DgDynamicArray.h"
 
 namespace Dg
 {
-  template<typename T>
+  //! @ingroup DgContainers
+  //!
+  //! Describes how a SlotMap stores its keys. The lower INDEX_BITS of INT hold
+  //! the slot index and the remaining bits hold the generation. An INDEX_BITS
+  //! of 0 stores the index and generation in two separate INTs.
+  //!
+  //! Packed keys are the size of a single INT, so can be copied atomically. The
+  //! generation wraps after 2^(bits - INDEX_BITS) reuses of a slot, after which
+  //! a stale key may alias a live element. The index table is also stored in INT,
+  //! so smaller INTs reduce the per-slot overhead of the map.
+  template<typename INT, unsigned INDEX_BITS>
+  struct SlotMapKeyConfig
+  {
+    static_assert(std::is_unsigned<INT>::value, "SlotMap keys must be an unsigned integer type");
+    static_assert(INDEX_BITS < sizeof(INT) * CHAR_BIT, "SlotMap index bits must leave room for the generation");
+
+    typedef INT IntType;
+    static unsigned const IndexBits = INDEX_BITS;
+  };
+
+  typedef SlotMapKeyConfig<size_t, 0>    SlotMapKeyConfig_Default;
+  typedef SlotMapKeyConfig<uint64_t, 40> SlotMapKeyConfig_Packed64;
+  typedef SlotMapKeyConfig<uint32_t, 22> SlotMapKeyConfig_Packed32;
+
+  template<typename T, typename KEYCONFIG = SlotMapKeyConfig_Default, typename POOL = PoolSizeMngr_Default>
+  class SlotMap;
+
+  namespace impl
+  {
+    namespace SlotMap
+    {
+      template<typename INT, unsigned INDEX_BITS>
+      class Key
+      {
+        template<typename, typename, typename> friend class ::Dg::SlotMap;
+      public:
+
+        static INT const IndexMask = (static_cast<INT>(1) << INDEX_BITS) - 1;
+        static INT const GenerationMask = ~static_cast<INT>(0) >> INDEX_BITS;
+
+        //! The raw packed value. Can be stored and reconstructed with FromRaw().
+        INT GetRaw() const { return m_data; }
+        static Key FromRaw(INT a_raw) { Key k; k.m_data = a_raw; return k; }
+
+        bool operator==(Key const & a_other) const { return m_data == a_other.m_data; }
+        bool operator!=(Key const & a_other) const { return m_data != a_other.m_data; }
+
+      private:
+
+        INT GetIndex() const      { return m_data & IndexMask; }
+        INT GetGeneration() const { return m_data >> INDEX_BITS; }
+        void Set(INT a_index, INT a_generation) { m_data = (a_generation << INDEX_BITS) | (a_index & IndexMask); }
+
+        INT m_data;
+      };
+
+      template<typename INT>
+      class Key<INT, 0>
+      {
+        template<typename, typename, typename> friend class ::Dg::SlotMap;
+      public:
+
+        static INT const IndexMask = ~static_cast<INT>(0);
+        static INT const GenerationMask = ~static_cast<INT>(0);
+
+        bool operator==(Key const & a_other) const { return m_index == a_other.m_index && m_generation == a_other.m_generation; }
+        bool operator!=(Key const & a_other) const { return !(*this == a_other); }
+
+      private:
+
+        INT GetIndex() const      { return m_index; }
+        INT GetGeneration() const { return m_generation; }
+        void Set(INT a_index, INT a_generation) { m_index = a_index; m_generation = a_generation; }
+
+        INT m_index;
+        INT m_generation;
+      };
+    }
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
   class SlotMap
   {
+    typedef typename KEYCONFIG::IntType IntType;
+
     static size_t const s_default_capacity = 1024;
-    static size_t const INVALID_VALUE = 0xFFFFFFFFFFFFFFFF;
+    static IntType const INVALID_VALUE = impl::SlotMap::Key<IntType, KEYCONFIG::IndexBits>::IndexMask;
+
+    //The all-ones index is reserved to mark the end of the free list.
+    static size_t const s_max_capacity = static_cast<size_t>(INVALID_VALUE);
 
   public:
 
@@ -107,14 +198,7 @@ namespace Dg
 
   public:
 
-    struct Key
-    {
-      friend SlotMap;
-    private:
-    
-      size_t index;
-      size_t generation;
-    };
+    typedef impl::SlotMap::Key<IntType, KEYCONFIG::IndexBits> Key;
 
   public:
   
@@ -140,164 +224,194 @@ namespace Dg
     size_t size() const;
     void clear();
 
+    //! Ensure there is room for at least count items without reallocating.
+    void reserve(size_t count);
+
     Key insert(T const &);
     void erase(Key const &);
     void erase(iterator const &); //TODO
 
+    //! Insert count items, writing the key of each to outKeys. Memory is
+    //! reserved once for the whole batch.
+    void insert_batch(T const * values, size_t count, Key * outKeys);
+
+    //! Erase count items. Freed slots are appended to the free list in one go.
+    void erase_batch(Key const * keys, size_t count);
+
+    //! In deferred mode, erase() invalidates the key immediately but the element
+    //! is left in place until Flush() is called. Elements are not moved in memory
+    //! between flushes, so iteration stays stable. Note size() and iteration
+    //! include elements pending erasure until they are flushed.
+    void SetDeferredErase(bool);
+    bool IsDeferredErase() const;
+
+    //! Erase all elements pending erasure.
+    void Flush();
+
+    //! Memory and occupancy snapshot.
+    ContainerStats GetStats() const;
+
   private:
   
     void Extend();
+    void Grow(POOL);
+    bool Invalidate(Key const &);
+    void RemoveData(IntType keyIndex);
+    void AppendToFreeList(IntType first, IntType last);
     void Init(SlotMap const &);
     void Init(size_t);
     void InitMemory(size_t);
+    void InitFreeList(size_t first, size_t last);
     void DestructAll();
 
   private:
 
+    //! While a slot is on the free list, index holds the next free slot.
     struct Ind
     {
-      size_t index;
-      size_t generation;
-      size_t next;
+      IntType index;
+      IntType generation;
     };
 
     size_t m_nItems;
 
-    PoolSizeMngr_Default m_poolSize;
+    POOL m_poolSize;
 
-    size_t m_freeListHead;
-    size_t m_freeListTail;
+    IntType m_freeListHead;
+    IntType m_freeListTail;
 
     Ind *     m_pIndices;
     T *       m_pData;
-    size_t *  m_pEraseTable;
-  };
+    IntType * m_pEraseTable;
 
+    bool                  m_deferErase;
+    DynamicArray<IntType> m_pendingErase;
+  };
 
   //--------------------------------------------------------------------------------
   //		const_iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  SlotMap<T>::const_iterator::const_iterator(T const * a_pData)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::const_iterator::const_iterator(T const * a_pData)
     : m_pData(a_pData)
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::const_iterator::const_iterator()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::const_iterator::const_iterator()
     : m_pData(nullptr)
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::const_iterator::~const_iterator()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::const_iterator::const_iterator(const_iterator const& a_it)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::const_iterator::const_iterator(const_iterator const& a_it)
     : m_pData(a_it.m_pData)
   {
 
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator&
-    SlotMap<T>::const_iterator::operator=(const_iterator const& a_other)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator&
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator=(const_iterator const& a_other)
   {
     m_pData = a_other.m_pData;
     return *this;
   }
 
-  template<typename T>
-  bool SlotMap<T>::const_iterator::operator==(const_iterator const& a_it) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator==(const_iterator const& a_it) const
   {
     return m_pData == a_it.m_pData;
   }
 
-  template<typename T>
-  bool SlotMap<T>::const_iterator::operator!=(const_iterator const& a_it) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator!=(const_iterator const& a_it) const
   {
     return m_pData != a_it.m_pData;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator
-    SlotMap<T>::const_iterator::operator+(size_t a_val) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator+(size_t a_val) const
   {
     return const_iterator(m_pData + a_val);
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator
-    SlotMap<T>::const_iterator::operator-(size_t a_val) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator-(size_t a_val) const
   {
     return const_iterator(m_pData - a_val);
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator&
-    SlotMap<T>::const_iterator::operator+=(size_t a_val)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator&
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator+=(size_t a_val)
   {
     m_pData += a_val;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator&
-    SlotMap<T>::const_iterator::operator-=(size_t a_val)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator&
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator-=(size_t a_val)
   {
     m_pData -= a_val;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator&
-    SlotMap<T>::const_iterator::operator++()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator&
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator++()
   {
     m_pData++;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator
-    SlotMap<T>::const_iterator::operator++(int)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator&
-    SlotMap<T>::const_iterator::operator--()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator&
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator--()
   {
     m_pData--;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator
-    SlotMap<T>::const_iterator::operator--(int)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename KEYCONFIG, typename POOL>
   T const *
-    SlotMap<T>::const_iterator::operator->() const
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator->() const
   {
     return m_pData;
   }
 
-  template<typename T>
+  template<typename T, typename KEYCONFIG, typename POOL>
   T const &
-    SlotMap<T>::const_iterator::operator*() const
+    SlotMap<T, KEYCONFIG, POOL>::const_iterator::operator*() const
   {
     return *m_pData;
   }
@@ -305,134 +419,134 @@ namespace Dg
   //--------------------------------------------------------------------------------
   //		iterator
   //--------------------------------------------------------------------------------
-  template<typename T>
-  SlotMap<T>::iterator::iterator(T * a_pData)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::iterator::iterator(T * a_pData)
     : m_pData(a_pData)
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::iterator::iterator()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::iterator::iterator()
     : m_pData(nullptr)
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::iterator::~iterator()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename T>
-  SlotMap<T>::iterator::iterator(iterator const& a_it)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::iterator::iterator(iterator const& a_it)
     : m_pData(a_it.m_pData)
   {
 
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator&
-    SlotMap<T>::iterator::operator=(iterator const& a_other)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator&
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator=(iterator const& a_other)
   {
     m_pData = a_other.m_pData;
     return *this;
   }
 
-  template<typename T>
-  bool SlotMap<T>::iterator::operator==(iterator const& a_it) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::iterator::operator==(iterator const& a_it) const
   {
     return m_pData == a_it.m_pData;
   }
 
-  template<typename T>
-  bool SlotMap<T>::iterator::operator!=(iterator const& a_it) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::iterator::operator!=(iterator const& a_it) const
   {
     return m_pData != a_it.m_pData;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator
-    SlotMap<T>::iterator::operator+(size_t a_val) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator+(size_t a_val) const
   {
     return iterator(m_pData + a_val);
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator
-    SlotMap<T>::iterator::operator-(size_t a_val) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator-(size_t a_val) const
   {
     return iterator(m_pData - a_val);
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator&
-    SlotMap<T>::iterator::operator+=(size_t a_val)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator&
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator+=(size_t a_val)
   {
     m_pData += a_val;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator&
-    SlotMap<T>::iterator::operator-=(size_t a_val)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator&
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator-=(size_t a_val)
   {
     m_pData -= a_val;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator&
-    SlotMap<T>::iterator::operator++()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator&
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator++()
   {
     m_pData++;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator
-    SlotMap<T>::iterator::operator++(int)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator&
-    SlotMap<T>::iterator::operator--()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator&
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator--()
   {
     m_pData--;
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator
-    SlotMap<T>::iterator::operator--(int)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename T>
+  template<typename T, typename KEYCONFIG, typename POOL>
   T*
-    SlotMap<T>::iterator::operator->()
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator->()
   {
     return m_pData;
   }
 
-  template<typename T>
+  template<typename T, typename KEYCONFIG, typename POOL>
   T&
-    SlotMap<T>::iterator::operator*()
+    SlotMap<T, KEYCONFIG, POOL>::iterator::operator*()
   {
     return *m_pData;
   }
 
-  template<typename T>
-  SlotMap<T>::iterator::operator
-    typename SlotMap<T>::const_iterator() const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::iterator::operator
+    typename SlotMap<T, KEYCONFIG, POOL>::const_iterator() const
   {
     return const_iterator(m_pData);
   }
@@ -441,8 +555,8 @@ namespace Dg
   //		SlotMap
   //--------------------------------------------------------------------------------
 
-  template<typename T>
-  SlotMap<T>::SlotMap()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::SlotMap()
     : m_poolSize(s_default_capacity)
     , m_nItems(0)
     , m_freeListHead(INVALID_VALUE)
@@ -450,12 +564,13 @@ namespace Dg
     , m_pIndices(nullptr)
     , m_pData(nullptr)
     , m_pEraseTable(nullptr)
+    , m_deferErase(false)
   {
     Init(s_default_capacity);
   }
 
-  template<typename T>
-  SlotMap<T>::SlotMap(size_t a_capacity)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::SlotMap(size_t a_capacity)
     : m_poolSize(a_capacity)
     , m_nItems(0)
     , m_freeListHead(INVALID_VALUE)
@@ -463,12 +578,13 @@ namespace Dg
     , m_pIndices(nullptr)
     , m_pData(nullptr)
     , m_pEraseTable(nullptr)
+    , m_deferErase(false)
   {
     Init(a_capacity);
   }
 
-  template<typename T>
-  SlotMap<T>::~SlotMap()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::~SlotMap()
   {
     DestructAll();
     free(m_pIndices);
@@ -476,8 +592,8 @@ namespace Dg
     free(m_pEraseTable);
   }
 
-  template<typename T>
-  SlotMap<T>::SlotMap(SlotMap const & a_other)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::SlotMap(SlotMap const & a_other)
     : m_poolSize(s_default_capacity)
     , m_nItems(0)
     , m_freeListHead(INVALID_VALUE)
@@ -485,12 +601,13 @@ namespace Dg
     , m_pIndices(nullptr)
     , m_pData(nullptr)
     , m_pEraseTable(nullptr)
+    , m_deferErase(false)
   {
     Init(a_other);
   }
 
-  template<typename T>
-  SlotMap<T> & SlotMap<T>::operator=(SlotMap const & a_other)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL> & SlotMap<T, KEYCONFIG, POOL>::operator=(SlotMap const & a_other)
   {
     if (this != &a_other)
       Init(a_other);
@@ -498,8 +615,8 @@ namespace Dg
   }
 
   //TODO Fix all move operators to look like these:
-  template<typename T>
-  SlotMap<T>::SlotMap(SlotMap && a_other)  noexcept
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL>::SlotMap(SlotMap && a_other)  noexcept
     : m_poolSize(a_other.m_poolSize.GetSize())
     , m_nItems(a_other.m_nItems)
     , m_freeListHead(a_other.m_freeListHead)
@@ -507,6 +624,8 @@ namespace Dg
     , m_pIndices(a_other.m_pIndices)
     , m_pData(a_other.m_pData)
     , m_pEraseTable(a_other.m_pEraseTable)
+    , m_deferErase(a_other.m_deferErase)
+    , m_pendingErase(std::move(a_other.m_pendingErase))
   {
     a_other.m_nItems = 0;
     a_other.m_freeListHead = INVALID_VALUE;
@@ -516,8 +635,8 @@ namespace Dg
     a_other.m_pEraseTable = nullptr;
   }
 
-  template<typename T>
-  SlotMap<T> & SlotMap<T>::operator=(SlotMap && a_other)  noexcept
+  template<typename T, typename KEYCONFIG, typename POOL>
+  SlotMap<T, KEYCONFIG, POOL> & SlotMap<T, KEYCONFIG, POOL>::operator=(SlotMap && a_other)  noexcept
   {
     if (this != &a_other)
     {
@@ -530,6 +649,8 @@ namespace Dg
       m_pIndices = a_other.m_pIndices;
       m_pData = a_other.m_pData;
       m_pEraseTable = a_other.m_pEraseTable;
+      m_deferErase = a_other.m_deferErase;
+      m_pendingErase = std::move(a_other.m_pendingErase);
 
       a_other.m_nItems = 0;
       a_other.m_freeListHead = INVALID_VALUE;
@@ -541,73 +662,180 @@ namespace Dg
     return *this;
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator SlotMap<T>::begin()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator SlotMap<T, KEYCONFIG, POOL>::begin()
   {
     return iterator(&m_pData[0]);
   }
 
-  template<typename T>
-  typename SlotMap<T>::iterator SlotMap<T>::end()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::iterator SlotMap<T, KEYCONFIG, POOL>::end()
   {
     return iterator(&m_pData[m_nItems]);
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator SlotMap<T>::cbegin() const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator SlotMap<T, KEYCONFIG, POOL>::cbegin() const
   {
     return const_iterator(&m_pData[0]);
   }
 
-  template<typename T>
-  typename SlotMap<T>::const_iterator SlotMap<T>::cend() const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::const_iterator SlotMap<T, KEYCONFIG, POOL>::cend() const
   {
     return const_iterator(&m_pData[m_nItems]);
   }
 
-  template<typename T>
-  T& SlotMap<T>::operator[](size_t a_index)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  T& SlotMap<T, KEYCONFIG, POOL>::operator[](size_t a_index)
   {
     return m_pData[a_index];
   }
 
-  template<typename T>
-  T const & SlotMap<T>::operator[](size_t a_index) const
+  template<typename T, typename KEYCONFIG, typename POOL>
+  T const & SlotMap<T, KEYCONFIG, POOL>::operator[](size_t a_index) const
   {
     return m_pData[a_index];
   }
 
-  template<typename T>
-  typename SlotMap<T>::Key SlotMap<T>::insert(T const & a_item)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  typename SlotMap<T, KEYCONFIG, POOL>::Key SlotMap<T, KEYCONFIG, POOL>::insert(T const & a_item)
   {
     if ((m_nItems + 1) == m_poolSize.GetSize())
       Extend();
 
-    size_t ind = m_freeListHead;
-    m_freeListHead = m_pIndices[m_freeListHead].next;
-
-    m_pIndices[ind].index = m_nItems;
-    m_pIndices[ind].generation++;
-    m_pIndices[ind].next = INVALID_VALUE;
+    IntType ind = m_freeListHead;
+    m_freeListHead = m_pIndices[m_freeListHead].index;
 
+    m_pIndices[ind].index = static_cast<IntType>(m_nItems);
     m_pEraseTable[m_nItems] = ind;
 
     new(&m_pData[m_nItems]) T(a_item);
     m_nItems++;
 
     Key result;
-    result.index = ind;
-    result.generation = m_pIndices[ind].generation;
+    result.Set(ind, m_pIndices[ind].generation);
     return result;
   }
 
-  template<typename T>
-  void SlotMap<T>::erase(Key const & a_key)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::erase(Key const & a_key)
+  {
+    if (!Invalidate(a_key))
+      return;
+
+    IntType keyIndex = a_key.GetIndex();
+    if (m_deferErase)
+    {
+      m_pendingErase.push_back(keyIndex);
+      return;
+    }
+
+    RemoveData(keyIndex);
+    AppendToFreeList(keyIndex, keyIndex);
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::insert_batch(T const * a_pValues, size_t a_count, Key * a_pOutKeys)
+  {
+    reserve(m_nItems + a_count);
+
+    IntType ind = m_freeListHead;
+    for (size_t i = 0; i < a_count; i++)
+    {
+      IntType next = m_pIndices[ind].index;
+
+      m_pIndices[ind].index = static_cast<IntType>(m_nItems);
+      m_pEraseTable[m_nItems] = ind;
+      new(&m_pData[m_nItems]) T(a_pValues[i]);
+      a_pOutKeys[i].Set(ind, m_pIndices[ind].generation);
+
+      m_nItems++;
+      ind = next;
+    }
+    m_freeListHead = ind;
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::erase_batch(Key const * a_pKeys, size_t a_count)
+  {
+    IntType first = INVALID_VALUE;
+    IntType last = INVALID_VALUE;
+
+    for (size_t i = 0; i < a_count; i++)
+    {
+      if (!Invalidate(a_pKeys[i]))
+        continue;
+
+      IntType keyIndex = a_pKeys[i].GetIndex();
+      if (m_deferErase)
+      {
+        m_pendingErase.push_back(keyIndex);
+        continue;
+      }
+
+      RemoveData(keyIndex);
+      if (first == INVALID_VALUE)
+        first = keyIndex;
+      else
+        m_pIndices[last].index = keyIndex;
+      last = keyIndex;
+    }
+
+    if (first != INVALID_VALUE)
+      AppendToFreeList(first, last);
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::SetDeferredErase(bool a_defer)
   {
-    if (m_pIndices[a_key.index].generation != a_key.generation)
+    if (m_deferErase && !a_defer)
+      Flush();
+    m_deferErase = a_defer;
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::IsDeferredErase() const
+  {
+    return m_deferErase;
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::Flush()
+  {
+    if (m_pendingErase.empty())
       return;
 
-    size_t dataInd = m_pIndices[a_key.index].index;
+    for (size_t i = 0; i < m_pendingErase.size(); i++)
+    {
+      RemoveData(m_pendingErase[i]);
+      if (i + 1 < m_pendingErase.size())
+        m_pIndices[m_pendingErase[i]].index = m_pendingErase[i + 1];
+    }
+
+    AppendToFreeList(m_pendingErase[0], m_pendingErase.back());
+    m_pendingErase.clear();
+  }
+
+  //Returns false if the key is no longer valid. Otherwise bumps the generation
+  //so the key, and any copies of it, become invalid.
+  template<typename T, typename KEYCONFIG, typename POOL>
+  bool SlotMap<T, KEYCONFIG, POOL>::Invalidate(Key const & a_key)
+  {
+    IntType keyIndex = a_key.GetIndex();
+    if (keyIndex >= m_poolSize.GetSize()
+      || m_pIndices[keyIndex].generation != a_key.GetGeneration())
+      return false;
+
+    m_pIndices[keyIndex].generation = (m_pIndices[keyIndex].generation + 1) & Key::GenerationMask;
+    return true;
+  }
+
+  //Destructs the element and fills the hole with the last element.
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::RemoveData(IntType a_keyIndex)
+  {
+    IntType dataInd = m_pIndices[a_keyIndex].index;
     m_pData[dataInd].~T();
 
     if (dataInd + 1 != m_nItems)
@@ -617,42 +845,90 @@ namespace Dg
       m_pIndices[m_pEraseTable[dataInd]].index = dataInd;
     }
 
-    m_pIndices[a_key.index].generation++;
-    m_pIndices[a_key.index].index = INVALID_VALUE;
-    m_pIndices[a_key.index].next = INVALID_VALUE;
-    m_pIndices[m_freeListTail].next = a_key.index;
-    m_freeListTail = a_key.index;
-
+    m_pIndices[a_keyIndex].index = INVALID_VALUE;
     m_nItems--;
   }
 
-  template<typename T>
-  size_t SlotMap<T>::size() const
+  //Appends an already linked chain of slots to the free list.
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::AppendToFreeList(IntType a_first, IntType a_last)
+  {
+    m_pIndices[a_last].index = INVALID_VALUE;
+    m_pIndices[m_freeListTail].index = a_first;
+    m_freeListTail = a_last;
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  size_t SlotMap<T, KEYCONFIG, POOL>::size() const
   {
     return m_nItems;
   }
 
-  template<typename T>
-  void SlotMap<T>::clear()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  ContainerStats SlotMap<T, KEYCONFIG, POOL>::GetStats() const
+  {
+    size_t const slotBytes = sizeof(Ind) + sizeof(T) + sizeof(IntType);
+    ContainerStats pending = m_pendingErase.GetStats();
+
+    ContainerStats stats;
+    stats.elementCount = m_nItems;
+    stats.capacity = m_poolSize.GetSize() - 1;
+    stats.bytesReserved = m_poolSize.GetSize() * slotBytes + pending.bytesReserved;
+    stats.bytesUsed = m_nItems * slotBytes + pending.bytesUsed;
+    stats.poolSizeIndex = m_poolSize.GetIndex();
+    stats.poolResizes = m_poolSize.GetResizeCount();
+    return stats;
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::clear()
   {
     DestructAll();
+    m_pendingErase.clear();
 
+    // Bump generations rather than resetting them so outstanding keys are invalidated.
     for (size_t i = 0; i < m_poolSize.GetSize(); i++)
-    {
-      m_pIndices[i] ={INVALID_VALUE, 0, i + 1};
-      m_pEraseTable[i] = INVALID_VALUE;
-    }
-    m_pIndices[m_poolSize.GetSize() - 1].next = INVALID_VALUE;
+      m_pIndices[i].generation = (m_pIndices[i].generation + 1) & Key::GenerationMask;
 
+    InitFreeList(0, m_poolSize.GetSize() - 1);
+    m_freeListHead = 0;
     m_nItems = 0;
   }
 
-  template<typename T>
-  void SlotMap<T>::Extend()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::Extend()
+  {
+    POOL newPoolSize(m_poolSize);
+    newPoolSize.SetNextPoolSize();
+    Grow(newPoolSize);
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::reserve(size_t a_count)
+  {
+    //Always keep one slot free, so the free list is never empty.
+    if (a_count < m_poolSize.GetSize())
+      return;
+
+    POOL newPoolSize(m_poolSize);
+    newPoolSize.SetSize(a_count + 1);
+    if (newPoolSize.GetSize() <= a_count)
+      throw std::exception("SlotMap has reached its maximum capacity");
+    Grow(newPoolSize);
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::Grow(POOL a_newPoolSize)
   {
-    Ind* tempIndices = static_cast<Ind*>(malloc(sizeof(Ind) * m_poolSize.PeekNextPoolSize()));
-    T* tempData = static_cast<T*>(malloc(sizeof(T) * m_poolSize.PeekNextPoolSize()));
-    size_t* tempEraseTable = static_cast<size_t*>(malloc(sizeof(size_t) * m_poolSize.PeekNextPoolSize()));
+    size_t oldSize = m_poolSize.GetSize();
+    size_t newSize = a_newPoolSize.GetSize();
+
+    if (newSize <= oldSize || newSize > s_max_capacity)
+      throw std::exception("SlotMap has reached its maximum capacity");
+
+    Ind* tempIndices = static_cast<Ind*>(malloc(sizeof(Ind) * newSize));
+    T* tempData = static_cast<T*>(malloc(sizeof(T) * newSize));
+    IntType* tempEraseTable = static_cast<IntType*>(malloc(sizeof(IntType) * newSize));
 
     if (tempIndices == nullptr
       || tempData == nullptr
@@ -665,11 +941,10 @@ namespace Dg
       throw std::exception("SlotMap failed to allocate memory");
     }
 
-    m_poolSize.SetNextPoolSize();
-
-    memcpy(tempIndices, m_pIndices, sizeof(Ind) * m_nItems);
+    //Any slot in the index table may be in use, so copy all of it.
+    memcpy(tempIndices, m_pIndices, sizeof(Ind) * oldSize);
     memcpy(tempData, m_pData, sizeof(T) * m_nItems);
-    memcpy(tempEraseTable, m_pEraseTable, sizeof(size_t) * m_nItems);
+    memcpy(tempEraseTable, m_pEraseTable, sizeof(IntType) * m_nItems);
 
     free(m_pIndices);
     free(m_pData);
@@ -679,19 +954,21 @@ namespace Dg
     m_pData = tempData;
     m_pEraseTable = tempEraseTable;
 
-    for (size_t i = m_nItems; i < m_poolSize.GetSize(); i++)
-    {
-      m_pIndices[i].index = INVALID_VALUE;
+    m_poolSize = a_newPoolSize;
+
+    //Append the new slots to the end of the free list
+    if (m_freeListHead == INVALID_VALUE)
+      m_freeListHead = static_cast<IntType>(oldSize);
+    else
+      m_pIndices[m_freeListTail].index = static_cast<IntType>(oldSize);
+
+    for (size_t i = oldSize; i < newSize; i++)
       m_pIndices[i].generation = 0;
-      m_pIndices[i].next = i + 1;
-      m_pEraseTable[i] = INVALID_VALUE;
-    }
-    m_pIndices[m_poolSize.GetSize() - 1].next = INVALID_VALUE;
-    m_freeListTail = m_poolSize.GetSize() - 1;
+    InitFreeList(oldSize, newSize - 1);
   }
 
-  template<typename T>
-  void SlotMap<T>::Init(SlotMap const & a_other)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::Init(SlotMap const & a_other)
   {
     InitMemory(a_other.m_poolSize.GetSize());
 
@@ -699,38 +976,38 @@ namespace Dg
     m_nItems = a_other.m_nItems;
     m_freeListHead = a_other.m_freeListHead;
     m_freeListTail = a_other.m_freeListTail;
+    m_deferErase = a_other.m_deferErase;
+    m_pendingErase = a_other.m_pendingErase;
 
     memcpy(m_pIndices, a_other.m_pIndices, sizeof(Ind) * m_poolSize.GetSize());
-    memcpy(m_pEraseTable, a_other.m_pEraseTable, sizeof(size_t) * m_poolSize.GetSize());
+    memcpy(m_pEraseTable, a_other.m_pEraseTable, sizeof(IntType) * m_poolSize.GetSize());
     for (size_t i = 0; i < m_nItems; i++)
       new(&m_pData[i]) T(a_other.m_pData[i]);
   }
 
-  template<typename T>
-  void SlotMap<T>::Init(size_t a_size)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::Init(size_t a_size)
   {
-    PoolSizeMngr_Default szeMgr(a_size);
+    POOL szeMgr(a_size);
+    while (szeMgr.GetSize() > s_max_capacity)
+      szeMgr.SetPrevPoolSize();
     InitMemory(szeMgr.GetSize());
 
     m_poolSize = szeMgr;
     m_freeListHead = 0;
-    m_freeListTail = m_poolSize.GetSize() - 1;
     m_nItems = 0;
 
     for (size_t i = 0; i < m_poolSize.GetSize(); i++)
-    {
-      m_pIndices[i] = {INVALID_VALUE, 0, i + 1};
-      m_pEraseTable[i] = INVALID_VALUE;
-    }
-    m_pIndices[m_poolSize.GetSize() - 1].next = INVALID_VALUE;
+      m_pIndices[i].generation = 0;
+    InitFreeList(0, m_poolSize.GetSize() - 1);
   }
 
-  template<typename T>
-  void SlotMap<T>::InitMemory(size_t a_size)
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::InitMemory(size_t a_size)
   {
     Ind* tempIndices = static_cast<Ind*>(malloc(sizeof(Ind) * a_size));
     T* tempData = static_cast<T*>(malloc(sizeof(T) * a_size));
-    size_t* tempEraseTable = static_cast<size_t*>(malloc(sizeof(size_t) * a_size));
+    IntType* tempEraseTable = static_cast<IntType*>(malloc(sizeof(IntType) * a_size));
 
     if (tempIndices == nullptr
       || tempData == nullptr
@@ -754,8 +1031,21 @@ namespace Dg
     m_pEraseTable = tempEraseTable;
   }
 
-  template<typename T>
-  void SlotMap<T>::DestructAll()
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::InitFreeList(size_t a_first, size_t a_last)
+  {
+    for (size_t i = a_first; i < a_last; i++)
+    {
+      m_pIndices[i].index = static_cast<IntType>(i + 1);
+      m_pEraseTable[i] = INVALID_VALUE;
+    }
+    m_pIndices[a_last].index = INVALID_VALUE;
+    m_pEraseTable[a_last] = INVALID_VALUE;
+    m_freeListTail = static_cast<IntType>(a_last);
+  }
+
+  template<typename T, typename KEYCONFIG, typename POOL>
+  void SlotMap<T, KEYCONFIG, POOL>::DestructAll()
   {
     for (size_t i = 0; i < m_nItems; i++)
       m_pData[i].~T();
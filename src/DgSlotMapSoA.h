@@ -0,0 +1,564 @@
+//@group Collections
+
+//! @file DgSlotMapSoA.h
+//!
+//! Class declaration: SlotMapSoA
+
+#ifndef DGSLOTMAPSOA_H
+#define DGSLOTMAPSOA_H
+
+#include <cstdlib>
+#include <new>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include "impl/DgPoolSizeManager.h"
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! @class SlotMapSoA
+  //!
+  //! A SlotMap which stores each of its element types in a separate dense column.
+  //! All columns share the same key/generation/erase-table indirection, so an
+  //! element is inserted and erased across every column at once. Each column can
+  //! be accessed as a raw contiguous array via data<I>(), which allows systems
+  //! that only touch one field to stream through it.
+  //!
+  //! As with SlotMap, elements are moved around in memory with memcpy when
+  //! erasing, so types must be trivially relocatable.
+  //!
+  //! Unlike SlotMap, the growth policy is fixed to PoolSizeMngr_Default, as the
+  //! template parameter pack leaves no place for a pool size manager.
+  template<typename... Ts>
+  class SlotMapSoA
+  {
+    static_assert(sizeof...(Ts) > 0, "SlotMapSoA requires at least one column type");
+
+    static size_t const s_default_capacity = 1024;
+    static size_t const INVALID_VALUE = 0xFFFFFFFFFFFFFFFF;
+
+  public:
+
+    static size_t const ColumnCount = sizeof...(Ts);
+
+    template<size_t I>
+    using ColumnType = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    struct Key
+    {
+      friend SlotMapSoA;
+    private:
+
+      size_t index;
+      size_t generation;
+    };
+
+  public:
+
+    SlotMapSoA();
+    SlotMapSoA(size_t capacity);
+
+    ~SlotMapSoA();
+
+    SlotMapSoA(SlotMapSoA const &);
+    SlotMapSoA & operator=(SlotMapSoA const &);
+
+    SlotMapSoA(SlotMapSoA &&) noexcept;
+    SlotMapSoA & operator=(SlotMapSoA &&) noexcept;
+
+    //! Pointer to the first element of column I. The column holds size() contiguous elements.
+    template<size_t I>
+    ColumnType<I> * data();
+
+    //! Pointer to the first element of column I. The column holds size() contiguous elements.
+    template<size_t I>
+    ColumnType<I> const * data() const;
+
+    //! Returns nullptr if the key is no longer valid.
+    template<size_t I>
+    ColumnType<I> * at(Key const &);
+
+    //! Returns nullptr if the key is no longer valid.
+    template<size_t I>
+    ColumnType<I> const * at(Key const &) const;
+
+    //! Position of the element in the dense columns. Returns INVALID_VALUE if the key is no longer valid.
+    size_t dense_index(Key const &) const;
+
+    bool exists(Key const &) const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    Key insert(Ts const &...);
+    void erase(Key const &);
+
+  private:
+
+    typedef std::index_sequence_for<Ts...> ColumnIndices;
+
+    template<size_t... Is>
+    void Construct(size_t, std::index_sequence<Is...>, Ts const &...);
+
+    template<size_t... Is>
+    void Destruct(size_t, std::index_sequence<Is...>);
+
+    template<size_t... Is>
+    void Relocate(size_t dest, size_t src, std::index_sequence<Is...>);
+
+    template<size_t... Is>
+    void CopyConstruct(SlotMapSoA const &, size_t, std::index_sequence<Is...>);
+
+    template<size_t... Is>
+    bool ReallocColumns(size_t, std::index_sequence<Is...>);
+
+    template<size_t... Is>
+    void FreeColumns(std::index_sequence<Is...>);
+
+    void Extend();
+    void Init(SlotMapSoA const &);
+    void Init(size_t);
+    void InitFreeList(size_t first, size_t last);
+    void DestructAll();
+    void FreeMemory();
+
+  private:
+
+    struct Ind
+    {
+      size_t index;
+      size_t generation;
+      size_t next;
+    };
+
+    size_t m_nItems;
+
+    PoolSizeMngr_Default m_poolSize;
+
+    size_t m_freeListHead;
+    size_t m_freeListTail;
+
+    Ind *               m_pIndices;
+    size_t *            m_pEraseTable;
+    std::tuple<Ts*...>  m_columns;
+  };
+
+  //--------------------------------------------------------------------------------
+  //		SlotMapSoA
+  //--------------------------------------------------------------------------------
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...>::SlotMapSoA()
+    : m_nItems(0)
+    , m_poolSize(s_default_capacity)
+    , m_freeListHead(INVALID_VALUE)
+    , m_freeListTail(INVALID_VALUE)
+    , m_pIndices(nullptr)
+    , m_pEraseTable(nullptr)
+    , m_columns()
+  {
+    Init(s_default_capacity);
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...>::SlotMapSoA(size_t a_capacity)
+    : m_nItems(0)
+    , m_poolSize(a_capacity)
+    , m_freeListHead(INVALID_VALUE)
+    , m_freeListTail(INVALID_VALUE)
+    , m_pIndices(nullptr)
+    , m_pEraseTable(nullptr)
+    , m_columns()
+  {
+    Init(a_capacity);
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...>::~SlotMapSoA()
+  {
+    DestructAll();
+    FreeMemory();
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...>::SlotMapSoA(SlotMapSoA const & a_other)
+    : m_nItems(0)
+    , m_poolSize(s_default_capacity)
+    , m_freeListHead(INVALID_VALUE)
+    , m_freeListTail(INVALID_VALUE)
+    , m_pIndices(nullptr)
+    , m_pEraseTable(nullptr)
+    , m_columns()
+  {
+    Init(a_other);
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...> & SlotMapSoA<Ts...>::operator=(SlotMapSoA const & a_other)
+  {
+    if (this != &a_other)
+      Init(a_other);
+    return *this;
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...>::SlotMapSoA(SlotMapSoA && a_other) noexcept
+    : m_nItems(a_other.m_nItems)
+    , m_poolSize(a_other.m_poolSize)
+    , m_freeListHead(a_other.m_freeListHead)
+    , m_freeListTail(a_other.m_freeListTail)
+    , m_pIndices(a_other.m_pIndices)
+    , m_pEraseTable(a_other.m_pEraseTable)
+    , m_columns(a_other.m_columns)
+  {
+    a_other.m_nItems = 0;
+    a_other.m_freeListHead = INVALID_VALUE;
+    a_other.m_freeListTail = INVALID_VALUE;
+    a_other.m_pIndices = nullptr;
+    a_other.m_pEraseTable = nullptr;
+    a_other.m_columns = std::tuple<Ts*...>();
+  }
+
+  template<typename... Ts>
+  SlotMapSoA<Ts...> & SlotMapSoA<Ts...>::operator=(SlotMapSoA && a_other) noexcept
+  {
+    if (this != &a_other)
+    {
+      DestructAll();
+      FreeMemory();
+
+      m_nItems = a_other.m_nItems;
+      m_poolSize = a_other.m_poolSize;
+      m_freeListHead = a_other.m_freeListHead;
+      m_freeListTail = a_other.m_freeListTail;
+      m_pIndices = a_other.m_pIndices;
+      m_pEraseTable = a_other.m_pEraseTable;
+      m_columns = a_other.m_columns;
+
+      a_other.m_nItems = 0;
+      a_other.m_freeListHead = INVALID_VALUE;
+      a_other.m_freeListTail = INVALID_VALUE;
+      a_other.m_pIndices = nullptr;
+      a_other.m_pEraseTable = nullptr;
+      a_other.m_columns = std::tuple<Ts*...>();
+    }
+    return *this;
+  }
+
+  template<typename... Ts>
+  template<size_t I>
+  typename SlotMapSoA<Ts...>::template ColumnType<I> * SlotMapSoA<Ts...>::data()
+  {
+    return std::get<I>(m_columns);
+  }
+
+  template<typename... Ts>
+  template<size_t I>
+  typename SlotMapSoA<Ts...>::template ColumnType<I> const * SlotMapSoA<Ts...>::data() const
+  {
+    return std::get<I>(m_columns);
+  }
+
+  template<typename... Ts>
+  template<size_t I>
+  typename SlotMapSoA<Ts...>::template ColumnType<I> * SlotMapSoA<Ts...>::at(Key const & a_key)
+  {
+    size_t ind = dense_index(a_key);
+    if (ind == INVALID_VALUE)
+      return nullptr;
+    return &std::get<I>(m_columns)[ind];
+  }
+
+  template<typename... Ts>
+  template<size_t I>
+  typename SlotMapSoA<Ts...>::template ColumnType<I> const * SlotMapSoA<Ts...>::at(Key const & a_key) const
+  {
+    size_t ind = dense_index(a_key);
+    if (ind == INVALID_VALUE)
+      return nullptr;
+    return &std::get<I>(m_columns)[ind];
+  }
+
+  template<typename... Ts>
+  size_t SlotMapSoA<Ts...>::dense_index(Key const & a_key) const
+  {
+    if (a_key.index >= m_poolSize.GetSize()
+      || m_pIndices[a_key.index].generation != a_key.generation)
+      return INVALID_VALUE;
+    return m_pIndices[a_key.index].index;
+  }
+
+  template<typename... Ts>
+  bool SlotMapSoA<Ts...>::exists(Key const & a_key) const
+  {
+    return dense_index(a_key) != INVALID_VALUE;
+  }
+
+  template<typename... Ts>
+  size_t SlotMapSoA<Ts...>::size() const
+  {
+    return m_nItems;
+  }
+
+  template<typename... Ts>
+  bool SlotMapSoA<Ts...>::empty() const
+  {
+    return m_nItems == 0;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::clear()
+  {
+    DestructAll();
+
+    // Bump generations rather than resetting them so outstanding keys are invalidated.
+    for (size_t i = 0; i < m_poolSize.GetSize(); i++)
+    {
+      if (m_pIndices[i].index != INVALID_VALUE)
+        m_pIndices[i].generation++;
+    }
+    InitFreeList(0, m_poolSize.GetSize() - 1);
+    m_freeListHead = 0;
+    m_nItems = 0;
+  }
+
+  template<typename... Ts>
+  typename SlotMapSoA<Ts...>::Key SlotMapSoA<Ts...>::insert(Ts const &... a_items)
+  {
+    if ((m_nItems + 1) == m_poolSize.GetSize())
+      Extend();
+
+    size_t ind = m_freeListHead;
+    m_freeListHead = m_pIndices[m_freeListHead].next;
+
+    m_pIndices[ind].index = m_nItems;
+    m_pIndices[ind].next = INVALID_VALUE;
+
+    m_pEraseTable[m_nItems] = ind;
+
+    Construct(m_nItems, ColumnIndices(), a_items...);
+    m_nItems++;
+
+    Key result;
+    result.index = ind;
+    result.generation = m_pIndices[ind].generation;
+    return result;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::erase(Key const & a_key)
+  {
+    size_t dataInd = dense_index(a_key);
+    if (dataInd == INVALID_VALUE)
+      return;
+
+    Destruct(dataInd, ColumnIndices());
+
+    if (dataInd + 1 != m_nItems)
+    {
+      Relocate(dataInd, m_nItems - 1, ColumnIndices());
+      m_pEraseTable[dataInd] = m_pEraseTable[m_nItems - 1];
+      m_pIndices[m_pEraseTable[dataInd]].index = dataInd;
+    }
+
+    m_pIndices[a_key.index].generation++;
+    m_pIndices[a_key.index].index = INVALID_VALUE;
+    m_pIndices[a_key.index].next = INVALID_VALUE;
+    m_pIndices[m_freeListTail].next = a_key.index;
+    m_freeListTail = a_key.index;
+
+    m_nItems--;
+  }
+
+  template<typename... Ts>
+  template<size_t... Is>
+  void SlotMapSoA<Ts...>::Construct(size_t a_ind, std::index_sequence<Is...>, Ts const &... a_items)
+  {
+    (new (&std::get<Is>(m_columns)[a_ind]) Ts(a_items), ...);
+  }
+
+  template<typename... Ts>
+  template<size_t... Is>
+  void SlotMapSoA<Ts...>::Destruct(size_t a_ind, std::index_sequence<Is...>)
+  {
+    (std::get<Is>(m_columns)[a_ind].~Ts(), ...);
+  }
+
+  template<typename... Ts>
+  template<size_t... Is>
+  void SlotMapSoA<Ts...>::Relocate(size_t a_dest, size_t a_src, std::index_sequence<Is...>)
+  {
+    (memcpy(&std::get<Is>(m_columns)[a_dest], &std::get<Is>(m_columns)[a_src], sizeof(Ts)), ...);
+  }
+
+  template<typename... Ts>
+  template<size_t... Is>
+  void SlotMapSoA<Ts...>::CopyConstruct(SlotMapSoA const & a_other, size_t a_ind, std::index_sequence<Is...>)
+  {
+    (new (&std::get<Is>(m_columns)[a_ind]) Ts(std::get<Is>(a_other.m_columns)[a_ind]), ...);
+  }
+
+  //Columns which were successfully resized are left resized on failure. The
+  //capacity is only committed by the caller once every column has succeeded.
+  template<typename... Ts>
+  template<size_t... Is>
+  bool SlotMapSoA<Ts...>::ReallocColumns(size_t a_size, std::index_sequence<Is...>)
+  {
+    bool good = true;
+    auto realloc_column = [&good, a_size](auto *& a_pColumn)
+    {
+      if (!good)
+        return;
+
+      typedef typename std::remove_reference<decltype(*a_pColumn)>::type ItemType;
+      ItemType * pTemp = static_cast<ItemType *>(realloc(a_pColumn, sizeof(ItemType) * a_size));
+      if (pTemp == nullptr)
+      {
+        good = false;
+        return;
+      }
+      a_pColumn = pTemp;
+    };
+
+    (realloc_column(std::get<Is>(m_columns)), ...);
+    return good;
+  }
+
+  template<typename... Ts>
+  template<size_t... Is>
+  void SlotMapSoA<Ts...>::FreeColumns(std::index_sequence<Is...>)
+  {
+    ((free(std::get<Is>(m_columns)), std::get<Is>(m_columns) = nullptr), ...);
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::Extend()
+  {
+    size_t oldSize = m_poolSize.GetSize();
+    PoolSizeMngr_Default newPoolSize(m_poolSize);
+    size_t newSize = newPoolSize.SetNextPoolSize();
+
+    if (newSize == oldSize)
+      throw std::bad_alloc();
+
+    Ind * tempIndices = static_cast<Ind *>(realloc(m_pIndices, sizeof(Ind) * newSize));
+    if (tempIndices == nullptr)
+      throw std::bad_alloc();
+    m_pIndices = tempIndices;
+
+    size_t * tempEraseTable = static_cast<size_t *>(realloc(m_pEraseTable, sizeof(size_t) * newSize));
+    if (tempEraseTable == nullptr)
+      throw std::bad_alloc();
+    m_pEraseTable = tempEraseTable;
+
+    if (!ReallocColumns(newSize, ColumnIndices()))
+      throw std::bad_alloc();
+
+    m_poolSize = newPoolSize;
+
+    //Append the new slots to the end of the free list
+    if (m_freeListHead == INVALID_VALUE)
+      m_freeListHead = oldSize;
+    else
+      m_pIndices[m_freeListTail].next = oldSize;
+
+    for (size_t i = oldSize; i < newSize; i++)
+      m_pIndices[i].generation = 0;
+    InitFreeList(oldSize, newSize - 1);
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::InitFreeList(size_t a_first, size_t a_last)
+  {
+    for (size_t i = a_first; i <= a_last; i++)
+    {
+      m_pIndices[i].index = INVALID_VALUE;
+      m_pIndices[i].next = i + 1;
+      m_pEraseTable[i] = INVALID_VALUE;
+    }
+    m_pIndices[a_last].next = INVALID_VALUE;
+    m_freeListTail = a_last;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::Init(SlotMapSoA const & a_other)
+  {
+    DestructAll();
+    FreeMemory();
+
+    size_t size = a_other.m_poolSize.GetSize();
+    m_pIndices = static_cast<Ind *>(malloc(sizeof(Ind) * size));
+    m_pEraseTable = static_cast<size_t *>(malloc(sizeof(size_t) * size));
+
+    if (m_pIndices == nullptr
+      || m_pEraseTable == nullptr
+      || !ReallocColumns(size, ColumnIndices()))
+    {
+      FreeMemory();
+      Init(s_default_capacity);
+      throw std::bad_alloc();
+    }
+
+    m_poolSize = a_other.m_poolSize;
+    m_freeListHead = a_other.m_freeListHead;
+    m_freeListTail = a_other.m_freeListTail;
+
+    memcpy(m_pIndices, a_other.m_pIndices, sizeof(Ind) * size);
+    memcpy(m_pEraseTable, a_other.m_pEraseTable, sizeof(size_t) * size);
+
+    for (size_t i = 0; i < a_other.m_nItems; i++)
+      CopyConstruct(a_other, i, ColumnIndices());
+    m_nItems = a_other.m_nItems;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::Init(size_t a_size)
+  {
+    PoolSizeMngr_Default szeMgr(a_size);
+    size_t size = szeMgr.GetSize();
+
+    m_pIndices = static_cast<Ind *>(malloc(sizeof(Ind) * size));
+    m_pEraseTable = static_cast<size_t *>(malloc(sizeof(size_t) * size));
+
+    if (m_pIndices == nullptr
+      || m_pEraseTable == nullptr
+      || !ReallocColumns(size, ColumnIndices()))
+    {
+      FreeMemory();
+      throw std::bad_alloc();
+    }
+
+    m_poolSize = szeMgr;
+    m_nItems = 0;
+
+    for (size_t i = 0; i < size; i++)
+      m_pIndices[i].generation = 0;
+    InitFreeList(0, size - 1);
+    m_freeListHead = 0;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::DestructAll()
+  {
+    for (size_t i = 0; i < m_nItems; i++)
+      Destruct(i, ColumnIndices());
+    m_nItems = 0;
+  }
+
+  template<typename... Ts>
+  void SlotMapSoA<Ts...>::FreeMemory()
+  {
+    free(m_pIndices);
+    free(m_pEraseTable);
+    m_pIndices = nullptr;
+    m_pEraseTable = nullptr;
+    FreeColumns(ColumnIndices());
+  }
+}
+
+#endif
@@ -0,0 +1,513 @@
+//@group Math
+
+#ifndef DGSTENCIL_H
+#define DGSTENCIL_H
+
+#include <array>
+#include <cstddef>
+
+#include "DgHyperArray.h"
+#include "DgWorkerPool.h"
+#include "impl/DgWorkerPoolDispatch.h"
+
+namespace Dg
+{
+  //------------------------------------------------------------------------------
+  // Stencil shapes
+  //------------------------------------------------------------------------------
+
+  /// All points within RADIUS of the centre along every axis. Offsets, and so the
+  /// weights, are in row-major order over the (2*RADIUS + 1)^D cube.
+  template<size_t RADIUS>
+  class StencilShape_Box
+  {
+  public:
+
+    static constexpr size_t Radius = RADIUS;
+
+    template<size_t Dimensions>
+    static constexpr size_t Count()
+    {
+      size_t result = 1;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        result *= 2 * RADIUS + 1;
+      }
+      return result;
+    }
+
+    template<size_t Dimensions>
+    static void GetOffsets(std::array<ptrdiff_t, Dimensions> * a_pOut)
+    {
+      std::array<ptrdiff_t, Dimensions> offset;
+      offset.fill(-static_cast<ptrdiff_t>(RADIUS));
+      for (size_t n = 0; n < Count<Dimensions>(); n++)
+      {
+        a_pOut[n] = offset;
+        for (size_t i = Dimensions; i > 0; i--)
+        {
+          offset[i - 1]++;
+          if (offset[i - 1] <= static_cast<ptrdiff_t>(RADIUS))
+            break;
+          offset[i - 1] = -static_cast<ptrdiff_t>(RADIUS);
+        }
+      }
+    }
+  };
+
+  /// The centre plus points within RADIUS along each axis. The centre comes first,
+  /// followed by -RADIUS..-1, 1..RADIUS for each dimension in turn.
+  template<size_t RADIUS>
+  class StencilShape_Cross
+  {
+  public:
+
+    static constexpr size_t Radius = RADIUS;
+
+    template<size_t Dimensions>
+    static constexpr size_t Count()
+    {
+      return 1 + 2 * RADIUS * Dimensions;
+    }
+
+    template<size_t Dimensions>
+    static void GetOffsets(std::array<ptrdiff_t, Dimensions> * a_pOut)
+    {
+      size_t n = 0;
+      a_pOut[n].fill(0);
+      n++;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        for (ptrdiff_t o = -static_cast<ptrdiff_t>(RADIUS); o <= static_cast<ptrdiff_t>(RADIUS); o++)
+        {
+          if (o == 0)
+            continue;
+          a_pOut[n].fill(0);
+          a_pOut[n][i] = o;
+          n++;
+        }
+      }
+    }
+  };
+
+  //------------------------------------------------------------------------------
+  // Boundary policies
+  //------------------------------------------------------------------------------
+
+  // Each policy maps a possibly out-of-range coordinate to one inside [0, length).
+  // Returning false means the sample lies outside the grid and the engine's
+  // boundary value is used instead.
+
+  /// Samples outside the grid take the value of the nearest edge element.
+  class StencilBoundary_Clamp
+  {
+  public:
+
+    static bool Resolve(ptrdiff_t a_index, size_t a_length, size_t & a_out)
+    {
+      if (a_index < 0)
+        a_out = 0;
+      else if (a_index >= static_cast<ptrdiff_t>(a_length))
+        a_out = a_length - 1;
+      else
+        a_out = static_cast<size_t>(a_index);
+      return true;
+    }
+  };
+
+  /// The grid is periodic.
+  class StencilBoundary_Wrap
+  {
+  public:
+
+    static bool Resolve(ptrdiff_t a_index, size_t a_length, size_t & a_out)
+    {
+      ptrdiff_t len = static_cast<ptrdiff_t>(a_length);
+      ptrdiff_t result = a_index % len;
+      if (result < 0)
+        result += len;
+      a_out = static_cast<size_t>(result);
+      return true;
+    }
+  };
+
+  /// Samples outside the grid read a constant, see StencilEngine::SetBoundaryValue().
+  class StencilBoundary_Constant
+  {
+  public:
+
+    static bool Resolve(ptrdiff_t a_index, size_t a_length, size_t & a_out)
+    {
+      if (a_index < 0 || a_index >= static_cast<ptrdiff_t>(a_length))
+        return false;
+      a_out = static_cast<size_t>(a_index);
+      return true;
+    }
+  };
+
+  //------------------------------------------------------------------------------
+  // StencilEngine
+  //------------------------------------------------------------------------------
+
+  /// Applies a weighted stencil to a grid:
+  ///
+  ///     out(p) = sum_k weights[k] * in(p + offset[k])
+  ///
+  /// The engine owns two grids. Write the initial state into Front(), call Step(),
+  /// and the result is in Front() again; the buffers are swapped after each step.
+  ///
+  /// The grid is split into blocks spanning blockEdge elements along each outer
+  /// dimension and whole rows along the innermost one. Blocks are independent and
+  /// can be dispatched on a WorkerPool. Rows away from the grid edges are computed
+  /// with one unit-stride pass per stencil point, which vectorizes; only elements
+  /// within Radius of an edge go through the boundary policy.
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary = StencilBoundary_Clamp>
+  class StencilEngine
+  {
+    static_assert(Dimensions > 0, "Stencil grids must have at least one dimension");
+
+    StencilEngine(StencilEngine const &) = delete;
+    StencilEngine & operator=(StencilEngine const &) = delete;
+
+  public:
+
+    static constexpr size_t s_nPoints = Shape::template Count<Dimensions>();
+    static constexpr size_t s_radius = Shape::Radius;
+    static constexpr size_t s_defaultBlockEdge = 16;
+
+    /// In the order given by the shape.
+    typedef std::array<T, s_nPoints> Weights;
+
+  public:
+
+    StencilEngine(std::array<size_t, Dimensions> const & a_dimensions);
+
+    HyperArray<T, Dimensions> & Front();
+    HyperArray<T, Dimensions> const & Front() const;
+
+    void SetWeights(Weights const &);
+    Weights const & GetWeights() const;
+
+    /// Value read for samples outside the grid when using StencilBoundary_Constant.
+    void SetBoundaryValue(T const &);
+
+    /// Number of elements along each outer dimension in one block.
+    void SetBlockEdge(size_t);
+
+    /// Run one step on the calling thread.
+    void Step();
+
+    /// Run one step, spreading blocks over the pool and the calling thread.
+    void Step(WorkerPool &);
+
+  private:
+
+    void UpdateBlocks();
+    void ProcessBlock(size_t);
+    void ProcessRow(std::array<size_t, Dimensions> const & rowIndex, size_t x0, size_t x1);
+    T SampleBoundary(std::array<size_t, Dimensions> const & index) const;
+
+  private:
+
+    HyperArray<T, Dimensions>                             m_buffers[2];
+    int                                                   m_front;
+    std::array<size_t, Dimensions>                        m_lengths;
+    std::array<ptrdiff_t, Dimensions>                     m_strides;
+    Weights                                               m_weights;
+    std::array<std::array<ptrdiff_t, Dimensions>, s_nPoints> m_offsets;
+    std::array<ptrdiff_t, s_nPoints>                      m_linearOffsets;
+    T                                                     m_boundaryValue;
+    size_t                                                m_blockEdge;
+    std::array<size_t, Dimensions>                        m_blockExtent;
+    std::array<size_t, Dimensions>                        m_blocksPerDim;
+    size_t                                                m_blockCount;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::StencilEngine()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  StencilEngine<T, Dimensions, Shape, Boundary>::StencilEngine(std::array<size_t, Dimensions> const & a_dimensions)
+    : m_front(0)
+    , m_lengths(a_dimensions)
+    , m_boundaryValue()
+    , m_blockEdge(s_defaultBlockEdge)
+  {
+    m_buffers[0].Set(a_dimensions);
+    m_buffers[1].Set(a_dimensions);
+
+    m_strides[Dimensions - 1] = 1;
+    for (size_t i = Dimensions - 1; i > 0; i--)
+    {
+      m_strides[i - 1] = m_strides[i] * static_cast<ptrdiff_t>(m_lengths[i]);
+    }
+
+    Shape::template GetOffsets<Dimensions>(m_offsets.data());
+    for (size_t k = 0; k < s_nPoints; k++)
+    {
+      m_linearOffsets[k] = 0;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        m_linearOffsets[k] += m_offsets[k][i] * m_strides[i];
+      }
+      m_weights[k] = T();
+    }
+
+    UpdateBlocks();
+  } //End: StencilEngine::StencilEngine()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::Front()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  HyperArray<T, Dimensions> & StencilEngine<T, Dimensions, Shape, Boundary>::Front()
+  {
+    return m_buffers[m_front];
+  } //End: StencilEngine::Front()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::Front()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  HyperArray<T, Dimensions> const & StencilEngine<T, Dimensions, Shape, Boundary>::Front() const
+  {
+    return m_buffers[m_front];
+  } //End: StencilEngine::Front()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::SetWeights()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::SetWeights(Weights const & a_weights)
+  {
+    m_weights = a_weights;
+  } //End: StencilEngine::SetWeights()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::GetWeights()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  typename StencilEngine<T, Dimensions, Shape, Boundary>::Weights const &
+    StencilEngine<T, Dimensions, Shape, Boundary>::GetWeights() const
+  {
+    return m_weights;
+  } //End: StencilEngine::GetWeights()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::SetBoundaryValue()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::SetBoundaryValue(T const & a_val)
+  {
+    m_boundaryValue = a_val;
+  } //End: StencilEngine::SetBoundaryValue()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::SetBlockEdge()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::SetBlockEdge(size_t a_edge)
+  {
+    m_blockEdge = (a_edge == 0) ? 1 : a_edge;
+    UpdateBlocks();
+  } //End: StencilEngine::SetBlockEdge()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::UpdateBlocks()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::UpdateBlocks()
+  {
+    m_blockCount = 1;
+    for (size_t i = 0; i < Dimensions; i++)
+    {
+      if (i == Dimensions - 1)
+      {
+        //Whole rows, unless the grid is a single row; then split it up.
+        m_blockExtent[i] = (Dimensions == 1) ? m_blockEdge * m_blockEdge * m_blockEdge : m_lengths[i];
+      }
+      else
+      {
+        m_blockExtent[i] = m_blockEdge;
+      }
+
+      if (m_blockExtent[i] == 0)
+        m_blockExtent[i] = 1;
+
+      m_blocksPerDim[i] = (m_lengths[i] + m_blockExtent[i] - 1) / m_blockExtent[i];
+      m_blockCount *= m_blocksPerDim[i];
+    }
+  } //End: StencilEngine::UpdateBlocks()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::Step()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::Step()
+  {
+    for (size_t b = 0; b < m_blockCount; b++)
+    {
+      ProcessBlock(b);
+    }
+    m_front = 1 - m_front;
+  } //End: StencilEngine::Step()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::Step()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::Step(WorkerPool & a_pool)
+  {
+    impl::DispatchBlocks(a_pool, m_blockCount, [this](size_t a_block) { ProcessBlock(a_block); });
+    m_front = 1 - m_front;
+  } //End: StencilEngine::Step()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::ProcessBlock()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::ProcessBlock(size_t a_block)
+  {
+    std::array<size_t, Dimensions> begin;
+    std::array<size_t, Dimensions> end;
+    for (size_t i = Dimensions; i > 0; i--)
+    {
+      size_t d = i - 1;
+      size_t blockCoord = a_block % m_blocksPerDim[d];
+      a_block /= m_blocksPerDim[d];
+      begin[d] = blockCoord * m_blockExtent[d];
+      end[d] = begin[d] + m_blockExtent[d];
+      if (end[d] > m_lengths[d])
+        end[d] = m_lengths[d];
+    }
+
+    //Walk the rows of the block; the innermost coordinate is ignored.
+    std::array<size_t, Dimensions> row = begin;
+    while (true)
+    {
+      ProcessRow(row, begin[Dimensions - 1], end[Dimensions - 1]);
+
+      size_t d = Dimensions - 1;
+      while (d > 0)
+      {
+        d--;
+        row[d]++;
+        if (row[d] < end[d])
+          break;
+        row[d] = begin[d];
+        if (d == 0)
+          return;
+      }
+
+      if (Dimensions == 1)
+        return;
+    }
+  } //End: StencilEngine::ProcessBlock()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::SampleBoundary()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  T StencilEngine<T, Dimensions, Shape, Boundary>::SampleBoundary(std::array<size_t, Dimensions> const & a_index) const
+  {
+    T const * pIn = m_buffers[m_front].data();
+    T result = T();
+    for (size_t k = 0; k < s_nPoints; k++)
+    {
+      ptrdiff_t offset = 0;
+      bool inside = true;
+      for (size_t i = 0; i < Dimensions; i++)
+      {
+        size_t coord;
+        if (!Boundary::Resolve(static_cast<ptrdiff_t>(a_index[i]) + m_offsets[k][i], m_lengths[i], coord))
+        {
+          inside = false;
+          break;
+        }
+        offset += static_cast<ptrdiff_t>(coord) * m_strides[i];
+      }
+      result += m_weights[k] * (inside ? pIn[offset] : m_boundaryValue);
+    }
+    return result;
+  } //End: StencilEngine::SampleBoundary()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ StencilEngine::ProcessRow()
+  //-------------------------------------------------------------------------------
+  template<typename T, size_t Dimensions, typename Shape, typename Boundary>
+  void StencilEngine<T, Dimensions, Shape, Boundary>::ProcessRow(std::array<size_t, Dimensions> const & a_row,
+                                                                 size_t a_x0, size_t a_x1)
+  {
+    ptrdiff_t rowOffset = 0;
+    bool interiorRow = true;
+    for (size_t i = 0; i + 1 < Dimensions; i++)
+    {
+      rowOffset += static_cast<ptrdiff_t>(a_row[i]) * m_strides[i];
+      if (a_row[i] < s_radius || a_row[i] + s_radius >= m_lengths[i])
+        interiorRow = false;
+    }
+
+    T const * pIn = m_buffers[m_front].data() + rowOffset;
+    T * pOut = m_buffers[1 - m_front].data() + rowOffset;
+
+    //The span of the row where every sample is inside the grid.
+    size_t len = m_lengths[Dimensions - 1];
+    size_t fast0 = a_x0;
+    size_t fast1 = a_x0;
+    if (interiorRow && len > 2 * s_radius)
+    {
+      fast0 = a_x0 > s_radius ? a_x0 : s_radius;
+      fast1 = a_x1 < len - s_radius ? a_x1 : len - s_radius;
+      if (fast1 < fast0)
+        fast1 = fast0;
+    }
+
+    std::array<size_t, Dimensions> index = a_row;
+    for (size_t x = a_x0; x < fast0; x++)
+    {
+      index[Dimensions - 1] = x;
+      pOut[x] = SampleBoundary(index);
+    }
+
+    if (fast1 > fast0)
+    {
+      T * pDst = pOut + fast0;
+      size_t n = fast1 - fast0;
+      for (size_t x = 0; x < n; x++)
+      {
+        pDst[x] = T();
+      }
+
+      for (size_t k = 0; k < s_nPoints; k++)
+      {
+        T const w = m_weights[k];
+        T const * pSrc = pIn + static_cast<ptrdiff_t>(fast0) + m_linearOffsets[k];
+        for (size_t x = 0; x < n; x++)
+        {
+          pDst[x] += w * pSrc[x];
+        }
+      }
+    }
+
+    for (size_t x = fast1; x < a_x1; x++)
+    {
+      index[Dimensions - 1] = x;
+      pOut[x] = SampleBoundary(index);
+    }
+  } //End: StencilEngine::ProcessRow()
+}
+
+#endif
@@ -0,0 +1,315 @@
+//@group Misc
+
+#ifndef DGTASKFUTURE_H
+#define DGTASKFUTURE_H
+
+#include <atomic>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#include "impl/DgTaskAllocator.h"
+
+namespace Dg
+{
+  class WorkerPool;
+
+  namespace impl
+  {
+    // State shared between a TaskFuture and the task which fulfils it.
+    // Reference counted; freed by whichever of the two lets go last.
+    struct FutureStateBase
+    {
+      std::atomic<uint32_t> ready;
+      std::atomic<uint32_t> waiters;
+      std::atomic<uint32_t> refs;
+      WorkerPool * pPool;
+      std::exception_ptr exception;
+      void (*destroy)(FutureStateBase *);
+
+      bool IsReady() const
+      {
+        return ready.load(std::memory_order_acquire) != 0;
+      }
+
+      void Release()
+      {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          destroy(this);
+      }
+
+      // Publishes the result and wakes any waiters.
+      void SetReady();
+
+      // Runs other tasks from the pool until ready, parking if there are none.
+      void Wait();
+    };
+
+    template<typename T>
+    struct FutureState : public FutureStateBase
+    {
+      typedef typename std::conditional<std::is_void<T>::value, char, T>::type StorageType;
+      static_assert(alignof(StorageType) <= TaskAllocator::s_alignment, "Over-aligned results are not supported");
+
+      typename std::aligned_storage<sizeof(StorageType), alignof(StorageType)>::type value;
+      bool hasValue;
+
+      StorageType * Value()
+      {
+        return reinterpret_cast<StorageType *>(&value);
+      }
+
+      static FutureState * Create(WorkerPool * a_pPool)
+      {
+        void * pMem = TaskAllocator::Allocate(sizeof(FutureState));
+        if (pMem == nullptr)
+          return nullptr;
+
+        FutureState * pState = new (pMem) FutureState();
+        pState->ready.store(0, std::memory_order_relaxed);
+        pState->waiters.store(0, std::memory_order_relaxed);
+        pState->refs.store(2, std::memory_order_relaxed);
+        pState->pPool = a_pPool;
+        pState->destroy = Destroy;
+        pState->hasValue = false;
+        return pState;
+      }
+
+      static void Destroy(FutureStateBase * a_pBase)
+      {
+        FutureState * pState = static_cast<FutureState *>(a_pBase);
+        if constexpr (!std::is_void<T>::value)
+        {
+          if (pState->hasValue)
+            pState->Value()->~T();
+        }
+        pState->~FutureState();
+        TaskAllocator::Free(pState, sizeof(FutureState));
+      }
+
+      template<typename Fn>
+      void Run(Fn & a_fn)
+      {
+        try
+        {
+          if constexpr (std::is_void<T>::value)
+          {
+            a_fn();
+          }
+          else
+          {
+            new (&value) T(a_fn());
+            hasValue = true;
+          }
+        }
+        catch (...)
+        {
+          exception = std::current_exception();
+        }
+        SetReady();
+      }
+    };
+
+    // The callable queued on the pool for a task with a future.
+    template<typename Fn, typename T>
+    struct FutureTask
+    {
+      Fn fn;
+      FutureState<T> * pState;
+
+      template<typename Arg>
+      FutureTask(Arg && a_fn, FutureState<T> * a_pState)
+        : fn(std::forward<Arg>(a_fn))
+        , pState(a_pState)
+      {}
+
+      FutureTask(FutureTask && a_other)
+        : fn(std::move(a_other.fn))
+        , pState(a_other.pState)
+      {
+        a_other.pState = nullptr;
+      }
+
+      FutureTask(FutureTask const &) = delete;
+      FutureTask & operator=(FutureTask const &) = delete;
+      FutureTask & operator=(FutureTask &&) = delete;
+
+      ~FutureTask()
+      {
+        if (pState == nullptr)
+          return;
+
+        // Dropped without running, for example by a pool being destroyed.
+        if (!pState->IsReady())
+        {
+          pState->exception = std::make_exception_ptr(std::runtime_error("Task was destroyed before it ran"));
+          pState->SetReady();
+        }
+        pState->Release();
+      }
+
+      void operator()()
+      {
+        pState->Run(fn);
+      }
+    };
+  }
+
+  // The result of a task added with WorkerPool::AddTask(fn, future).
+  //
+  // Wait() and Get() do not simply block: while the result is not ready the
+  // calling thread runs other queued tasks from the pool, and only parks (on a
+  // futex where available) once there is nothing left for it to do.
+  //
+  // Move only. Get() may be called once.
+  template<typename T>
+  class TaskFuture
+  {
+    TaskFuture(TaskFuture const &) = delete;
+    TaskFuture & operator=(TaskFuture const &) = delete;
+
+  public:
+
+    TaskFuture();
+    ~TaskFuture();
+
+    TaskFuture(TaskFuture &&);
+    TaskFuture & operator=(TaskFuture &&);
+
+    // True if this future is attached to a task.
+    bool IsValid() const;
+
+    // True once the task has finished. Never blocks.
+    bool IsReady() const;
+
+    // Returns once the task has finished.
+    void Wait();
+
+    // Waits, then returns the task's result, or rethrows the exception it threw.
+    // Throws std::logic_error if the future is not attached to a task.
+    T Get();
+
+    // Detaches from the task, which still runs.
+    void Reset();
+
+  private:
+
+    friend class WorkerPool;
+
+    impl::FutureState<T> * m_pState;
+  };
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::TaskFuture()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  TaskFuture<T>::TaskFuture()
+    : m_pState(nullptr)
+  {
+
+  } //End: TaskFuture::TaskFuture()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::~TaskFuture()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  TaskFuture<T>::~TaskFuture()
+  {
+    Reset();
+  } //End: TaskFuture::~TaskFuture()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::TaskFuture()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  TaskFuture<T>::TaskFuture(TaskFuture && a_other)
+    : m_pState(a_other.m_pState)
+  {
+    a_other.m_pState = nullptr;
+  } //End: TaskFuture::TaskFuture()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  TaskFuture<T> & TaskFuture<T>::operator=(TaskFuture && a_other)
+  {
+    if (this != &a_other)
+    {
+      Reset();
+      m_pState = a_other.m_pState;
+      a_other.m_pState = nullptr;
+    }
+    return *this;
+  } //End: TaskFuture::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::IsValid()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool TaskFuture<T>::IsValid() const
+  {
+    return m_pState != nullptr;
+  } //End: TaskFuture::IsValid()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::IsReady()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool TaskFuture<T>::IsReady() const
+  {
+    return m_pState != nullptr && m_pState->IsReady();
+  } //End: TaskFuture::IsReady()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::Wait()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void TaskFuture<T>::Wait()
+  {
+    if (m_pState != nullptr && !m_pState->IsReady())
+      m_pState->Wait();
+  } //End: TaskFuture::Wait()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::Get()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  T TaskFuture<T>::Get()
+  {
+    if (m_pState == nullptr)
+      throw std::logic_error("TaskFuture has no task");
+
+    Wait();
+    if (m_pState->exception)
+      std::rethrow_exception(m_pState->exception);
+
+    if constexpr (!std::is_void<T>::value)
+      return std::move(*m_pState->Value());
+  } //End: TaskFuture::Get()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ TaskFuture::Reset()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void TaskFuture<T>::Reset()
+  {
+    if (m_pState != nullptr)
+      m_pState->Release();
+    m_pState = nullptr;
+  } //End: TaskFuture::Reset()
+}
+
+#endif
@@ -0,0 +1,104 @@
+//@group Misc
+
+#ifndef DGTASKGRAPH_H
+#define DGTASKGRAPH_H
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+#include "DgError.h"
+#include "DgWorkerPool.h"
+
+namespace Dg
+{
+  // A set of tasks with dependencies between them, run on a WorkerPool.
+  //
+  // Each task carries a join counter holding the number of its predecessors
+  // which have not finished. The thread that finishes a task decrements the
+  // counters of its successors; any which reach zero are ready. One ready
+  // successor is run straight away on the same thread as a continuation, the
+  // rest are added to the pool. The graph therefore runs to completion without
+  // any round-trips through the main thread.
+  //
+  // Build the graph, then Launch() it. A graph can be launched again once it
+  // has completed. It must not be modified or destroyed while running.
+  // User data is never freed by the graph.
+  class TaskGraph
+  {
+    TaskGraph(TaskGraph const &) = delete;
+    TaskGraph & operator=(TaskGraph const &) = delete;
+
+  public:
+
+    typedef uint32_t Handle;
+    static Handle const INVALID_HANDLE = 0xFFFFFFFF;
+
+    TaskGraph();
+    ~TaskGraph();
+
+    Handle AddTask(WorkerPoolCallback func, void * pUserData = nullptr);
+
+    // a_after will not start until a_before has finished.
+    ErrorCode AddDependency(Handle before, Handle after);
+
+    // Adds a task which runs once a_before has finished.
+    Handle AddContinuation(Handle before, WorkerPoolCallback func, void * pUserData = nullptr);
+
+    // Removes all tasks and dependencies.
+    ErrorCode Clear();
+
+    // Starts running the graph on the pool and returns immediately.
+    // Fails with InvalidInput if the dependencies contain a cycle, and with
+    // Disallowed if the graph is already running.
+    ErrorCode Launch(WorkerPool &);
+
+    // True once every task of the last launch has finished.
+    bool IsComplete() const;
+
+    uint32_t TaskCount() const;
+
+  private:
+
+    struct Task
+    {
+      WorkerPoolCallback  function;
+      void *              pUserData;
+    };
+
+    struct Edge
+    {
+      Handle before;
+      Handle after;
+    };
+
+    // Passed to the pool as user data.
+    struct RunTask
+    {
+      TaskGraph *             pGraph;
+      std::atomic<uint32_t>   joinCount;
+    };
+
+    static void Execute(void *);
+    ErrorCode BuildSchedule();
+    void Submit(Handle);
+
+  private:
+
+    std::vector<Task>           m_tasks;
+    std::vector<Edge>           m_edges;
+
+    // Built at launch: the successors of task i are
+    // m_successors[m_successorStart[i]] to m_successors[m_successorStart[i + 1] - 1]
+    std::vector<uint32_t>       m_successorStart;
+    std::vector<uint32_t>       m_successors;
+    std::vector<uint32_t>       m_predecessorCount;
+
+    RunTask *                   m_pRunTasks;
+    uint32_t                    m_runTaskCount;
+    WorkerPool *                m_pPool;
+    std::atomic<uint32_t>       m_remaining;
+  };
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "DgPair.h"
 #include "impl/DgPoolSizeManager.h"
+#include "impl/DgContainerStats.h"
 
 namespace Dg
 {
@@ -42,7 +43,8 @@ namespace Dg
     typename KeyType, 
     typename ValueType, 
     KeyType(*GET_KEY)(ValueType const &),
-    bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>>
+    bool (*Compare)(KeyType const &, KeyType const &) = impl::Less<KeyType>,
+    typename POOL = PoolSizeMngr_Default>
   class Tree_AVL
   {
     typedef size_t sizeType;
@@ -245,6 +247,13 @@ namespace Dg
     iterator lower_bound(KeyType const & a_key) const;
 
     void clear();
+
+    //! Reduce the reserve to the smallest pool size which holds the current
+    //! elements. Invalidates iterators.
+    void shrink_to_fit();
+
+    //! Memory and occupancy snapshot, including the tree height.
+    ContainerStats GetStats() const;
     
     //impl::DebugTreeNode *GetDebugTree(impl::DebugTreeNode **ppRoot, std::string (*ToString)(KeyType) = impl::DefaultValueToString<KeyType>) const;
 
@@ -285,6 +294,10 @@ namespace Dg
     bool ValueExists(KeyType const & a_value, Node *& a_out) const;
 
     void Extend();
+
+    //Moves the nodes to a block of the new size and fixes up the links.
+    //Assumes the new size holds all current nodes.
+    void Reallocate(POOL const &);
     int GetBalance(Node *) const;
 
     // A utility function to get height  
@@ -309,7 +322,7 @@ namespace Dg
 
   protected:
 
-    PoolSizeMngr_Default m_poolSize;
+    POOL m_poolSize;
     Node *          m_pRoot;
     Node *          m_pNodes;
     sizeType        m_nItems;
@@ -318,8 +331,8 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // EraseData
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::EraseData::EraseData()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::EraseData::EraseData()
     : oldNodeAdd(nullptr)
     , newNodeAdd(nullptr)
     , pNext(nullptr)
@@ -331,97 +344,97 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // const_iterator_rand
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::const_iterator_rand(Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node const * a_pNode)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::const_iterator_rand(Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node const * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::const_iterator_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::const_iterator_rand()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::~const_iterator_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::~const_iterator_rand()
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::const_iterator_rand(const_iterator_rand const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::const_iterator_rand(const_iterator_rand const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator=(const_iterator_rand const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator=(const_iterator_rand const & a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator==(const_iterator_rand const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator==(const_iterator_rand const & a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator!=(const_iterator_rand const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator!=(const_iterator_rand const & a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator++()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator++()
   {
     m_pNode++;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator++(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator++(int)
   {
     const_iterator_rand result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator--()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator--()
   {
     m_pNode--;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator--(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator--(int)
   {
     const_iterator_rand result(*this);
     --(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType const * 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator->() const
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator->() const
   {
     return &(m_pNode->data);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType const & 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand::operator*() const
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand::operator*() const
   {
     return m_pNode->data;
   }
@@ -429,104 +442,104 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // iterator_rand
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::iterator_rand(Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node * a_pNode)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::iterator_rand(Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::iterator_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::iterator_rand()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::~iterator_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::~iterator_rand()
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::iterator_rand(iterator_rand const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::iterator_rand(iterator_rand const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator=(iterator_rand const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator=(iterator_rand const & a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator==(iterator_rand const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator==(iterator_rand const & a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator!=(iterator_rand const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator!=(iterator_rand const & a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator++()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator++()
   {
     m_pNode++;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator++(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator++(int)
   {
     iterator_rand result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator--()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator--()
   {
     m_pNode--;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator--(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator--(int)
   {
     iterator_rand result(*this);
     --(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator
-    typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator
+    typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand() const
   {
-    return Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator_rand(m_pNode);
+    return Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator_rand(m_pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType * 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator->()
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator->()
   {
     return &(m_pNode->data);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType & 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator_rand::operator*()
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator_rand::operator*()
   {
     return m_pNode->data;
   }
@@ -535,56 +548,56 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // const_iterator
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::const_iterator(Node const * a_pNode)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::const_iterator(Node const * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::const_iterator()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::const_iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::~const_iterator()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::~const_iterator()
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::const_iterator(const_iterator const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::const_iterator(const_iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator=(const_iterator const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator=(const_iterator const & a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator==(const_iterator const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator==(const_iterator const & a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator!=(const_iterator const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator!=(const_iterator const & a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator+(size_t a_val) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator+(size_t a_val) const
   {
     Node const * pNode = m_pNode;
     for (size_t i = 0; i < a_val; i++)
@@ -592,9 +605,9 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator-(size_t a_val) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator-(size_t a_val) const
   {
     Node const * pNode = m_pNode;
     for (size_t i = 0; i < a_val; i++)
@@ -602,68 +615,68 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator+=(size_t a_val)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->GetNext();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator-=(size_t a_val)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->GetPrevious();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator++()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator++()
   {
     m_pNode = m_pNode->GetNext();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator++(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator++(int)
   {
     const_iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator--()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator--()
   {
     m_pNode = m_pNode->GetPrevious();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator--(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator--(int)
   {
     const_iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType const * 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator->() const
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator->() const
   {
     return &(m_pNode->data);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType const & 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator::operator*() const
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator::operator*() const
   {
     return m_pNode->data;
   }
@@ -671,56 +684,56 @@ namespace Dg
   //------------------------------------------------------------------------------------------------
   // iterator
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::iterator(Node * a_pNode)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::iterator(Node * a_pNode)
     : m_pNode(a_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::iterator()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::iterator()
     : m_pNode(nullptr)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::~iterator()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::~iterator()
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::iterator(iterator const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::iterator(iterator const & a_it)
     : m_pNode(a_it.m_pNode)
   {
 
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator=(iterator const & a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator=(iterator const & a_it)
   {
     m_pNode = a_it.m_pNode;
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator==(iterator const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator==(iterator const & a_it) const
   {
     return m_pNode == a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator!=(iterator const & a_it) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator!=(iterator const & a_it) const
   {
     return m_pNode != a_it.m_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator+(size_t a_val) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator+(size_t a_val) const
   {
     Node * pNode = m_pNode;
     for (size_t i = 0; i < a_val; i++)
@@ -728,9 +741,9 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator-(size_t a_val) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator-(size_t a_val) const
   {
     Node * pNode = m_pNode;
     for (size_t i = 0; i < a_val; i++)
@@ -738,84 +751,84 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator+=(size_t a_val)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator+=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->GetNext();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator-=(size_t a_val)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator-=(size_t a_val)
   {
     for (size_t i = 0; i < a_val; i++)
       m_pNode = m_pNode->GetPrevious();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator++()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator++()
   {
     m_pNode = m_pNode->GetNext();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator++(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator++(int)
   {
     iterator result(*this);
     ++(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator--()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator--()
   {
     m_pNode = m_pNode->GetPrevious();
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator--(int)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator--(int)
   {
     iterator result(*this);
     --(*this);
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType * 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator->()
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator->()
   {
     return &(m_pNode->data);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   ValueType & 
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator*()
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator*()
   {
     return m_pNode->data;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator::operator
-    typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator::operator
+    typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator() const
   {
-    return Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::const_iterator(m_pNode);
+    return Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::const_iterator(m_pNode);
   }
 
   //------------------------------------------------------------------------------------------------
   // Tree_AVL
   //------------------------------------------------------------------------------------------------
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL()
     : m_pNodes(nullptr)
     , m_nItems(0)
     , m_pRoot(nullptr)
@@ -824,8 +837,8 @@ namespace Dg
     InitDefaultNode();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL(sizeType a_request)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL(sizeType a_request)
     : m_pNodes(nullptr)
     , m_nItems(0)
     , m_pRoot(nullptr)
@@ -835,15 +848,15 @@ namespace Dg
     InitDefaultNode();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::~Tree_AVL()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::~Tree_AVL()
   {
     DestructAll();
     free(m_pNodes);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL(Tree_AVL const & a_other)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL(Tree_AVL const & a_other)
     : m_poolSize(a_other.m_poolSize)
     , m_pNodes(nullptr)
     , m_nItems(0)
@@ -853,9 +866,9 @@ namespace Dg
     Init(a_other);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare> &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::operator=(Tree_AVL const & a_other)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL> &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::operator=(Tree_AVL const & a_other)
   {
     if (this != &a_other)
     {
@@ -878,8 +891,8 @@ namespace Dg
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL(Tree_AVL && a_other) noexcept
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL(Tree_AVL && a_other) noexcept
     : m_poolSize(a_other.m_poolSize)
     , m_pNodes(a_other.m_pNodes)
     , m_nItems(a_other.m_nItems)
@@ -890,9 +903,9 @@ namespace Dg
     a_other.m_pRoot = nullptr;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  Tree_AVL<KeyType, ValueType, GET_KEY, Compare> &
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::operator=(Tree_AVL && a_other) noexcept
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL> &
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::operator=(Tree_AVL && a_other) noexcept
   {
     if (this != &a_other)
     {
@@ -908,50 +921,50 @@ namespace Dg
     return *this;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::sizeType
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::size() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::sizeType
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::size() const
   {
     return m_nItems;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::empty() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::empty() const
   {
     return m_nItems == 0;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::begin_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::begin_rand()
   {
     return iterator_rand(m_pNodes + 1);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::end_rand()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::end_rand()
   {
     return iterator_rand(m_pNodes + m_nItems + 1);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::const_iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::cbegin_rand() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::const_iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::cbegin_rand() const
   {
     return const_iterator_rand(m_pNodes + 1);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::const_iterator_rand
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::cend_rand() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::const_iterator_rand
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::cend_rand() const
   {
     return const_iterator_rand(m_pNodes + m_nItems + 1);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::begin()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::begin()
   {
     Node * pNode = m_pRoot;
     while (pNode->pLeft != nullptr)
@@ -959,16 +972,16 @@ namespace Dg
     return iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::end()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::end()
   {
     return iterator(m_pNodes);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::cbegin() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::cbegin() const
   {
     Node * pNode = m_pRoot;
     while (pNode->pLeft != nullptr)
@@ -976,16 +989,16 @@ namespace Dg
     return const_iterator(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::cend() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::cend() const
   {
     return const_iterator(m_pNodes);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::const_iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::find(KeyType const & a_value) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::const_iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::find(KeyType const & a_value) const
   {
     Node * pNode;
     if (ValueExists(a_value, pNode))
@@ -993,9 +1006,9 @@ namespace Dg
     return cend();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::find(KeyType const & a_value)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::find(KeyType const & a_value)
   {
     Node * pNode;
     if (ValueExists(a_value, pNode))
@@ -1003,8 +1016,8 @@ namespace Dg
     return end();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::insert(ValueType const & a_value)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::insert(ValueType const & a_value)
   {
     if ((m_nItems + 1) == m_poolSize.GetSize())
       Extend();
@@ -1014,31 +1027,31 @@ namespace Dg
     return iterator(foundNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::erase(KeyType const & a_value)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::erase(KeyType const & a_value)
   {
     EraseData eData;
     m_pRoot = __Erase<false>(m_pRoot, a_value, eData);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::erase(iterator a_it)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::erase(iterator a_it)
   {
     EraseData eData;
     m_pRoot = __Erase<true>(m_pRoot, GET_KEY(*a_it), eData);
     return iterator(eData.pNext);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::exists(KeyType const & a_value) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::exists(KeyType const & a_value) const
   {
     Node * pNode;
     return ValueExists(a_value, pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::iterator Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::lower_bound(KeyType const & a_key) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::iterator Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::lower_bound(KeyType const & a_key) const
   {
     Node * pNode = m_pRoot;
     Node const * pNodeGreater = EndNode();
@@ -1069,31 +1082,46 @@ namespace Dg
     return iterator(const_cast<Node *>(pNodeGreater));
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Tree_AVL::clear()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Tree_AVL::clear()
   {
     DestructAll();
     m_nItems = 0;
     InitDefaultNode();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::DestructAll()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  ContainerStats Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::GetStats() const
+  {
+    //Node 0 is reserved as the end node.
+    ContainerStats stats;
+    stats.elementCount = m_nItems;
+    stats.capacity = m_poolSize.GetSize() - 1;
+    stats.bytesReserved = m_poolSize.GetSize() * sizeof(Node);
+    stats.bytesUsed = (m_nItems + 1) * sizeof(Node);
+    stats.poolSizeIndex = m_poolSize.GetIndex();
+    stats.poolResizes = m_poolSize.GetResizeCount();
+    stats.treeHeight = m_nItems == 0 ? 0 : m_pRoot->height;
+    return stats;
+  }
+
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::DestructAll()
   {
     for (sizeType i = 1; i <= m_nItems; i++)
       m_pNodes[i].data.~ValueType();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::InitMemory()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::InitMemory()
   {
     m_pNodes = static_cast<Node*> (realloc(m_pNodes, m_poolSize.GetSize() * sizeof(Node)));
     if (m_pNodes == nullptr)
       throw std::bad_alloc();
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::InitDefaultNode()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::InitDefaultNode()
   {
     m_pRoot = m_pNodes;
     m_pNodes[0].pParent = nullptr;
@@ -1102,8 +1130,8 @@ namespace Dg
     m_pNodes[0].height = 0;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Init(Tree_AVL const & a_other)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Init(Tree_AVL const & a_other)
   {
     m_nItems = a_other.m_nItems;
 
@@ -1133,8 +1161,8 @@ namespace Dg
     m_pRoot->pParent = nullptr;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::ValueExists(KeyType const & a_key, Node *& a_out) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  bool Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::ValueExists(KeyType const & a_key, Node *& a_out) const
   {
     a_out = m_pRoot;
     bool result = false;
@@ -1163,24 +1191,35 @@ namespace Dg
     return result;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Extend()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Extend()
   {
-    size_t oldSize = m_poolSize.GetSize();
-    m_poolSize.SetNextPoolSize();
-    Node * oldNodes = m_pNodes;
+    POOL poolSize(m_poolSize);
+    poolSize.SetNextPoolSize();
+    Reallocate(poolSize);
+  }
 
-    size_t s = sizeof(Node);
-    size_t v = sizeof(ValueType);
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::shrink_to_fit()
+  {
+    //Keep room for the end node.
+    POOL poolSize(m_poolSize);
+    poolSize.SetSize(m_nItems + 1);
+    if (poolSize.GetSize() < m_poolSize.GetSize())
+      Reallocate(poolSize);
+  }
 
-    Node * pNodesTemp = static_cast<Node*> (realloc(m_pNodes, m_poolSize.GetSize() * sizeof(Node)));
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  void Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Reallocate(POOL const & a_poolSize)
+  {
+    Node * oldNodes = m_pNodes;
+
+    Node * pNodesTemp = static_cast<Node*> (realloc(m_pNodes, a_poolSize.GetSize() * sizeof(Node)));
     if (pNodesTemp == nullptr)
-    {
-      m_poolSize.SetSize(oldSize);
       throw std::bad_alloc();
-    }
 
     m_pNodes = pNodesTemp;
+    m_poolSize = a_poolSize;
 
     if (oldNodes != m_pNodes)
     {
@@ -1201,25 +1240,25 @@ namespace Dg
     }
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  int Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::GetBalance(Node * a_pNode) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  int Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::GetBalance(Node * a_pNode) const
   {  
     if (a_pNode == nullptr)
       return 0;  
     return Height(a_pNode->pLeft) - Height(a_pNode->pRight);  
   } 
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  int Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Height(Node * a_pNode) const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  int Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Height(Node * a_pNode) const
   {  
     if (a_pNode == nullptr)  
       return 0;  
     return a_pNode->height;  
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::LeftRotate(Node * a_x)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::LeftRotate(Node * a_x)
   {  
     Node * y = a_x->pRight;
     Node * T2 = y->pLeft;  
@@ -1251,9 +1290,9 @@ namespace Dg
     return y;  
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::RightRotate(Node * a_y)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::RightRotate(Node * a_y)
   { 
     Node * x = a_y->pLeft;
     Node * T2 = x->pRight;  
@@ -1285,9 +1324,9 @@ namespace Dg
     return x;  
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::NewNode(Node * a_pParent, ValueType const & a_value)
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::NewNode(Node * a_pParent, ValueType const & a_value)
   {
     //Insert data
     m_nItems++;
@@ -1303,23 +1342,23 @@ namespace Dg
     return newNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::EndNode()
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::EndNode()
   {
     return m_pNodes;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node const *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::EndNode() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node const *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::EndNode() const
   {
     return m_pNodes;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::__Insert(Node * a_pNode, Node * a_pParent,
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::__Insert(Node * a_pNode, Node * a_pParent,
                                                              ValueType const & a_value,
                                                              Node *& a_newNode)
   {
@@ -1383,10 +1422,10 @@ namespace Dg
     return a_pNode;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
   template<bool GetNext>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node *
-    Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::__Erase(Node * a_pRoot, KeyType const & a_key, EraseData & a_data)
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node *
+    Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::__Erase(Node * a_pRoot, KeyType const & a_key, EraseData & a_data)
   {
     if (a_pRoot == nullptr || a_pRoot == EndNode())
       return a_pRoot;
@@ -1593,8 +1632,8 @@ namespace Dg
     return a_pRoot;
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node * Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node::GetNext() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node * Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node::GetNext() const
   {
     //Try right
     if (pRight != nullptr)
@@ -1617,8 +1656,8 @@ namespace Dg
     return const_cast<Node*>(pNode);
   }
 
-  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &)>
-  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node * Tree_AVL<KeyType, ValueType, GET_KEY, Compare>::Node::GetPrevious() const
+  template<typename KeyType, typename ValueType, KeyType(*GET_KEY)(ValueType const &), bool (*Compare)(KeyType const &, KeyType const &), typename POOL>
+  typename Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node * Tree_AVL<KeyType, ValueType, GET_KEY, Compare, POOL>::Node::GetPrevious() const
   {
     //Try left
     if (pLeft != nullptr)
@@ -13,6 +13,8 @@
 #include <sstream>
 
 #include "DgDynamicArray.h"
+#include "DgWorkerPool.h"
+#include "impl/DgWorkerPoolDispatch.h"
 
 //TODO check for nullptr returns in realloc and throw
 namespace Dg
@@ -73,12 +75,28 @@ namespace Dg
     size_t elements(size_t a_row) const
     {
       rangeCheckRow(a_row);
-      return m_indices.size();
+      return m_indices[a_row].count;
     }
 
-    //! Add element to the back of the array.
+    //! Add a row to the back of the array.
     void push_back(T const * pItems, size_t count);
 
+    //! Append elements to the last row. If there are no rows, a new row is added.
+    void extend_last_row(T const * pItems, size_t count);
+
+    //! Replace the contents with nRows rows in two passes. First, countFn(row)
+    //! returns the number of elements in each row. After a prefix sum over the
+    //! counts the whole data buffer is allocated at once, then
+    //! fillFn(row, T * pOut, count) writes each row in place. pOut points to
+    //! unconstructed memory, so use for pod types.
+    template<typename CountFn, typename FillFn>
+    void build(size_t nRows, CountFn const & countFn, FillFn const & fillFn);
+
+    //! As build(), with both passes spread over the worker pool. countFn and
+    //! fillFn are called concurrently for different rows.
+    template<typename CountFn, typename FillFn>
+    void build(WorkerPool &, size_t nRows, CountFn const & countFn, FillFn const & fillFn);
+
     void clear();
 
   private:
@@ -86,6 +104,12 @@ namespace Dg
     void rangeCheck(size_t a_row, size_t a_element) const;
     void rangeCheckRow(size_t a_row) const;
 
+    //! Turns the row counts into row starts and returns the total element count.
+    size_t prefixSum();
+
+    //! Rows per block when building in parallel
+    static size_t const s_buildBlockSize = 4096;
+
     //Data members
     struct Index
     {
@@ -156,8 +180,82 @@ namespace Dg
 
     m_indices.push_back(ind);
 
+    T * pData = m_data.append_uninitialized(a_count);
     for (size_t i = 0; i < a_count; i++)
-      m_data.push_back(a_pItems[i]);
+      new (&pData[i]) T(a_pItems[i]);
+  }
+
+  template<class T>
+  void VariableArray2D<T>::extend_last_row(T const * a_pItems, size_t a_count)
+  {
+    if (m_indices.empty())
+    {
+      push_back(a_pItems, a_count);
+      return;
+    }
+
+    //The last row always ends at the back of the data array.
+    m_indices.back().count += a_count;
+
+    T * pData = m_data.append_uninitialized(a_count);
+    for (size_t i = 0; i < a_count; i++)
+      new (&pData[i]) T(a_pItems[i]);
+  }
+
+  template<class T>
+  size_t VariableArray2D<T>::prefixSum()
+  {
+    Index * pIndices = m_indices.data();
+    size_t total = 0;
+    for (size_t i = 0; i < m_indices.size(); i++)
+    {
+      pIndices[i].start = total;
+      total += pIndices[i].count;
+    }
+    return total;
+  }
+
+  template<class T>
+  template<typename CountFn, typename FillFn>
+  void VariableArray2D<T>::build(size_t a_nRows, CountFn const & a_countFn, FillFn const & a_fillFn)
+  {
+    clear();
+
+    Index * pIndices = m_indices.append_uninitialized(a_nRows);
+    for (size_t i = 0; i < a_nRows; i++)
+      pIndices[i].count = a_countFn(i);
+
+    T * pData = m_data.append_uninitialized(prefixSum());
+    for (size_t i = 0; i < a_nRows; i++)
+      a_fillFn(i, pData + pIndices[i].start, pIndices[i].count);
+  }
+
+  template<class T>
+  template<typename CountFn, typename FillFn>
+  void VariableArray2D<T>::build(WorkerPool & a_pool, size_t a_nRows, CountFn const & a_countFn, FillFn const & a_fillFn)
+  {
+    clear();
+
+    Index * pIndices = m_indices.append_uninitialized(a_nRows);
+    size_t nBlocks = (a_nRows + s_buildBlockSize - 1) / s_buildBlockSize;
+
+    impl::DispatchBlocks(a_pool, nBlocks, [pIndices, a_nRows, &a_countFn](size_t a_block)
+    {
+      size_t end = (a_block + 1) * s_buildBlockSize;
+      if (end > a_nRows) end = a_nRows;
+      for (size_t i = a_block * s_buildBlockSize; i < end; i++)
+        pIndices[i].count = a_countFn(i);
+    });
+
+    T * pData = m_data.append_uninitialized(prefixSum());
+
+    impl::DispatchBlocks(a_pool, nBlocks, [pIndices, pData, a_nRows, &a_fillFn](size_t a_block)
+    {
+      size_t end = (a_block + 1) * s_buildBlockSize;
+      if (end > a_nRows) end = a_nRows;
+      for (size_t i = a_block * s_buildBlockSize; i < end; i++)
+        a_fillFn(i, pData + pIndices[i].start, pIndices[i].count);
+    });
   }
 
   template<class T>
@@ -206,7 +304,7 @@ namespace Dg
     else if (a_element >= m_indices[a_row].count)
     {
       oss << "Element '" << a_element << "' out of range for row " << a_row 
-        << ". This row has " a_indices[a_row].count << " elements. ";
+        << ". This row has " << m_indices[a_row].count << " elements. ";
     }
 
     // if nothing has been written to oss then all indices are valid
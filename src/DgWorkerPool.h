@@ -3,17 +3,149 @@
 #ifndef DGWORKERPOOL_H
 #define DGWORKERPOOL_H
 
+#include <chrono>
+#include <new>
 #include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "DgError.h"
+#include "DgTaskFuture.h"
+#include "impl/DgTaskAllocator.h"
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+#include "DgWorkerPoolTelemetry.h"
+#endif
 
 namespace Dg
 {
   // We use a plain old function pointer instead of a std::function<void(void*)>. 
   // This allows the implementation of the Worker Pool to use minimal memory allocations.
-  // A consequence is the capture clause of a lambda must be empty.
+  // To run a lambda with captures, use the templated AddTask().
   typedef void (*WorkerPoolCallback)(void *);
 
+  // Each level has its own queues. Workers take from the highest level with work,
+  // except that one pick in four starts at Normal and one in sixteen at Low, so
+  // lower levels are never starved.
+  enum class TaskPriority : uint8_t
+  {
+    High,
+    Normal,
+    Low
+  };
+
+  // Scheduling hints for a single task.
+  struct TaskHint
+  {
+    static uint32_t const s_anyCacheGroup = 0xFFFFFFFF;
+
+    TaskHint(TaskPriority a_priority = TaskPriority::Normal, uint32_t a_cacheGroup = s_anyCacheGroup)
+      : priority(a_priority)
+      , cacheGroup(a_cacheGroup)
+    {}
+
+    TaskPriority priority;
+
+    // Run on a worker in this cache group if one is free; see WorkerPool::GetCacheGroup().
+    // Tasks which work on the same data should share a group.
+    uint32_t cacheGroup;
+  };
+
+  struct WorkerPoolConfig
+  {
+    uint32_t threadCount = 1;
+
+    // Pin each worker to a single CPU. Only supported on Linux; ignored elsewhere.
+    bool pinThreads = false;
+
+    // Worker i is pinned to cpus[i]. If empty, worker i is pinned to CPU i, modulo the CPU count.
+    std::vector<uint32_t> cpus;
+
+    // cacheGroups[i] is the cache group of worker i; groups must be numbered from 0.
+    // If empty and the workers are pinned, workers on CPUs sharing a cache of
+    // level cacheLevel are grouped together. Otherwise all workers are in group 0.
+    std::vector<uint32_t> cacheGroups;
+    uint32_t cacheLevel = 2;
+  };
+
+  namespace impl
+  {
+#ifdef __cpp_impl_coroutine
+    class ScheduleAwaiter;
+    class MainThreadAwaiter;
+#endif
+
+    // A queued task. Nodes come from TaskAllocator, so adding a task does not
+    // normally touch the heap.
+    //
+    // A callable added through the templated AddTask() is moved into storage
+    // if it fits, otherwise into a second block from TaskAllocator.
+    struct WorkerPoolTask
+    {
+      static size_t const s_inlineSize = 48;
+
+      // Runs the callable if a_run is set, then destroys it.
+      void (*invoke)(WorkerPoolTask *, bool run);
+      void * pCallable;
+      uint32_t callableSize;
+      uint32_t cacheGroup;
+      TaskPriority priority;
+      bool freeUserData;
+
+      WorkerPoolCallback function;
+      WorkerPoolCallback postFunction; // runs on main thread
+      void * pUserData;
+      WorkerPoolTask * pNext; // link in the post-work queue
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+      uint64_t queuedAtNs;
+#endif
+
+      alignas(TaskAllocator::s_alignment) unsigned char storage[s_inlineSize];
+
+      template<typename Fn>
+      static void Invoke(WorkerPoolTask * a_pTask, bool a_run)
+      {
+        Fn * pFn = static_cast<Fn *>(a_pTask->pCallable);
+        if (a_run)
+          (*pFn)();
+        pFn->~Fn();
+      }
+
+      template<typename Fn, typename Arg>
+      static WorkerPoolTask * Create(Arg && a_fn)
+      {
+        static_assert(alignof(Fn) <= TaskAllocator::s_alignment, "Over-aligned callables are not supported");
+
+        WorkerPoolTask * pTask = Create();
+        if (pTask == nullptr)
+          return nullptr;
+
+        if (sizeof(Fn) > s_inlineSize)
+        {
+          pTask->pCallable = TaskAllocator::Allocate(sizeof(Fn));
+          if (pTask->pCallable == nullptr)
+          {
+            Destroy(pTask);
+            return nullptr;
+          }
+          pTask->callableSize = (uint32_t)sizeof(Fn);
+        }
+
+        new (pTask->pCallable) Fn(std::forward<Arg>(a_fn));
+        pTask->invoke = Invoke<Fn>;
+        return pTask;
+      }
+
+      // A node with no callable
+      static WorkerPoolTask * Create();
+
+      // Destroys the callable, if it has not been run, and frees the node.
+      static void Destroy(WorkerPoolTask *);
+    };
+  }
+
   class WorkerPool
   {
     WorkerPool(WorkerPool const &) = delete;
@@ -23,24 +155,122 @@ namespace Dg
 
     // TODO We use a combination of ErrorCode and throw in this library. Maybe choose one error system.
     WorkerPool(uint32_t a_totalThreads);
+    WorkerPool(WorkerPoolConfig const &);
     ~WorkerPool();
 
     // Adds a function to run on a background thread, optionally with userdata. If clearMemory is true, it will call delete on pUserData after running
-    ErrorCode AddTask(WorkerPoolCallback func, void * pUserData = nullptr, bool clearMemory = true, WorkerPoolCallback postFunction = nullptr);
+    ErrorCode AddTask(WorkerPoolCallback func, void * pUserData = nullptr, bool clearMemory = true, WorkerPoolCallback postFunction = nullptr,
+                      TaskHint hint = TaskHint());
+
+    // Adds any callable taking no arguments, such as a lambda with captures, to run on a background thread.
+    // Callables of up to 48 bytes are stored in the task itself, larger ones in a pooled block.
+    template<typename Fn, typename = decltype(std::declval<typename std::decay<Fn>::type &>()())>
+    ErrorCode AddTask(Fn && fn, TaskHint hint = TaskHint());
+
+    // As above, and attaches future to the callable's result. Any previous task
+    // attached to future is detached.
+    template<typename Fn, typename R>
+    ErrorCode AddTask(Fn && fn, TaskFuture<R> & future, TaskHint hint = TaskHint());
+
+    // Queues a function to run on the main thread, in DoPostWork(), without
+    // first running anything on a worker.
+    ErrorCode AddMainThreadTask(WorkerPoolCallback func, void * pUserData = nullptr);
+
+#ifdef __cpp_impl_coroutine
+    // For coroutines; include DgWorkerPoolCoroutine.h to use these.
+    // co_await Schedule() resumes the coroutine as a pool task, so normally on a
+    // worker thread, though a thread helping in WaitAll() may pick it up.
+    impl::ScheduleAwaiter Schedule(TaskHint hint = TaskHint());
+
+    // co_await MainThread() resumes the coroutine from DoPostWork().
+    impl::MainThreadAwaiter MainThread();
+#endif
+
+    // Runs one queued task on the calling thread, if there is one.
+    // Returns true if a task was run.
+    bool RunPendingTask();
+
+    // Returns once no tasks are queued or running. The calling thread runs queued
+    // tasks while it waits, then parks until the last task finishes.
+    // Post work is not run. Returns Disallowed if called from within a task.
+    ErrorCode WaitAll();
 
     // This must be run on the main thread, handles marshalling work back from worker threads if required
     // The parameter can be used to limit how much work is done each time this is called
     // Returns number of tasks processed
     uint32_t DoPostWork(uint32_t processLimit = 0xFFFFFFFF);
 
+    // As above, but stops taking new tasks once the time budget has been used.
+    // At least one task is processed if any are waiting.
+    uint32_t DoPostWork(std::chrono::microseconds budget);
+
     // Returns true if there are workers currently processing tasks or if workers should be processing tasks
     bool HasActiveWorkers();
 
+    // Number of worker threads
+    uint32_t GetThreadCount() const;
+
+    uint32_t GetCacheGroupCount() const;
+    uint32_t GetCacheGroup(uint32_t workerIndex) const;
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+    // Copies the counters. May be called from any thread while tasks run; each
+    // value is read atomically, but the snapshot as a whole is not.
+    void GetTelemetry(WorkerPoolTelemetry &) const;
+
+    // Zeroes every counter and high-water mark.
+    void ResetTelemetry();
+#endif
+
+  private:
+
+    friend struct impl::FutureStateBase;
+
+    ErrorCode Submit(impl::WorkerPoolTask *);
+
   private:
 
     struct PIMPL;
     PIMPL * m_pimpl;
   };
+
+  template<typename Fn, typename>
+  ErrorCode WorkerPool::AddTask(Fn && a_fn, TaskHint a_hint)
+  {
+    impl::WorkerPoolTask * pTask = impl::WorkerPoolTask::Create<typename std::decay<Fn>::type>(std::forward<Fn>(a_fn));
+    if (pTask == nullptr)
+      return ErrorCode::FailedToAllocMem;
+    pTask->priority = a_hint.priority;
+    pTask->cacheGroup = a_hint.cacheGroup;
+    return Submit(pTask);
+  }
+
+  template<typename Fn, typename R>
+  ErrorCode WorkerPool::AddTask(Fn && a_fn, TaskFuture<R> & a_future, TaskHint a_hint)
+  {
+    typedef typename std::decay<Fn>::type Callable;
+    typedef impl::FutureTask<Callable, R> Task;
+    static_assert(std::is_void<R>::value || std::is_convertible<decltype(std::declval<Callable &>()()), R>::value,
+                  "The callable's result must convert to the future's type");
+
+    a_future.Reset();
+    impl::FutureState<R> * pState = impl::FutureState<R>::Create(this);
+    if (pState == nullptr)
+      return ErrorCode::FailedToAllocMem;
+
+    // If this fails, the unused Task has already released its reference.
+    impl::WorkerPoolTask * pTask = impl::WorkerPoolTask::Create<Task>(Task(std::forward<Fn>(a_fn), pState));
+    if (pTask == nullptr)
+    {
+      pState->Release();
+      return ErrorCode::FailedToAllocMem;
+    }
+
+    a_future.m_pState = pState;
+    pTask->priority = a_hint.priority;
+    pTask->cacheGroup = a_hint.cacheGroup;
+    return Submit(pTask);
+  }
 }
 
-#endif
\ No newline at end of file
+#endif
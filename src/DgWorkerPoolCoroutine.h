@@ -0,0 +1,493 @@
+//@group Misc
+
+#ifndef DGWORKERPOOLCOROUTINE_H
+#define DGWORKERPOOLCOROUTINE_H
+
+// C++20 coroutines on top of WorkerPool. Opt in by including this header
+// from a translation unit built as C++20; the rest of the library does not
+// depend on it.
+//
+//   AsyncTask<> LoadTexture(WorkerPool & pool, Path path)
+//   {
+//     co_await pool.Schedule();       // now on a worker
+//     Image image = Decode(ReadFile(path));
+//     co_await pool.MainThread();     // now in DoPostWork()
+//     Upload(image);
+//   }
+//
+//   LoadTexture(pool, path).Detach();
+
+#ifndef __cpp_impl_coroutine
+#error DgWorkerPoolCoroutine.h requires a compiler with C++20 coroutine support
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#include "DgWorkerPool.h"
+#include "impl/DgTaskAllocator.h"
+
+namespace Dg
+{
+  template<typename T = void>
+  class AsyncTask;
+
+  namespace impl
+  {
+    // Resumes the awaiting coroutine on a worker thread. If the task cannot be
+    // queued, the coroutine carries on on the current thread instead.
+    class ScheduleAwaiter
+    {
+    public:
+
+      ScheduleAwaiter(WorkerPool * a_pPool, TaskHint a_hint)
+        : m_pPool(a_pPool)
+        , m_hint(a_hint)
+      {}
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      // The coroutine may be resumed, and this awaiter destroyed, before
+      // AddTask() returns, so nothing here touches members afterwards.
+      bool await_suspend(std::coroutine_handle<> a_handle)
+      {
+        return m_pPool->AddTask([a_handle]() { a_handle.resume(); }, m_hint) == ErrorCode::None;
+      }
+
+      void await_resume() const noexcept {}
+
+    private:
+
+      WorkerPool *  m_pPool;
+      TaskHint      m_hint;
+    };
+
+    // Resumes the awaiting coroutine from WorkerPool::DoPostWork().
+    class MainThreadAwaiter
+    {
+    public:
+
+      explicit MainThreadAwaiter(WorkerPool * a_pPool)
+        : m_pPool(a_pPool)
+      {}
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      bool await_suspend(std::coroutine_handle<> a_handle)
+      {
+        return m_pPool->AddMainThreadTask(Resume, a_handle.address()) == ErrorCode::None;
+      }
+
+      void await_resume() const noexcept {}
+
+    private:
+
+      static void Resume(void * a_pHandle)
+      {
+        std::coroutine_handle<>::from_address(a_pHandle).resume();
+      }
+
+      WorkerPool * m_pPool;
+    };
+
+    // Who will deal with an AsyncTask's frame once the coroutine finishes.
+    enum class AsyncState : uint32_t
+    {
+      Running,    // The AsyncTask object; it destroys the frame
+      Awaited,    // The AsyncTask object, and the coroutine awaiting it is resumed
+      Detached,   // The coroutine itself
+      Done
+    };
+
+    class AsyncPromiseBase
+    {
+    public:
+
+      // Frames come from the task allocator, not the heap.
+      static void * operator new(size_t a_size) noexcept
+      {
+        return TaskAllocator::Allocate(a_size);
+      }
+
+      static void operator delete(void * a_ptr, size_t a_size) noexcept
+      {
+        TaskAllocator::Free(a_ptr, a_size);
+      }
+
+      struct FinalAwaiter
+      {
+        bool await_ready() const noexcept
+        {
+          return false;
+        }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> a_handle) noexcept
+        {
+          AsyncPromiseBase & promise = a_handle.promise();
+          AsyncState previous = promise.state.exchange(AsyncState::Done, std::memory_order_acq_rel);
+          if (previous == AsyncState::Awaited)
+            return promise.continuation;
+
+          if (previous == AsyncState::Detached)
+            a_handle.destroy();
+          return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+      };
+
+      // Tasks are lazy: nothing runs until the task is awaited, started or detached.
+      std::suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      FinalAwaiter final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void unhandled_exception() noexcept
+      {
+        exception = std::current_exception();
+      }
+
+      std::atomic<AsyncState>   state{AsyncState::Running};
+      std::coroutine_handle<>   continuation;
+      std::exception_ptr        exception;
+    };
+
+    template<typename T>
+    class AsyncPromise : public AsyncPromiseBase
+    {
+    public:
+
+      AsyncTask<T> get_return_object() noexcept;
+      static AsyncTask<T> get_return_object_on_allocation_failure() noexcept;
+
+      template<typename U>
+      void return_value(U && a_value)
+      {
+        value.emplace(std::forward<U>(a_value));
+      }
+
+      std::optional<T> value;
+    };
+
+    template<>
+    class AsyncPromise<void> : public AsyncPromiseBase
+    {
+    public:
+
+      AsyncTask<void> get_return_object() noexcept;
+      static AsyncTask<void> get_return_object_on_allocation_failure() noexcept;
+
+      void return_void() noexcept {}
+    };
+  }
+
+  // The result of a coroutine. Awaiting it runs the coroutine and resumes the
+  // awaiter, on whichever thread the coroutine finished on, once it is done.
+  //
+  // The coroutine does not run until the task is awaited, started or detached.
+  // An invalid task is returned if its frame could not be allocated.
+  // Destroying a task which has started but not finished detaches it.
+  //
+  // Move only.
+  template<typename T>
+  class AsyncTask
+  {
+    AsyncTask(AsyncTask const &) = delete;
+    AsyncTask & operator=(AsyncTask const &) = delete;
+
+  public:
+
+    typedef impl::AsyncPromise<T> promise_type;
+
+    AsyncTask();
+    ~AsyncTask();
+
+    AsyncTask(AsyncTask &&);
+    AsyncTask & operator=(AsyncTask &&);
+
+    bool IsValid() const;
+
+    // True once the coroutine has finished. Never blocks.
+    bool IsReady() const;
+
+    // Runs the coroutine on the calling thread up to its first suspension.
+    void Start();
+
+    // Starts the coroutine if it has not been started, and lets it free itself
+    // when it finishes. The task is then invalid.
+    void Detach();
+
+    // Returns the coroutine's result, or rethrows the exception it threw.
+    // Throws std::logic_error if the coroutine has not finished.
+    T Get();
+
+    auto operator co_await() noexcept;
+
+  private:
+
+    friend class impl::AsyncPromise<T>;
+
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    explicit AsyncTask(Handle a_handle)
+      : m_handle(a_handle)
+      , m_started(false)
+    {}
+
+    void Release();
+
+    Handle  m_handle;
+    bool    m_started;
+  };
+
+  namespace impl
+  {
+    template<typename T>
+    AsyncTask<T> AsyncPromise<T>::get_return_object() noexcept
+    {
+      return AsyncTask<T>(std::coroutine_handle<AsyncPromise>::from_promise(*this));
+    }
+
+    template<typename T>
+    AsyncTask<T> AsyncPromise<T>::get_return_object_on_allocation_failure() noexcept
+    {
+      return AsyncTask<T>();
+    }
+
+    inline AsyncTask<void> AsyncPromise<void>::get_return_object() noexcept
+    {
+      return AsyncTask<void>(std::coroutine_handle<AsyncPromise>::from_promise(*this));
+    }
+
+    inline AsyncTask<void> AsyncPromise<void>::get_return_object_on_allocation_failure() noexcept
+    {
+      return AsyncTask<void>();
+    }
+  }
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::AsyncTask()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  AsyncTask<T>::AsyncTask()
+    : m_handle(nullptr)
+    , m_started(false)
+  {
+
+  } //End: AsyncTask::AsyncTask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::~AsyncTask()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  AsyncTask<T>::~AsyncTask()
+  {
+    Release();
+  } //End: AsyncTask::~AsyncTask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::AsyncTask()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  AsyncTask<T>::AsyncTask(AsyncTask && a_other)
+    : m_handle(a_other.m_handle)
+    , m_started(a_other.m_started)
+  {
+    a_other.m_handle = nullptr;
+  } //End: AsyncTask::AsyncTask()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::operator=()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  AsyncTask<T> & AsyncTask<T>::operator=(AsyncTask && a_other)
+  {
+    if (this != &a_other)
+    {
+      Release();
+      m_handle = a_other.m_handle;
+      m_started = a_other.m_started;
+      a_other.m_handle = nullptr;
+    }
+    return *this;
+  } //End: AsyncTask::operator=()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::IsValid()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool AsyncTask<T>::IsValid() const
+  {
+    return m_handle != nullptr;
+  } //End: AsyncTask::IsValid()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::IsReady()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  bool AsyncTask<T>::IsReady() const
+  {
+    return m_handle != nullptr && m_handle.promise().state.load(std::memory_order_acquire) == impl::AsyncState::Done;
+  } //End: AsyncTask::IsReady()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::Start()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void AsyncTask<T>::Start()
+  {
+    if (m_handle == nullptr || m_started)
+      return;
+
+    m_started = true;
+    m_handle.resume();
+  } //End: AsyncTask::Start()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::Detach()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void AsyncTask<T>::Detach()
+  {
+    if (m_handle == nullptr)
+      return;
+
+    Start();
+
+    // If the coroutine has already finished it can no longer free itself.
+    if (m_handle.promise().state.exchange(impl::AsyncState::Detached, std::memory_order_acq_rel) == impl::AsyncState::Done)
+      m_handle.destroy();
+    m_handle = nullptr;
+  } //End: AsyncTask::Detach()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::Get()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  T AsyncTask<T>::Get()
+  {
+    if (!IsReady())
+      throw std::logic_error("AsyncTask has not finished");
+
+    promise_type & promise = m_handle.promise();
+    if (promise.exception)
+      std::rethrow_exception(promise.exception);
+
+    if constexpr (!std::is_void<T>::value)
+      return std::move(*promise.value);
+  } //End: AsyncTask::Get()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::operator co_await()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  auto AsyncTask<T>::operator co_await() noexcept
+  {
+    struct Awaiter
+    {
+      AsyncTask * pTask;
+
+      bool await_ready() const noexcept
+      {
+        return pTask->m_handle == nullptr || pTask->IsReady();
+      }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> a_awaiter) noexcept
+      {
+        promise_type & promise = pTask->m_handle.promise();
+        promise.continuation = a_awaiter;
+
+        if (!pTask->m_started)
+        {
+          // Nothing else can see the state yet. Run the task straight away.
+          pTask->m_started = true;
+          promise.state.store(impl::AsyncState::Awaited, std::memory_order_relaxed);
+          return pTask->m_handle;
+        }
+
+        // Already running elsewhere; if it finished in the meantime, carry on.
+        impl::AsyncState expected = impl::AsyncState::Running;
+        if (promise.state.compare_exchange_strong(expected, impl::AsyncState::Awaited, std::memory_order_acq_rel))
+          return std::noop_coroutine();
+        return a_awaiter;
+      }
+
+      T await_resume()
+      {
+        if (pTask->m_handle == nullptr)
+          throw std::logic_error("AsyncTask has no coroutine");
+        return pTask->Get();
+      }
+    };
+
+    return Awaiter{this};
+  } //End: AsyncTask::operator co_await()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ AsyncTask::Release()
+  //-------------------------------------------------------------------------------
+  template<typename T>
+  void AsyncTask<T>::Release()
+  {
+    if (m_handle == nullptr)
+      return;
+
+    if (m_started)
+    {
+      Detach();
+      return;
+    }
+
+    m_handle.destroy();
+    m_handle = nullptr;
+  } //End: AsyncTask::Release()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ WorkerPool::Schedule()
+  //-------------------------------------------------------------------------------
+  inline impl::ScheduleAwaiter WorkerPool::Schedule(TaskHint a_hint)
+  {
+    return impl::ScheduleAwaiter(this, a_hint);
+  } //End: WorkerPool::Schedule()
+
+
+  //-------------------------------------------------------------------------------
+  //		@ WorkerPool::MainThread()
+  //-------------------------------------------------------------------------------
+  inline impl::MainThreadAwaiter WorkerPool::MainThread()
+  {
+    return impl::MainThreadAwaiter(this);
+  } //End: WorkerPool::MainThread()
+}
+
+#endif
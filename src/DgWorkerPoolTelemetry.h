@@ -0,0 +1,75 @@
+//@group Misc
+
+#ifndef DGWORKERPOOLTELEMETRY_H
+#define DGWORKERPOOLTELEMETRY_H
+
+#include <stdint.h>
+#include <vector>
+
+// WorkerPool records these only when built with DG_WORKERPOOL_TELEMETRY
+// defined. The define changes the layout of WorkerPool's task nodes, so it must
+// be the same for every translation unit which includes DgWorkerPool.h.
+//
+// Counting costs three clock reads and a few uncontended atomic adds per task.
+// Without the define nothing is recorded and WorkerPool has no telemetry methods.
+
+namespace Dg
+{
+  // A snapshot of a log2 histogram. Bucket 0 counts zeros, and bucket i > 0
+  // counts values in [2^(i-1), 2^i).
+  struct WorkerPoolHistogram
+  {
+    static uint32_t const s_bucketCount = 65;
+
+    uint64_t buckets[s_bucketCount];
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+
+    uint64_t Mean() const
+    {
+      return count == 0 ? 0 : total / count;
+    }
+
+    // Upper bound of the bucket holding the given fraction, from 0 to 1, of samples.
+    uint64_t Percentile(double a_fraction) const
+    {
+      uint64_t target = (uint64_t)(a_fraction * (double)count);
+      uint64_t seen = 0;
+      for (uint32_t i = 0; i < s_bucketCount; i++)
+      {
+        seen += buckets[i];
+        if (seen > target || seen == count)
+          return i == 0 ? 0 : (i == 64 ? max : (uint64_t(1) << i) - 1);
+      }
+      return max;
+    }
+  };
+
+  struct WorkerPoolWorkerTelemetry
+  {
+    WorkerPoolHistogram queuedNs;   // From being added until starting to run
+    WorkerPoolHistogram runNs;
+    uint64_t spinNs;                // Looking for work before going to sleep
+    uint64_t idleNs;                // Asleep, waiting for work; added on waking
+  };
+
+  struct WorkerPoolTelemetry
+  {
+    // One entry per worker, indexed as for WorkerPool::GetCacheGroup(), then
+    // one shared by all threads outside the pool which ran tasks, through
+    // RunPendingTask() or while waiting.
+    std::vector<WorkerPoolWorkerTelemetry> workers;
+
+    // Most tasks ever waiting at once, per TaskPriority level, and on the
+    // overflow list behind the injection queues.
+    uint64_t queueDepthHighWater[3];
+    uint64_t overflowHighWater;
+
+    // Times a lock was found already held.
+    uint64_t overflowLockContention;
+    uint64_t sleepLockContention;
+  };
+}
+
+#endif
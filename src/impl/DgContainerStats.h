@@ -0,0 +1,34 @@
+//@group Collections/impl
+
+#ifndef DGCONTAINERSTATS_H
+#define DGCONTAINERSTATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Dg
+{
+  //! @ingroup DgContainers
+  //!
+  //! Memory and occupancy snapshot returned by a container's GetStats().
+  //! Fields which do not apply to a container are left at zero.
+  struct ContainerStats
+  {
+    static size_t const s_chainHistogramSize = 16;
+
+    size_t    elementCount = 0;
+    size_t    capacity = 0;         //Elements which fit before the next reallocation
+    size_t    bytesReserved = 0;
+    size_t    bytesUsed = 0;
+    size_t    poolSizeIndex = 0;    //Position in the PoolSizeManager table
+    uint32_t  poolResizes = 0;      //Times the pool size has changed
+    int32_t   treeHeight = 0;       //Tree_AVL
+
+    //! OpenHashMap: chainLengths[i] is the number of buckets holding a chain of
+    //! length i. The last entry also counts all longer chains.
+    size_t    chainLengths[s_chainHistogramSize] = {};
+    size_t    longestChain = 0;
+  };
+}
+
+#endif
@@ -0,0 +1,77 @@
+//@group Collections/impl
+
+#ifndef DGFILTERCOMMON_H
+#define DGFILTERCOMMON_H
+
+#include <stdint.h>
+
+#include "../DgBinaryReader.h"
+#include "../DgError.h"
+#include "../DgIO_Common.h"
+#include "../DgStream.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace Filter
+    {
+      // HASHER results are often weak (the default OpenHashMap hasher is the
+      // identity), but probabilistic filters need every bit to be well mixed.
+      // This is the 64-bit finaliser from MurmurHash3.
+      inline uint64_t Mix64(uint64_t a_h)
+      {
+        a_h ^= a_h >> 33;
+        a_h *= 0xff51afd7ed558ccdull;
+        a_h ^= a_h >> 33;
+        a_h *= 0xc4ceb9fe1a85ec53ull;
+        a_h ^= a_h >> 33;
+        return a_h;
+      }
+
+      // Maps a 32-bit hash onto [0, range) without a division.
+      inline uint64_t Reduce(uint32_t a_h, uint64_t a_range)
+      {
+        return (static_cast<uint64_t>(a_h) * a_range) >> 32;
+      }
+
+      // Checks a BinaryReader/BinaryWriter result against the expected count.
+      inline ErrorCode CheckIO(IO::ReturnType const & a_rt, IO::myInt a_expected, ErrorCode a_onShort)
+      {
+        if (a_rt.error != ErrorCode::None)
+          return a_rt.error;
+        if (a_rt.value != a_expected)
+          return a_onShort;
+        return ErrorCode::None;
+      }
+
+      // Read() trusts a size from the file only as far as the stream can back
+      // it. This is the limit used when the stream's length cannot be found.
+      uint64_t const s_maxUnboundedReadBytes = uint64_t(1) << 32;
+
+      // Bytes left to read in a_reader's stream, found by seeking to the end
+      // and back. Returns s_maxUnboundedReadBytes if the stream cannot seek,
+      // and 0 if its position could not be restored.
+      inline uint64_t RemainingBytes(BinaryReader & a_reader)
+      {
+        IO::ReturnType position = a_reader.GetPosition();
+        if (position.error != ErrorCode::None || position.value < 0)
+          return s_maxUnboundedReadBytes;
+
+        IO::ReturnType end = a_reader.Seek(0, StreamSeekOrigin::end);
+        if (end.error != ErrorCode::None || end.value < 0)
+          return s_maxUnboundedReadBytes;
+
+        IO::ReturnType restored = a_reader.SetPosition(position.value);
+        if (restored.error != ErrorCode::None || restored.value != position.value)
+          return 0;
+
+        return end.value > position.value ? static_cast<uint64_t>(end.value - position.value) : 0;
+      }
+
+      uint32_t const s_version = 1;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,86 @@
+//@group Misc/impl
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#define DG_FUTEX_NATIVE
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#endif
+
+#include "DgFutex.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace Futex
+    {
+      static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex words must be plain 32-bit integers");
+
+#ifdef DG_FUTEX_NATIVE
+
+      void Wait(std::atomic<uint32_t> & a_word, uint32_t a_expected, uint32_t a_timeoutUs)
+      {
+        timespec timeout;
+        timeout.tv_sec = a_timeoutUs / 1000000;
+        timeout.tv_nsec = (long)(a_timeoutUs % 1000000) * 1000;
+
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&a_word), FUTEX_WAIT_PRIVATE, a_expected,
+                a_timeoutUs == 0 ? nullptr : &timeout, nullptr, 0);
+      }
+
+      void WakeAll(std::atomic<uint32_t> & a_word)
+      {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&a_word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+      }
+
+#else
+
+      static size_t const s_bucketCount = 64;
+
+      struct Bucket
+      {
+        std::mutex mutex;
+        std::condition_variable cv;
+      };
+
+      static Bucket & GetBucket(std::atomic<uint32_t> & a_word)
+      {
+        static Bucket s_buckets[s_bucketCount];
+        size_t hash = reinterpret_cast<size_t>(&a_word) >> 4;
+        return s_buckets[hash % s_bucketCount];
+      }
+
+      void Wait(std::atomic<uint32_t> & a_word, uint32_t a_expected, uint32_t a_timeoutUs)
+      {
+        Bucket & bucket = GetBucket(a_word);
+        std::unique_lock<std::mutex> lock(bucket.mutex);
+        if (a_word.load() != a_expected)
+          return;
+
+        if (a_timeoutUs == 0)
+          bucket.cv.wait(lock);
+        else
+          bucket.cv.wait_for(lock, std::chrono::microseconds(a_timeoutUs));
+      }
+
+      void WakeAll(std::atomic<uint32_t> & a_word)
+      {
+        Bucket & bucket = GetBucket(a_word);
+        {
+          std::unique_lock<std::mutex> lock(bucket.mutex);
+        }
+        bucket.cv.notify_all();
+      }
+
+#endif
+    }
+  }
+}
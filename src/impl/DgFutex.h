@@ -0,0 +1,32 @@
+//@group Misc/impl
+
+#ifndef DGFUTEX_H
+#define DGFUTEX_H
+
+#include <atomic>
+#include <stdint.h>
+
+namespace Dg
+{
+  namespace impl
+  {
+    // Blocking on a 32-bit word, for threads which would otherwise spin waiting
+    // for another thread to change it.
+    //
+    // On Linux this is a futex, so a waiter costs nothing until woken. Elsewhere
+    // it falls back to a small table of mutex/condition variable pairs, picked by
+    // the address of the word.
+    namespace Futex
+    {
+      // Blocks while a_word == a_expected, until woken or, if a_timeoutUs is not
+      // zero, until that many microseconds have passed. May return spuriously,
+      // so callers must check the word again.
+      void Wait(std::atomic<uint32_t> & word, uint32_t expected, uint32_t timeoutUs = 0);
+
+      // Wakes every thread waiting on a_word. Call after changing the word.
+      void WakeAll(std::atomic<uint32_t> & word);
+    }
+  }
+}
+
+#endif
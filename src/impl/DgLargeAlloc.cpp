@@ -0,0 +1,118 @@
+//@group Collections/impl
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DG_LARGEALLOC_MMAP
+#endif
+
+#include "DgLargeAlloc.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace LargeAlloc
+    {
+#ifdef DG_LARGEALLOC_MMAP
+
+      static bool IsMapped(size_t a_bytes)
+      {
+        return a_bytes >= DG_LARGEALLOC_THRESHOLD;
+      }
+
+      static size_t RoundToPage(size_t a_bytes)
+      {
+        static size_t const s_pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (a_bytes + s_pageSize - 1) & ~(s_pageSize - 1);
+      }
+
+      static void AdviseHugePages(void * a_ptr, size_t a_bytes)
+      {
+#ifdef MADV_HUGEPAGE
+        // Only a hint; the kernel may not have THP enabled.
+        madvise(a_ptr, RoundToPage(a_bytes), MADV_HUGEPAGE);
+#else
+        (void)a_ptr;
+        (void)a_bytes;
+#endif
+      }
+
+      static void * Map(size_t a_bytes)
+      {
+        void * ptr = mmap(nullptr, RoundToPage(a_bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+          return nullptr;
+        AdviseHugePages(ptr, a_bytes);
+        return ptr;
+      }
+
+      void * Reallocate(void * a_ptr, size_t a_oldBytes, size_t a_newBytes)
+      {
+        if (a_ptr == nullptr)
+          a_oldBytes = 0;
+
+        bool oldMapped = a_ptr != nullptr && IsMapped(a_oldBytes);
+        bool newMapped = IsMapped(a_newBytes);
+
+        if (!oldMapped && !newMapped)
+          return realloc(a_ptr, a_newBytes);
+
+        if (oldMapped && newMapped)
+        {
+          size_t oldSize = RoundToPage(a_oldBytes);
+          size_t newSize = RoundToPage(a_newBytes);
+          if (oldSize == newSize)
+            return a_ptr;
+
+          void * ptr = mremap(a_ptr, oldSize, newSize, MREMAP_MAYMOVE);
+          if (ptr == MAP_FAILED)
+            return nullptr;
+          if (newSize > oldSize)
+            AdviseHugePages(ptr, a_newBytes);
+          return ptr;
+        }
+
+        // Crossing the threshold: one copy between the heap and a mapping.
+        void * ptr = newMapped ? Map(a_newBytes) : malloc(a_newBytes);
+        if (ptr == nullptr)
+          return nullptr;
+
+        if (a_ptr != nullptr)
+        {
+          memcpy(ptr, a_ptr, a_oldBytes < a_newBytes ? a_oldBytes : a_newBytes);
+          Free(a_ptr, a_oldBytes);
+        }
+        return ptr;
+      }
+
+      void Free(void * a_ptr, size_t a_bytes)
+      {
+        if (a_ptr == nullptr)
+          return;
+
+        if (IsMapped(a_bytes))
+          munmap(a_ptr, RoundToPage(a_bytes));
+        else
+          free(a_ptr);
+      }
+
+#else
+
+      void * Reallocate(void * a_ptr, size_t, size_t a_newBytes)
+      {
+        return realloc(a_ptr, a_newBytes);
+      }
+
+      void Free(void * a_ptr, size_t)
+      {
+        free(a_ptr);
+      }
+
+#endif
+    }
+  }
+}
@@ -0,0 +1,39 @@
+//@group Collections/impl
+
+#ifndef DGLARGEALLOC_H
+#define DGLARGEALLOC_H
+
+#include <stddef.h>
+
+// Blocks of at least this many bytes are mapped directly from the OS rather
+// than taken from the heap.
+#ifndef DG_LARGEALLOC_THRESHOLD
+#define DG_LARGEALLOC_THRESHOLD (size_t(32) << 20)
+#endif
+
+namespace Dg
+{
+  namespace impl
+  {
+    // Allocation for container buffers which may grow very large.
+    //
+    // Small blocks come from malloc/realloc. Where the platform supports it,
+    // blocks of DG_LARGEALLOC_THRESHOLD bytes or more are mapped from the OS,
+    // marked as candidates for transparent huge pages, and grown or shrunk by
+    // remapping, so the contents are never copied and peak memory is never
+    // the old size plus the new size. Elsewhere every block comes from the heap.
+    //
+    // The caller must track the size of each block, and pass it back in.
+    namespace LargeAlloc
+    {
+      // Same contract as realloc: on failure returns nullptr and a_ptr is
+      // untouched. a_ptr may be nullptr, with a_oldBytes 0.
+      void * Reallocate(void * a_ptr, size_t a_oldBytes, size_t a_newBytes);
+
+      // a_ptr may be nullptr.
+      void Free(void * a_ptr, size_t a_bytes);
+    }
+  }
+}
+
+#endif
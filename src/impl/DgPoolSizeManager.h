@@ -10,6 +10,9 @@
 #ifndef DG_POOLSIZEMANAGER_H
 #define DG_POOLSIZEMANAGER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #undef ARRAY_SIZE
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof(*x))
 
@@ -17,7 +20,7 @@ namespace Dg
 {
   namespace impl
   {
-    size_t const SizeTable_Root2[] =
+    inline constexpr size_t SizeTable_Root2[] =
     {
       0x10ull, 0x16ull, 0x20ull, 0x2dull, 0x40ull, 0x5aull, 0x80ull, 0xb5ull,
       0x100ull, 0x16aull, 0x200ull, 0x2d4ull, 0x400ull, 0x5a8ull, 0x800ull, 0xb50ull,
@@ -37,6 +40,21 @@ namespace Dg
       0xFFFFFFFFFFFFFFFFull
     };
 
+    //Doubling growth. Fewer reallocations than SizeTable_Root2, at the cost of
+    //up to half the pool going unused.
+    inline constexpr size_t SizeTable_Pow2[] =
+    {
+      0x10ull, 0x20ull, 0x40ull, 0x80ull, 0x100ull, 0x200ull, 0x400ull, 0x800ull,
+      0x1000ull, 0x2000ull, 0x4000ull, 0x8000ull, 0x10000ull, 0x20000ull, 0x40000ull, 0x80000ull,
+      0x100000ull, 0x200000ull, 0x400000ull, 0x800000ull, 0x1000000ull, 0x2000000ull, 0x4000000ull, 0x8000000ull,
+      0x10000000ull, 0x20000000ull, 0x40000000ull, 0x80000000ull, 0x100000000ull, 0x200000000ull, 0x400000000ull, 0x800000000ull,
+      0x1000000000ull, 0x2000000000ull, 0x4000000000ull, 0x8000000000ull, 0x10000000000ull, 0x20000000000ull, 0x40000000000ull, 0x80000000000ull,
+      0x100000000000ull, 0x200000000000ull, 0x400000000000ull, 0x800000000000ull, 0x1000000000000ull, 0x2000000000000ull, 0x4000000000000ull, 0x8000000000000ull,
+      0x10000000000000ull, 0x20000000000000ull, 0x40000000000000ull, 0x80000000000000ull, 0x100000000000000ull, 0x200000000000000ull, 0x400000000000000ull, 0x800000000000000ull,
+      0x1000000000000000ull, 0x2000000000000000ull, 0x4000000000000000ull, 0x8000000000000000ull,
+      0xFFFFFFFFFFFFFFFFull
+    };
+
       //0x35
       //0x61
       //0xC1
@@ -66,7 +84,7 @@ namespace Dg
 
 
     //TODO revise values. See https ://planetmath.org/goodhashtableprimes
-    size_t const SizeTable_Prime[] =
+    inline constexpr size_t SizeTable_Prime[] =
     {
       0x13, 0x1f, 0x2b, 0x3d, 0x59, 0x7f, 0xb5, 0xfb,
       0x167, 0x1fd, 0x2cf, 0x3fd, 0x5a7, 0x7f7, 0xb47, 0xffd,
@@ -93,6 +111,22 @@ namespace Dg
   //! Base class for containers. Contains a method of obtaining 
   //! a valid data pool size.
   //!
+  //! The table sets the growth policy. Besides the tables here, a caller can
+  //! supply their own ascending table of sizes, ending in SIZE_MAX. The table
+  //! is part of the container's type, so it must have external linkage (inline
+  //! or extern), or each translation unit gets its own, incompatible type:
+  //!
+  //!     inline constexpr size_t g_mySizes[] = {64, 256, 1024, 0xFFFFFFFFFFFFFFFFull};
+  //!     using MyPool = PoolSizeManager<g_mySizes, ARRAY_SIZE(g_mySizes)>;
+  //!     DynamicArray<int, MyPool> arr;
+  //!
+  //! Containers take the manager as their last template parameter: DynamicArray
+  //! (including DynamicArray<bool>), DoublyLinkedList, CircularDoublyLinkedList,
+  //! Tree_AVL, Map_AVL, Set_AVL, SlotMap and OpenHashMap. OpenHashMap sizes its
+  //! buckets with it and defaults to PoolSizeMngr_Prime; the others default to
+  //! PoolSizeMngr_Default. SlotMapSoA, whose template parameters are its element
+  //! types, always uses PoolSizeMngr_Default.
+  //!
   //! @author Frank B. Hart
   //! @date 24/08/2016
   template<size_t const * ARRAY, size_t N_ELEMENTS>
@@ -103,14 +137,17 @@ namespace Dg
     //! Constructor
     PoolSizeManager() 
       : m_index(0)
+      , m_nResizes(0)
     {
 
     }
 
     PoolSizeManager(size_t a_size) 
       : m_index(0)
+      , m_nResizes(0)
     {
       SetSize(a_size);
+      m_nResizes = 0;
     }
 
     //! Get the current size of the memory pool.
@@ -120,21 +157,34 @@ namespace Dg
       return ARRAY[m_index];
     }
 
+    //! Get the position of the current size in the table of valid sizes.
+    size_t GetIndex() const
+    {
+      return static_cast<size_t>(m_index);
+    }
+
+    //! Number of times the pool size has changed since construction.
+    uint32_t GetResizeCount() const
+    {
+      return m_nResizes;
+    }
+
     //! Set the current size of the memory pool.
     //! This is only a request. The memory pool is derived 
     //! from a table of valid memory pool sizes, but will endevour to 
     //! be at large enough to fit a_nItems.
     size_t SetSize(size_t a_nItems)
     {
+      int index = N_ELEMENTS - 1;
       for (size_t i = 0; i < N_ELEMENTS; i++)
       {
         if (a_nItems <= ARRAY[i])
         {
-          m_index = static_cast<int>(i);
-          return GetSize();
+          index = static_cast<int>(i);
+          break;
         }
       }
-      m_index = N_ELEMENTS - 1;
+      SetIndex(index);
       return GetSize();
     }
 
@@ -144,7 +194,7 @@ namespace Dg
     {
       if (m_index == N_ELEMENTS - 1)
         return GetSize();
-      m_index++;
+      SetIndex(m_index + 1);
       return GetSize();
     }
 
@@ -161,16 +211,27 @@ namespace Dg
     {
       if (m_index == 0)
         return GetSize();
-      m_index--;
+      SetIndex(m_index - 1);
       return GetSize();
     }
 
   private:
-    int   m_index;
+
+    void SetIndex(int a_index)
+    {
+      if (a_index != m_index)
+        m_nResizes++;
+      m_index = a_index;
+    }
+
+  private:
+    int       m_index;
+    uint32_t  m_nResizes;
   };
 
   using PoolSizeMngr_Root2 = PoolSizeManager<impl::SizeTable_Root2, ARRAY_SIZE(impl::SizeTable_Root2)>;
   using PoolSizeMngr_Prime = PoolSizeManager<impl::SizeTable_Prime, ARRAY_SIZE(impl::SizeTable_Prime)>;
+  using PoolSizeMngr_Pow2 = PoolSizeManager<impl::SizeTable_Pow2, ARRAY_SIZE(impl::SizeTable_Pow2)>;
 
   typedef PoolSizeMngr_Root2 PoolSizeMngr_Default;
 }
@@ -0,0 +1,220 @@
+//@group Misc/impl
+
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "DgTaskAllocator.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    namespace TaskAllocator
+    {
+      static size_t const s_classCount = 4;
+      static size_t const s_classSizes[s_classCount] = {64, 128, 256, 512};
+      static uint32_t const s_batchSize = 32;
+      static size_t const s_slabBlocks = 64;
+
+      struct FreeBlock
+      {
+        FreeBlock * pNext;
+        FreeBlock * pNextBatch;   // Only used by the first block of a batch on the global list
+      };
+
+      struct GlobalList
+      {
+        std::mutex  mutex;
+        FreeBlock * pBatches[s_classCount] = {};
+      };
+
+      // Never destroyed: thread caches may hand blocks back during thread exit,
+      // after static destructors have run.
+      static GlobalList & Global()
+      {
+        static GlobalList * s_pGlobal = new GlobalList();
+        return *s_pGlobal;
+      }
+
+      static size_t ClassIndex(size_t a_bytes)
+      {
+        size_t i = 0;
+        while (s_classSizes[i] < a_bytes)
+          i++;
+        return i;
+      }
+
+      // Set once this thread's cache has been destroyed. Trivially destructible,
+      // so it can still be read afterwards, for example by a static WorkerPool
+      // freeing its nodes at exit, after the main thread's cache has gone.
+      static thread_local bool t_cacheDestroyed = false;
+
+      struct ThreadCache
+      {
+        FreeBlock * pHead[s_classCount] = {};
+        uint32_t    count[s_classCount] = {};
+
+        ~ThreadCache()
+        {
+          for (size_t c = 0; c < s_classCount; c++)
+          {
+            while (count[c] != 0)
+              ReleaseBatch(c);
+          }
+          t_cacheDestroyed = true;
+        }
+
+        // Moves up to s_batchSize blocks to the global list.
+        void ReleaseBatch(size_t a_class)
+        {
+          FreeBlock * pBatch = pHead[a_class];
+          FreeBlock * pLast = pBatch;
+          uint32_t n = 1;
+          while (n < s_batchSize && pLast->pNext != nullptr)
+          {
+            pLast = pLast->pNext;
+            n++;
+          }
+
+          pHead[a_class] = pLast->pNext;
+          count[a_class] -= n;
+          pLast->pNext = nullptr;
+
+          GlobalList & global = Global();
+          std::unique_lock<std::mutex> lock(global.mutex);
+          pBatch->pNextBatch = global.pBatches[a_class];
+          global.pBatches[a_class] = pBatch;
+        }
+
+        bool Refill(size_t a_class)
+        {
+          GlobalList & global = Global();
+          {
+            std::unique_lock<std::mutex> lock(global.mutex);
+            FreeBlock * pBatch = global.pBatches[a_class];
+            if (pBatch != nullptr)
+            {
+              global.pBatches[a_class] = pBatch->pNextBatch;
+              uint32_t n = 0;
+              for (FreeBlock * pBlock = pBatch; pBlock != nullptr; pBlock = pBlock->pNext)
+                n++;
+              pHead[a_class] = pBatch;
+              count[a_class] = n;
+              return true;
+            }
+          }
+
+          size_t blockSize = s_classSizes[a_class];
+          char * pSlab = static_cast<char *>(malloc(blockSize * s_slabBlocks));
+          if (pSlab == nullptr)
+            return false;
+
+          for (size_t i = 0; i < s_slabBlocks; i++)
+          {
+            FreeBlock * pBlock = reinterpret_cast<FreeBlock *>(pSlab + i * blockSize);
+            pBlock->pNext = pHead[a_class];
+            pHead[a_class] = pBlock;
+          }
+          count[a_class] = (uint32_t)s_slabBlocks;
+          return true;
+        }
+      };
+
+      static thread_local ThreadCache t_cache;
+
+      // Used once the thread cache is gone: blocks go straight to and from the
+      // global list, one at a time.
+      static void * AllocateShared(size_t a_class)
+      {
+        GlobalList & global = Global();
+        std::unique_lock<std::mutex> lock(global.mutex);
+
+        FreeBlock * pBatch = global.pBatches[a_class];
+        if (pBatch == nullptr)
+        {
+          size_t blockSize = s_classSizes[a_class];
+          char * pSlab = static_cast<char *>(malloc(blockSize * s_slabBlocks));
+          if (pSlab == nullptr)
+            return nullptr;
+
+          for (size_t i = 0; i < s_slabBlocks; i++)
+          {
+            FreeBlock * pBlock = reinterpret_cast<FreeBlock *>(pSlab + i * blockSize);
+            pBlock->pNext = pBatch;
+            pBatch = pBlock;
+          }
+          pBatch->pNextBatch = nullptr;
+        }
+
+        // The rest of the batch, if any, stays on the list as a smaller batch.
+        FreeBlock * pRest = pBatch->pNext;
+        if (pRest != nullptr)
+        {
+          pRest->pNextBatch = pBatch->pNextBatch;
+          global.pBatches[a_class] = pRest;
+        }
+        else
+        {
+          global.pBatches[a_class] = pBatch->pNextBatch;
+        }
+        return pBatch;
+      }
+
+      static void FreeShared(size_t a_class, FreeBlock * a_pBlock)
+      {
+        GlobalList & global = Global();
+        std::unique_lock<std::mutex> lock(global.mutex);
+        a_pBlock->pNext = nullptr;
+        a_pBlock->pNextBatch = global.pBatches[a_class];
+        global.pBatches[a_class] = a_pBlock;
+      }
+
+      void * Allocate(size_t a_bytes)
+      {
+        if (a_bytes > s_maxBlockSize)
+          return ::operator new(a_bytes, std::nothrow);
+
+        size_t c = ClassIndex(a_bytes);
+        if (t_cacheDestroyed)
+          return AllocateShared(c);
+
+        if (t_cache.pHead[c] == nullptr && !t_cache.Refill(c))
+          return nullptr;
+
+        FreeBlock * pBlock = t_cache.pHead[c];
+        t_cache.pHead[c] = pBlock->pNext;
+        t_cache.count[c]--;
+        return pBlock;
+      }
+
+      void Free(void * a_ptr, size_t a_bytes)
+      {
+        if (a_ptr == nullptr)
+          return;
+
+        if (a_bytes > s_maxBlockSize)
+        {
+          ::operator delete(a_ptr);
+          return;
+        }
+
+        size_t c = ClassIndex(a_bytes);
+        FreeBlock * pBlock = static_cast<FreeBlock *>(a_ptr);
+        if (t_cacheDestroyed)
+        {
+          FreeShared(c, pBlock);
+          return;
+        }
+
+        pBlock->pNext = t_cache.pHead[c];
+        t_cache.pHead[c] = pBlock;
+        t_cache.count[c]++;
+
+        if (t_cache.count[c] >= 2 * s_batchSize)
+          t_cache.ReleaseBatch(c);
+      }
+    }
+  }
+}
@@ -0,0 +1,39 @@
+//@group Misc/impl
+
+#ifndef DGTASKALLOCATOR_H
+#define DGTASKALLOCATOR_H
+
+#include <stddef.h>
+
+namespace Dg
+{
+  namespace impl
+  {
+    // Fixed-size block allocator for short-lived task objects.
+    //
+    // Requests are rounded up to one of a few size classes. Each thread keeps a
+    // private free list per class, so an allocation or free normally touches no
+    // shared state. Blocks freed on a thread other than the one which allocated
+    // them simply join that thread's list. When a list runs dry or grows too long,
+    // a batch of blocks is moved to or from a locked global list.
+    //
+    // Once a thread's cache has been destroyed at thread exit, that thread
+    // allocates and frees through the locked global list directly, so objects
+    // destroyed later, such as a static WorkerPool, can still free their blocks.
+    //
+    // Memory is carved from slabs which are never returned to the system.
+    // Requests above s_maxBlockSize go to operator new.
+    namespace TaskAllocator
+    {
+      size_t const s_maxBlockSize = 512;
+      size_t const s_alignment = 16;
+
+      void * Allocate(size_t bytes);
+
+      // a_bytes must be the size passed to Allocate().
+      void Free(void * ptr, size_t bytes);
+    }
+  }
+}
+
+#endif
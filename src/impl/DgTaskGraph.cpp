@@ -0,0 +1,213 @@
+//@group Misc/impl
+
+#include "../DgTaskGraph.h"
+
+namespace Dg
+{
+  TaskGraph::TaskGraph()
+    : m_pRunTasks(nullptr)
+    , m_runTaskCount(0)
+    , m_pPool(nullptr)
+    , m_remaining(0)
+  {
+
+  }
+
+  TaskGraph::~TaskGraph()
+  {
+    delete[] m_pRunTasks;
+  }
+
+  TaskGraph::Handle TaskGraph::AddTask(WorkerPoolCallback a_func, void * a_pUserData)
+  {
+    if (a_func == nullptr || !IsComplete())
+      return INVALID_HANDLE;
+
+    Task task;
+    task.function = a_func;
+    task.pUserData = a_pUserData;
+    m_tasks.push_back(task);
+    return (Handle)(m_tasks.size() - 1);
+  }
+
+  ErrorCode TaskGraph::AddDependency(Handle a_before, Handle a_after)
+  {
+    if (!IsComplete())
+      return ErrorCode::Disallowed;
+
+    if (a_before >= m_tasks.size() || a_after >= m_tasks.size() || a_before == a_after)
+      return ErrorCode::InvalidInput;
+
+    Edge edge;
+    edge.before = a_before;
+    edge.after = a_after;
+    m_edges.push_back(edge);
+    return ErrorCode::None;
+  }
+
+  TaskGraph::Handle TaskGraph::AddContinuation(Handle a_before, WorkerPoolCallback a_func, void * a_pUserData)
+  {
+    if (a_before >= m_tasks.size())
+      return INVALID_HANDLE;
+
+    Handle handle = AddTask(a_func, a_pUserData);
+    if (handle != INVALID_HANDLE)
+      AddDependency(a_before, handle);
+    return handle;
+  }
+
+  ErrorCode TaskGraph::Clear()
+  {
+    if (!IsComplete())
+      return ErrorCode::Disallowed;
+
+    m_tasks.clear();
+    m_edges.clear();
+    return ErrorCode::None;
+  }
+
+  bool TaskGraph::IsComplete() const
+  {
+    return m_remaining.load(std::memory_order_acquire) == 0;
+  }
+
+  uint32_t TaskGraph::TaskCount() const
+  {
+    return (uint32_t)m_tasks.size();
+  }
+
+  // Lays the edges out by predecessor, counts the predecessors of each task, and
+  // checks there is no cycle, which would leave some join counter above zero forever.
+  ErrorCode TaskGraph::BuildSchedule()
+  {
+    uint32_t nTasks = (uint32_t)m_tasks.size();
+
+    m_successorStart.clear();
+    m_predecessorCount.clear();
+    for (uint32_t i = 0; i <= nTasks; i++)
+      m_successorStart.push_back(0);
+    for (uint32_t i = 0; i < nTasks; i++)
+      m_predecessorCount.push_back(0);
+
+    for (size_t i = 0; i < m_edges.size(); i++)
+    {
+      m_successorStart[m_edges[i].before + 1]++;
+      m_predecessorCount[m_edges[i].after]++;
+    }
+
+    for (uint32_t i = 0; i < nTasks; i++)
+      m_successorStart[i + 1] += m_successorStart[i];
+
+    m_successors.clear();
+    for (size_t i = 0; i < m_edges.size(); i++)
+      m_successors.push_back(0);
+
+    std::vector<uint32_t> cursor(m_successorStart);
+    for (size_t i = 0; i < m_edges.size(); i++)
+      m_successors[cursor[m_edges[i].before]++] = m_edges[i].after;
+
+    // Kahn's algorithm
+    std::vector<uint32_t> ready;
+    std::vector<uint32_t> joinCount(m_predecessorCount);
+    for (uint32_t i = 0; i < nTasks; i++)
+    {
+      if (joinCount[i] == 0)
+        ready.push_back(i);
+    }
+
+    uint32_t visited = 0;
+    while (!ready.empty())
+    {
+      uint32_t task = ready.back();
+      ready.pop_back();
+      visited++;
+
+      for (uint32_t k = m_successorStart[task]; k < m_successorStart[task + 1]; k++)
+      {
+        if (--joinCount[m_successors[k]] == 0)
+          ready.push_back(m_successors[k]);
+      }
+    }
+
+    return visited == nTasks ? ErrorCode::None : ErrorCode::InvalidInput;
+  }
+
+  ErrorCode TaskGraph::Launch(WorkerPool & a_pool)
+  {
+    if (!IsComplete())
+      return ErrorCode::Disallowed;
+
+    uint32_t nTasks = (uint32_t)m_tasks.size();
+    if (nTasks == 0)
+      return ErrorCode::None;
+
+    ErrorCode result = BuildSchedule();
+    if (result != ErrorCode::None)
+      return result;
+
+    if (m_runTaskCount != nTasks)
+    {
+      delete[] m_pRunTasks;
+      m_pRunTasks = new (std::nothrow) RunTask[nTasks];
+      m_runTaskCount = m_pRunTasks == nullptr ? 0 : nTasks;
+      if (m_pRunTasks == nullptr)
+        return ErrorCode::FailedToAllocMem;
+    }
+
+    for (uint32_t i = 0; i < nTasks; i++)
+    {
+      m_pRunTasks[i].pGraph = this;
+      m_pRunTasks[i].joinCount.store(m_predecessorCount[i], std::memory_order_relaxed);
+    }
+
+    m_pPool = &a_pool;
+    m_remaining.store(nTasks, std::memory_order_release);
+
+    for (uint32_t i = 0; i < nTasks; i++)
+    {
+      if (m_predecessorCount[i] == 0)
+        Submit(i);
+    }
+
+    return ErrorCode::None;
+  }
+
+  void TaskGraph::Submit(Handle a_handle)
+  {
+    // Only fails if out of memory. Rather than lose the task, and with it
+    // everything downstream, run it here.
+    if (m_pPool->AddTask(Execute, &m_pRunTasks[a_handle], false) != ErrorCode::None)
+      Execute(&m_pRunTasks[a_handle]);
+  }
+
+  void TaskGraph::Execute(void * a_pRunTask)
+  {
+    RunTask * pRunTask = static_cast<RunTask *>(a_pRunTask);
+    TaskGraph * pGraph = pRunTask->pGraph;
+    Handle handle = (Handle)(pRunTask - pGraph->m_pRunTasks);
+
+    while (handle != INVALID_HANDLE)
+    {
+      Task const & task = pGraph->m_tasks[handle];
+      task.function(task.pUserData);
+
+      Handle next = INVALID_HANDLE;
+      for (uint32_t k = pGraph->m_successorStart[handle]; k < pGraph->m_successorStart[handle + 1]; k++)
+      {
+        uint32_t successor = pGraph->m_successors[k];
+        if (pGraph->m_pRunTasks[successor].joinCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+          continue;
+
+        if (next == INVALID_HANDLE)
+          next = successor;
+        else
+          pGraph->Submit(successor);
+      }
+
+      // Once this reaches zero the graph may be relaunched or destroyed, so it
+      // must not be touched again. That cannot happen while next is still to run.
+      pGraph->m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+      handle = next;
+    }
+  }
+}
@@ -0,0 +1,217 @@
+//@group Misc/impl
+
+#ifndef DGWORKSTEALINGDEQUE_H
+#define DGWORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+
+namespace Dg
+{
+  namespace impl
+  {
+    // Chase-Lev work-stealing deque, following Le, Pop, Cohen and Zappa Nardelli,
+    // "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+    //
+    // The owning thread pushes and pops at the bottom; any other thread may
+    // steal from the top. Only a pop of the last item, or a steal, needs a CAS.
+    // The fences in the paper are folded into seq_cst accesses on top and bottom.
+    //
+    // The buffer grows when full. Outgrown buffers may still be read by a
+    // concurrent thief, so they are kept until the deque is destroyed.
+    template<typename T>
+    class WorkStealingDeque
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque holds trivially copyable items");
+
+      WorkStealingDeque(WorkStealingDeque const &) = delete;
+      WorkStealingDeque & operator=(WorkStealingDeque const &) = delete;
+
+    public:
+
+      WorkStealingDeque(int64_t capacity = 256);
+      ~WorkStealingDeque();
+
+      // Owner only.
+      void Push(T);
+
+      // Owner only. Returns false if the deque is empty.
+      bool Pop(T &);
+
+      // Any thread. Returns false if the deque is empty or the race was lost.
+      bool Steal(T &);
+
+      // Snapshot; may be stale.
+      int64_t SizeApprox() const;
+
+    private:
+
+      struct Buffer
+      {
+        int64_t           mask;
+        std::atomic<T> *  pItems;
+        Buffer *          pRetired;
+
+        T Get(int64_t a_i) const          {return pItems[a_i & mask].load(std::memory_order_relaxed);}
+        void Put(int64_t a_i, T a_item)   {pItems[a_i & mask].store(a_item, std::memory_order_relaxed);}
+      };
+
+      static Buffer * NewBuffer(int64_t capacity);
+      Buffer * Grow(Buffer *, int64_t bottom, int64_t top);
+
+    private:
+
+      static size_t const s_cacheLineSize = 64;
+
+      alignas(s_cacheLineSize) std::atomic<int64_t>  m_top;
+      alignas(s_cacheLineSize) std::atomic<int64_t>  m_bottom;
+      std::atomic<Buffer *>                          m_pBuffer;
+    };
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::WorkStealingDeque()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    WorkStealingDeque<T>::WorkStealingDeque(int64_t a_capacity)
+      : m_top(0)
+      , m_bottom(0)
+      , m_pBuffer(nullptr)
+    {
+      int64_t cap = 2;
+      while (cap < a_capacity)
+        cap <<= 1;
+      m_pBuffer.store(NewBuffer(cap), std::memory_order_relaxed);
+    } //End: WorkStealingDeque::WorkStealingDeque()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::~WorkStealingDeque()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    WorkStealingDeque<T>::~WorkStealingDeque()
+    {
+      Buffer * pBuffer = m_pBuffer.load(std::memory_order_relaxed);
+      while (pBuffer != nullptr)
+      {
+        Buffer * pRetired = pBuffer->pRetired;
+        delete[] pBuffer->pItems;
+        delete pBuffer;
+        pBuffer = pRetired;
+      }
+    } //End: WorkStealingDeque::~WorkStealingDeque()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::NewBuffer()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    typename WorkStealingDeque<T>::Buffer * WorkStealingDeque<T>::NewBuffer(int64_t a_capacity)
+    {
+      Buffer * pBuffer = new Buffer();
+      pBuffer->mask = a_capacity - 1;
+      pBuffer->pItems = new std::atomic<T>[static_cast<size_t>(a_capacity)];
+      pBuffer->pRetired = nullptr;
+      return pBuffer;
+    } //End: WorkStealingDeque::NewBuffer()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::Grow()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    typename WorkStealingDeque<T>::Buffer * WorkStealingDeque<T>::Grow(Buffer * a_pOld, int64_t a_bottom, int64_t a_top)
+    {
+      Buffer * pNew = NewBuffer((a_pOld->mask + 1) * 2);
+      for (int64_t i = a_top; i < a_bottom; i++)
+        pNew->Put(i, a_pOld->Get(i));
+      pNew->pRetired = a_pOld;
+      m_pBuffer.store(pNew, std::memory_order_release);
+      return pNew;
+    } //End: WorkStealingDeque::Grow()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::Push()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    void WorkStealingDeque<T>::Push(T a_item)
+    {
+      int64_t b = m_bottom.load(std::memory_order_relaxed);
+      int64_t t = m_top.load(std::memory_order_acquire);
+      Buffer * pBuffer = m_pBuffer.load(std::memory_order_relaxed);
+
+      if (b - t > pBuffer->mask)
+        pBuffer = Grow(pBuffer, b, t);
+
+      pBuffer->Put(b, a_item);
+      m_bottom.store(b + 1, std::memory_order_release);
+    } //End: WorkStealingDeque::Push()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::Pop()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    bool WorkStealingDeque<T>::Pop(T & a_out)
+    {
+      int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+      Buffer * pBuffer = m_pBuffer.load(std::memory_order_relaxed);
+      m_bottom.store(b, std::memory_order_seq_cst);
+      int64_t t = m_top.load(std::memory_order_seq_cst);
+
+      if (t > b)
+      {
+        //Empty
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+      }
+
+      a_out = pBuffer->Get(b);
+      if (t != b)
+        return true;
+
+      //Last item: race any thieves for it.
+      bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    } //End: WorkStealingDeque::Pop()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::Steal()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    bool WorkStealingDeque<T>::Steal(T & a_out)
+    {
+      int64_t t = m_top.load(std::memory_order_seq_cst);
+      int64_t b = m_bottom.load(std::memory_order_seq_cst);
+      if (t >= b)
+        return false;
+
+      Buffer * pBuffer = m_pBuffer.load(std::memory_order_acquire);
+      T item = pBuffer->Get(t);
+      if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return false;
+
+      a_out = item;
+      return true;
+    } //End: WorkStealingDeque::Steal()
+
+
+    //-------------------------------------------------------------------------------
+    //		@ WorkStealingDeque::SizeApprox()
+    //-------------------------------------------------------------------------------
+    template<typename T>
+    int64_t WorkStealingDeque<T>::SizeApprox() const
+    {
+      int64_t b = m_bottom.load(std::memory_order_relaxed);
+      int64_t t = m_top.load(std::memory_order_relaxed);
+      return b > t ? b - t : 0;
+    } //End: WorkStealingDeque::SizeApprox()
+  }
+}
+
+#endif
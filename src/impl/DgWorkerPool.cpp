@@ -1,95 +1,883 @@
 //@group Misc/impl
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
 #include <vector>
+#include <stdio.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define DG_WORKERPOOL_AFFINITY
+#endif
+
+#if defined(DG_WORKERPOOL_TELEMETRY) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "../DgWorkerPool.h"
 #include "../DgDoublyLinkedList.h"
+#include "../DgMPMCQueue.h"
+#include "DgWorkStealingDeque.h"
+#include "DgFutex.h"
+
+// Each worker owns a Chase-Lev deque per priority level. Tasks added from a
+// worker thread go onto that worker's deque; tasks added from any other thread,
+// or meant for another cache group, go through lock-free injection queues, one
+// set per cache group plus one for tasks with no group. A locked overflow list
+// sits behind them should they fill.
+//
+// For each priority level, an idle worker looks in its own deque, its group's
+// injection queue and the shared injection queue, then steals from workers in
+// its own group, then from any worker, and lastly takes from other groups'
+// injection queues. Only a worker with nothing to do after spinning takes a
+// lock, to sleep.
 
 namespace Dg
 {
-  struct WorkerPoolTask
+  using impl::WorkerPoolTask;
+
+  static uint32_t const s_priorityCount = 3;
+  static size_t const s_injectionQueueSize = 4096;
+  static size_t const s_groupQueueSize = 1024;
+  static uint32_t const s_idleSpins = 64;
+  static uint32_t const s_externalThread = 0xFFFFFFFF;
+
+  // Time a parked waiter sleeps before checking again. A worker waiting on a
+  // future uses the short timeout, as the task it needs may be queued behind
+  // others that only it can see; WaitAll() uses the long one as a safety net.
+  static uint32_t const s_workerParkUs = 1000;
+  static uint32_t const s_waitAllParkUs = 10000;
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+
+  static uint64_t NowNs()
+  {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Number of bits needed to hold a_value; 0 for 0.
+  static uint32_t BitWidth(uint64_t a_value)
+  {
+    if (a_value == 0)
+      return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - (uint32_t)__builtin_clzll(a_value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, a_value);
+    return (uint32_t)index + 1;
+#else
+    uint32_t width = 0;
+    while (a_value != 0)
+    {
+      a_value >>= 1;
+      width++;
+    }
+    return width;
+#endif
+  }
+
+  static void AtomicMax(std::atomic<uint64_t> & a_max, uint64_t a_value)
   {
-    WorkerPoolCallback function;
-    WorkerPoolCallback postFunction; // runs on main thread
-    void * pUserData;
-    bool freeUserData;
+    uint64_t current = a_max.load(std::memory_order_relaxed);
+    while (current < a_value && !a_max.compare_exchange_weak(current, a_value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  // Samples are only ever added, with relaxed atomics, so recording never
+  // waits on a reader. The count is the sum of the buckets.
+  class WorkerPoolAtomicHistogram
+  {
+  public:
+
+    void Record(uint64_t a_value)
+    {
+      m_buckets[BitWidth(a_value)].fetch_add(1, std::memory_order_relaxed);
+      m_total.fetch_add(a_value, std::memory_order_relaxed);
+      AtomicMax(m_max, a_value);
+    }
+
+    void Snapshot(WorkerPoolHistogram & a_out) const
+    {
+      a_out.count = 0;
+      for (uint32_t i = 0; i < WorkerPoolHistogram::s_bucketCount; i++)
+      {
+        a_out.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        a_out.count += a_out.buckets[i];
+      }
+      a_out.total = m_total.load(std::memory_order_relaxed);
+      a_out.max = m_max.load(std::memory_order_relaxed);
+    }
+
+    void Reset()
+    {
+      for (uint32_t i = 0; i < WorkerPoolHistogram::s_bucketCount; i++)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+      m_total.store(0, std::memory_order_relaxed);
+      m_max.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+
+    std::atomic<uint64_t> m_buckets[WorkerPoolHistogram::s_bucketCount];
+    std::atomic<uint64_t> m_total;
+    std::atomic<uint64_t> m_max;
+  };
+
+  struct WorkerPoolStats
+  {
+    WorkerPoolStats()
+    {
+      Reset();
+    }
+
+    void Reset()
+    {
+      queuedNs.Reset();
+      runNs.Reset();
+      spinNs.store(0, std::memory_order_relaxed);
+      idleNs.store(0, std::memory_order_relaxed);
+    }
+
+    void Snapshot(WorkerPoolWorkerTelemetry & a_out) const
+    {
+      queuedNs.Snapshot(a_out.queuedNs);
+      runNs.Snapshot(a_out.runNs);
+      a_out.spinNs = spinNs.load(std::memory_order_relaxed);
+      a_out.idleNs = idleNs.load(std::memory_order_relaxed);
+    }
+
+    WorkerPoolAtomicHistogram queuedNs;
+    WorkerPoolAtomicHistogram runNs;
+    std::atomic<uint64_t> spinNs;
+    std::atomic<uint64_t> idleNs;
+  };
+
+#endif
+
+  struct alignas(64) WorkerPoolWorker
+  {
+    impl::WorkStealingDeque<WorkerPoolTask *> deques[s_priorityCount];
+    uint32_t rngState;
+    uint32_t cacheGroup;
+    uint32_t picks;
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+    WorkerPoolStats stats;
+#endif
+  };
+
+  struct WorkerPoolInjectionQueues
+  {
+    WorkerPoolInjectionQueues(size_t a_size)
+    {
+      for (uint32_t i = 0; i < s_priorityCount; i++)
+        pQueues[i] = new MPMCQueue<WorkerPoolTask *>(a_size);
+    }
+
+    ~WorkerPoolInjectionQueues()
+    {
+      for (uint32_t i = 0; i < s_priorityCount; i++)
+        delete pQueues[i];
+    }
+
+    MPMCQueue<WorkerPoolTask *> * pQueues[s_priorityCount];
   };
 
   struct WorkerPool::PIMPL
   {
     PIMPL()
-      : threadsWaiting(0)
+      : anyGroupQueues(s_injectionQueueSize)
+      , groupCount(0)
+      , overflowCount(0)
+      , runningTasks(0)
+      , sleepingWorkers(0)
       , shouldQuit(false)
-    {}
+      , idleEpoch(0)
+      , idleWaiters(0)
+      , postStack(nullptr)
+      , pPostBatch(nullptr)
+    {
+      for (uint32_t i = 0; i < s_priorityCount; i++)
+        pendingTasks[i] = 0;
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+      ResetTelemetry();
+#endif
+    }
+
+    ~PIMPL();
+
+    void Init(WorkerPoolConfig const &);
+    void Submit(WorkerPoolTask *);
+    bool TakeTask(uint32_t workerIndex, uint32_t level, WorkerPoolTask *&);
+    WorkerPoolTask * FindTask(uint32_t workerIndex);
+    int64_t PendingTotal() const;
+    void RunTask(WorkerPoolTask *);
+    void WorkerLoop(uint32_t workerIndex);
+    void PushPostTask(WorkerPoolTask *);
+    WorkerPoolTask * PopPostTask();
+    static void RunPostTask(WorkerPoolTask *);
+    std::unique_lock<std::mutex> LockOverflow();
+    std::unique_lock<std::mutex> LockSleep();
 
-    std::atomic<uint32_t> threadsWaiting;
+#ifdef DG_WORKERPOOL_TELEMETRY
+    WorkerPoolStats & StatsForThread();
+    void ResetTelemetry();
+#endif
+
+    std::vector<WorkerPoolWorker *> workers;
+    std::vector<WorkerPoolInjectionQueues *> groupQueues;
+    WorkerPoolInjectionQueues anyGroupQueues;
+    uint32_t groupCount;
+
+    std::mutex overflowMutex;
+    Dg::DoublyLinkedList<WorkerPoolTask *> overflowTasks;
+    std::atomic<uint32_t> overflowCount;
+
+    // Tasks submitted but not yet picked up, per level.
+    std::atomic<int64_t> pendingTasks[s_priorityCount];
+    std::atomic<uint32_t> runningTasks;
+
+    std::atomic<uint32_t> sleepingWorkers;
     std::atomic<bool> shouldQuit;
-    std::mutex queuedTasksMutex;
-    std::mutex queuedPostTasksMutex;
+    std::mutex sleepMutex;
     std::condition_variable cv;
-    Dg::DoublyLinkedList<WorkerPoolTask> queuedTasks;
-    Dg::DoublyLinkedList<WorkerPoolTask> queuedPostTasks;
+
+    // Bumped, and waiters woken, when the pool becomes idle while WaitAll() is waiting.
+    std::atomic<uint32_t> idleEpoch;
+    std::atomic<uint32_t> idleWaiters;
+
+    // Finished tasks with a post function. Workers push onto postStack without
+    // locking. The main thread takes the whole stack with one exchange, and
+    // keeps it, oldest first, in pPostBatch until run.
+    std::atomic<WorkerPoolTask *> postStack;
+    WorkerPoolTask * pPostBatch;
     std::vector<std::thread> workerThreads;
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+    std::atomic<uint64_t> depthHighWater[s_priorityCount];
+    std::atomic<uint64_t> overflowHighWater;
+    std::atomic<uint64_t> overflowContention;
+    std::atomic<uint64_t> sleepContention;
+    WorkerPoolStats externalStats;
+#endif
   };
 
-  WorkerPool::WorkerPool(uint32_t a_totalThreads)
-    : m_pimpl(new PIMPL())
+  struct WorkerPoolThreadContext
   {
-    if (a_totalThreads == 0)
-      throw std::invalid_argument("Worker pool initialised with 0 threads!");
+    void const * pPool;
+    uint32_t workerIndex;
+  };
+
+  static thread_local WorkerPoolThreadContext t_workerContext = {nullptr, 0};
+
+  // Used in place of the worker's own state when a thread outside the pool runs tasks.
+  static thread_local uint32_t t_externalRng = 0x2545F491u;
+  static thread_local uint32_t t_externalPicks = 0;
+
+  // Depth of tasks a thread outside the pool is running for it through RunPendingTask().
+  static thread_local uint32_t t_externalTaskDepth = 0;
+
+  static uint32_t NextRandom(uint32_t & a_state)
+  {
+    // xorshift32
+    uint32_t x = a_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    a_state = x;
+    return x;
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // Affinity
+  //------------------------------------------------------------------------------------------------
+
+#ifdef DG_WORKERPOOL_AFFINITY
+
+  static bool PinThread(std::thread & a_thread, uint32_t a_cpu)
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(a_cpu, &cpus);
+    return pthread_setaffinity_np(a_thread.native_handle(), sizeof(cpu_set_t), &cpus) == 0;
+  }
+
+  // Returns the lowest numbered CPU which shares a cache of the given level with
+  // a_cpu, read from sysfs. Returns a_cpu itself if this cannot be determined.
+  static uint32_t CacheDomain(uint32_t a_cpu, uint32_t a_level)
+  {
+    for (uint32_t index = 0; index < 16; index++)
+    {
+      char path[128];
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", a_cpu, index);
+      FILE * pFile = fopen(path, "r");
+      if (pFile == nullptr)
+        break;
+
+      unsigned level = 0;
+      int read = fscanf(pFile, "%u", &level);
+      fclose(pFile);
+      if (read != 1 || level != a_level)
+        continue;
+
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", a_cpu, index);
+      pFile = fopen(path, "r");
+      if (pFile == nullptr)
+        break;
+
+      unsigned first = a_cpu;
+      read = fscanf(pFile, "%u", &first);
+      fclose(pFile);
+      return read == 1 ? first : a_cpu;
+    }
+    return a_cpu;
+  }
+
+#endif
+
+  //------------------------------------------------------------------------------------------------
+  // WorkerPoolTask
+  //------------------------------------------------------------------------------------------------
+
+  impl::WorkerPoolTask * impl::WorkerPoolTask::Create()
+  {
+    WorkerPoolTask * pTask = static_cast<WorkerPoolTask *>(TaskAllocator::Allocate(sizeof(WorkerPoolTask)));
+    if (pTask == nullptr)
+      return nullptr;
+
+    pTask->invoke = nullptr;
+    pTask->pCallable = pTask->storage;
+    pTask->callableSize = 0;
+    pTask->cacheGroup = TaskHint::s_anyCacheGroup;
+    pTask->priority = TaskPriority::Normal;
+    pTask->freeUserData = false;
+    pTask->function = nullptr;
+    pTask->postFunction = nullptr;
+    pTask->pUserData = nullptr;
+    pTask->pNext = nullptr;
+    return pTask;
+  }
+
+  void impl::WorkerPoolTask::Destroy(WorkerPoolTask * a_pTask)
+  {
+    if (a_pTask->invoke != nullptr)
+      a_pTask->invoke(a_pTask, false);
+    if (a_pTask->callableSize != 0)
+      TaskAllocator::Free(a_pTask->pCallable, a_pTask->callableSize);
+    TaskAllocator::Free(a_pTask, sizeof(WorkerPoolTask));
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // FutureStateBase
+  //------------------------------------------------------------------------------------------------
+
+  void impl::FutureStateBase::SetReady()
+  {
+    ready.store(1);
+    if (waiters.load() != 0)
+      Futex::WakeAll(ready);
+  }
+
+  void impl::FutureStateBase::Wait()
+  {
+    bool onWorker = t_workerContext.pPool == pPool->m_pimpl;
+    uint32_t spins = 0;
+    while (!IsReady())
+    {
+      if (pPool->RunPendingTask())
+      {
+        spins = 0;
+        continue;
+      }
+
+      if (spins++ < s_idleSpins)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // SetReady() stores ready before checking waiters, so one of us sees the other.
+      ++waiters;
+      if (!IsReady())
+        Futex::Wait(ready, 0, onWorker ? s_workerParkUs : 0);
+      --waiters;
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // WorkerPool::PIMPL
+  //------------------------------------------------------------------------------------------------
+
+  WorkerPool::PIMPL::~PIMPL()
+  {
+    // Tasks which never ran are dropped.
+    WorkerPoolTask * pTask = nullptr;
+    for (WorkerPoolWorker * pWorker : workers)
+    {
+      for (uint32_t level = 0; level < s_priorityCount; level++)
+      {
+        while (pWorker->deques[level].Pop(pTask))
+          WorkerPoolTask::Destroy(pTask);
+      }
+      delete pWorker;
+    }
+
+    groupQueues.push_back(&anyGroupQueues);
+    for (WorkerPoolInjectionQueues * pGroup : groupQueues)
+    {
+      for (uint32_t level = 0; level < s_priorityCount; level++)
+      {
+        while (pGroup->pQueues[level]->try_pop(pTask))
+          WorkerPoolTask::Destroy(pTask);
+      }
+      if (pGroup != &anyGroupQueues)
+        delete pGroup;
+    }
+
+    for (WorkerPoolTask * pOverflow : overflowTasks)
+      WorkerPoolTask::Destroy(pOverflow);
+
+    while ((pTask = PopPostTask()) != nullptr)
+      WorkerPoolTask::Destroy(pTask);
+  }
+
+  void WorkerPool::PIMPL::Init(WorkerPoolConfig const & a_config)
+  {
+    uint32_t nThreads = a_config.threadCount;
+    uint32_t nCpus = std::thread::hardware_concurrency();
+    if (nCpus == 0)
+      nCpus = 1;
+
+    std::vector<uint32_t> cpus;
+    for (uint32_t i = 0; i < nThreads; i++)
+      cpus.push_back(a_config.cpus.empty() ? i % nCpus : a_config.cpus[i % a_config.cpus.size()]);
+
+    // Number the cache groups from 0 in order of first appearance.
+    std::vector<uint32_t> domains;
+    std::vector<uint32_t> groups;
+    for (uint32_t i = 0; i < nThreads; i++)
+    {
+      uint32_t domain = 0;
+      if (!a_config.cacheGroups.empty())
+        domain = a_config.cacheGroups[i % a_config.cacheGroups.size()];
+#ifdef DG_WORKERPOOL_AFFINITY
+      else if (a_config.pinThreads)
+        domain = CacheDomain(cpus[i], a_config.cacheLevel);
+#endif
+
+      uint32_t group = 0;
+      while (group < domains.size() && domains[group] != domain)
+        group++;
+      if (group == domains.size())
+        domains.push_back(domain);
+      groups.push_back(group);
+    }
+
+    groupCount = (uint32_t)domains.size();
+    for (uint32_t g = 0; g < groupCount; g++)
+      groupQueues.push_back(new WorkerPoolInjectionQueues(s_groupQueueSize));
+
+    for (uint32_t i = 0; i < nThreads; i++)
+    {
+      workers.push_back(new WorkerPoolWorker());
+      workers.back()->rngState = 0x9E3779B9u * (i + 1);
+      workers.back()->cacheGroup = groups[i];
+      workers.back()->picks = 0;
+    }
+
+    for (uint32_t i = 0; i < nThreads; i++)
+    {
+      workerThreads.emplace_back([this, i] { this->WorkerLoop(i); });
+
+#ifdef DG_WORKERPOOL_AFFINITY
+      // Pinning is best effort; the CPU may not exist or be allowed.
+      if (a_config.pinThreads)
+        PinThread(workerThreads.back(), cpus[i]);
+#endif
+    }
+  }
+
+  void WorkerPool::PIMPL::Submit(WorkerPoolTask * a_pTask)
+  {
+    uint32_t level = (uint32_t)a_pTask->priority;
+    uint32_t group = a_pTask->cacheGroup;
+    if (group >= groupCount)
+      group = TaskHint::s_anyCacheGroup;
+
+    // Counted before it is visible, so a taker can never drive the count
+    // negative and HasActiveWorkers() never misses a queued task.
+#ifdef DG_WORKERPOOL_TELEMETRY
+    a_pTask->queuedAtNs = NowNs();
+    AtomicMax(depthHighWater[level], (uint64_t)++pendingTasks[level]);
+#else
+    ++pendingTasks[level];
+#endif
+
+    bool onWorker = t_workerContext.pPool == this;
+    if (onWorker && (group == TaskHint::s_anyCacheGroup || group == workers[t_workerContext.workerIndex]->cacheGroup))
+    {
+      workers[t_workerContext.workerIndex]->deques[level].Push(a_pTask);
+    }
+    else
+    {
+      WorkerPoolInjectionQueues * pQueues = group == TaskHint::s_anyCacheGroup ? &anyGroupQueues : groupQueues[group];
+      if (!pQueues->pQueues[level]->try_push(a_pTask))
+      {
+        std::unique_lock<std::mutex> lock = LockOverflow();
+        overflowTasks.push_back(a_pTask);
+#ifdef DG_WORKERPOOL_TELEMETRY
+        AtomicMax(overflowHighWater, ++overflowCount);
+#else
+        ++overflowCount;
+#endif
+      }
+    }
+
+    // A worker going to sleep increments sleepingWorkers before it checks
+    // pendingTasks, so one of us is guaranteed to see the other.
+    if (sleepingWorkers.load() != 0)
+    {
+      {
+        std::unique_lock<std::mutex> lock = LockSleep();
+      }
+      cv.notify_one();
+    }
+  }
+
+  bool WorkerPool::PIMPL::TakeTask(uint32_t a_workerIndex, uint32_t a_level, WorkerPoolTask *& a_pTask)
+  {
+    uint32_t workerCount = (uint32_t)workers.size();
+
+    if (a_workerIndex == s_externalThread)
+    {
+      if (anyGroupQueues.pQueues[a_level]->try_pop(a_pTask))
+        return true;
+
+      for (uint32_t g = 0; g < groupCount; g++)
+      {
+        if (groupQueues[g]->pQueues[a_level]->try_pop(a_pTask))
+          return true;
+      }
+
+      uint32_t x = NextRandom(t_externalRng);
+      for (uint32_t i = 0; i < workerCount; i++)
+      {
+        if (workers[(x + i) % workerCount]->deques[a_level].Steal(a_pTask))
+          return true;
+      }
+      return false;
+    }
+
+    WorkerPoolWorker * pSelf = workers[a_workerIndex];
+    uint32_t ownGroup = pSelf->cacheGroup;
+
+    if (pSelf->deques[a_level].Pop(a_pTask)
+      || groupQueues[ownGroup]->pQueues[a_level]->try_pop(a_pTask)
+      || anyGroupQueues.pQueues[a_level]->try_pop(a_pTask))
+      return true;
+
+    uint32_t x = NextRandom(pSelf->rngState);
 
-    for (uint32_t i = 0; i < a_totalThreads; i++)
+    // Steal from workers sharing our cache first.
+    if (groupCount > 1)
     {
-      m_pimpl->workerThreads.emplace_back([this]
-        {
-          while (!this->m_pimpl->shouldQuit)
-          {
-            ++this->m_pimpl->threadsWaiting;
-            WorkerPoolTask temp ={};
+      for (uint32_t i = 0; i < workerCount; i++)
+      {
+        uint32_t victim = (x + i) % workerCount;
+        if (victim != a_workerIndex && workers[victim]->cacheGroup == ownGroup && workers[victim]->deques[a_level].Steal(a_pTask))
+          return true;
+      }
+    }
 
-            {
-              std::unique_lock<std::mutex> lock(this->m_pimpl->queuedTasksMutex);
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+      uint32_t victim = (x + i) % workerCount;
+      if (victim != a_workerIndex && workers[victim]->deques[a_level].Steal(a_pTask))
+        return true;
+    }
 
-              this->m_pimpl->cv.wait(lock,
-                [this] { return (!this->m_pimpl->queuedTasks.empty()) || this->m_pimpl->shouldQuit; });
-              --this->m_pimpl->threadsWaiting;
+    for (uint32_t g = 0; g < groupCount; g++)
+    {
+      if (g != ownGroup && groupQueues[g]->pQueues[a_level]->try_pop(a_pTask))
+        return true;
+    }
 
-              if (this->m_pimpl->shouldQuit)
-                break;
+    return false;
+  }
 
-              temp = this->m_pimpl->queuedTasks.front();
-              this->m_pimpl->queuedTasks.pop_front();
-            }
+  WorkerPoolTask * WorkerPool::PIMPL::FindTask(uint32_t a_workerIndex)
+  {
+    // Levels in the order they are searched. Rows 1 and 2 keep lower levels
+    // from being starved by a steady stream of higher level tasks.
+    static uint32_t const s_order[3][s_priorityCount] =
+    {
+      {0, 1, 2},
+      {1, 0, 2},
+      {2, 0, 1}
+    };
 
-            temp.function(temp.pUserData);
+    uint32_t pick = a_workerIndex == s_externalThread ? t_externalPicks++ : workers[a_workerIndex]->picks++;
+    uint32_t const * pOrder = (pick & 15) == 15 ? s_order[2] : ((pick & 3) == 3 ? s_order[1] : s_order[0]);
 
-            if (temp.postFunction != nullptr)
-            {
-              std::unique_lock<std::mutex> lock(this->m_pimpl->queuedPostTasksMutex);
+    WorkerPoolTask * pTask = nullptr;
+    bool found = false;
+    for (uint32_t i = 0; i < s_priorityCount && !found; i++)
+    {
+      uint32_t level = pOrder[i];
+      if (pendingTasks[level].load(std::memory_order_relaxed) > 0)
+        found = TakeTask(a_workerIndex, level, pTask);
+    }
 
-              // TODO push_back can fail. It should return a ErrorCode and handled here.
-              // If push_back throws, this thread will never increment threadsWaiting,
-              // and will seem as if it is always working.
-              this->m_pimpl->queuedPostTasks.push_back(temp);
-            }
-            else if (temp.freeUserData)
-            {
-              delete temp.pUserData;
-              temp.pUserData = nullptr;
-            }
-          }
-        });
+    if (!found && overflowCount.load(std::memory_order_relaxed) != 0)
+    {
+      std::unique_lock<std::mutex> lock = LockOverflow();
+      if (!overflowTasks.empty())
+      {
+        pTask = overflowTasks.front();
+        overflowTasks.pop_front();
+        --overflowCount;
+        found = true;
+      }
     }
+
+    if (!found)
+      return nullptr;
+
+    // Count the task as running before it stops being pending, so
+    // HasActiveWorkers() never sees it as neither.
+    ++runningTasks;
+    --pendingTasks[(uint32_t)pTask->priority];
+    return pTask;
+  }
+
+  int64_t WorkerPool::PIMPL::PendingTotal() const
+  {
+    int64_t total = 0;
+    for (uint32_t level = 0; level < s_priorityCount; level++)
+      total += pendingTasks[level].load();
+    return total;
+  }
+
+  void WorkerPool::PIMPL::RunTask(WorkerPoolTask * a_pTask)
+  {
+#ifdef DG_WORKERPOOL_TELEMETRY
+    WorkerPoolStats & stats = StatsForThread();
+    uint64_t startNs = NowNs();
+    stats.queuedNs.Record(startNs - a_pTask->queuedAtNs);
+#endif
+
+    if (a_pTask->invoke != nullptr)
+    {
+      a_pTask->invoke(a_pTask, true);
+      a_pTask->invoke = nullptr;
+    }
+    else
+    {
+      a_pTask->function(a_pTask->pUserData);
+    }
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+    stats.runNs.Record(NowNs() - startNs);
+#endif
+
+    if (a_pTask->postFunction != nullptr)
+    {
+      PushPostTask(a_pTask);
+    }
+    else
+    {
+      if (a_pTask->freeUserData)
+        delete a_pTask->pUserData;
+      WorkerPoolTask::Destroy(a_pTask);
+    }
+
+    --runningTasks;
+
+    if (idleWaiters.load() != 0 && PendingTotal() <= 0 && runningTasks.load() == 0)
+    {
+      ++idleEpoch;
+      impl::Futex::WakeAll(idleEpoch);
+    }
+  }
+
+  void WorkerPool::PIMPL::PushPostTask(WorkerPoolTask * a_pTask)
+  {
+    WorkerPoolTask * pHead = postStack.load(std::memory_order_relaxed);
+    do
+    {
+      a_pTask->pNext = pHead;
+    } while (!postStack.compare_exchange_weak(pHead, a_pTask, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // Main thread only. The stack is only ever emptied with an exchange, never
+  // popped one item at a time, so there is no ABA problem.
+  WorkerPoolTask * WorkerPool::PIMPL::PopPostTask()
+  {
+    if (pPostBatch == nullptr)
+    {
+      WorkerPoolTask * pTask = postStack.exchange(nullptr, std::memory_order_acquire);
+
+      // Newest first; reverse to run in the order the tasks finished.
+      while (pTask != nullptr)
+      {
+        WorkerPoolTask * pNext = pTask->pNext;
+        pTask->pNext = pPostBatch;
+        pPostBatch = pTask;
+        pTask = pNext;
+      }
+
+      if (pPostBatch == nullptr)
+        return nullptr;
+    }
+
+    WorkerPoolTask * pTask = pPostBatch;
+    pPostBatch = pTask->pNext;
+    return pTask;
+  }
+
+  void WorkerPool::PIMPL::RunPostTask(WorkerPoolTask * a_pTask)
+  {
+    a_pTask->postFunction(a_pTask->pUserData);
+    if (a_pTask->freeUserData)
+      delete a_pTask->pUserData;
+    WorkerPoolTask::Destroy(a_pTask);
+  }
+
+  std::unique_lock<std::mutex> WorkerPool::PIMPL::LockOverflow()
+  {
+#ifdef DG_WORKERPOOL_TELEMETRY
+    std::unique_lock<std::mutex> lock(overflowMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+      overflowContention.fetch_add(1, std::memory_order_relaxed);
+      lock.lock();
+    }
+    return lock;
+#else
+    return std::unique_lock<std::mutex>(overflowMutex);
+#endif
+  }
+
+  std::unique_lock<std::mutex> WorkerPool::PIMPL::LockSleep()
+  {
+#ifdef DG_WORKERPOOL_TELEMETRY
+    std::unique_lock<std::mutex> lock(sleepMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+      sleepContention.fetch_add(1, std::memory_order_relaxed);
+      lock.lock();
+    }
+    return lock;
+#else
+    return std::unique_lock<std::mutex>(sleepMutex);
+#endif
+  }
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+
+  WorkerPoolStats & WorkerPool::PIMPL::StatsForThread()
+  {
+    if (t_workerContext.pPool == this)
+      return workers[t_workerContext.workerIndex]->stats;
+    return externalStats;
+  }
+
+  void WorkerPool::PIMPL::ResetTelemetry()
+  {
+    for (uint32_t level = 0; level < s_priorityCount; level++)
+      depthHighWater[level].store(0, std::memory_order_relaxed);
+    overflowHighWater.store(0, std::memory_order_relaxed);
+    overflowContention.store(0, std::memory_order_relaxed);
+    sleepContention.store(0, std::memory_order_relaxed);
+
+    for (WorkerPoolWorker * pWorker : workers)
+      pWorker->stats.Reset();
+    externalStats.Reset();
+  }
+
+#endif
+
+  void WorkerPool::PIMPL::WorkerLoop(uint32_t a_workerIndex)
+  {
+    t_workerContext.pPool = this;
+    t_workerContext.workerIndex = a_workerIndex;
+
+    while (!shouldQuit)
+    {
+      WorkerPoolTask * pTask = FindTask(a_workerIndex);
+#ifdef DG_WORKERPOOL_TELEMETRY
+      uint64_t spinStartNs = pTask == nullptr ? NowNs() : 0;
+#endif
+      for (uint32_t spin = 0; pTask == nullptr && spin < s_idleSpins && !shouldQuit; spin++)
+      {
+        std::this_thread::yield();
+        pTask = FindTask(a_workerIndex);
+      }
+#ifdef DG_WORKERPOOL_TELEMETRY
+      if (spinStartNs != 0)
+        workers[a_workerIndex]->stats.spinNs.fetch_add(NowNs() - spinStartNs, std::memory_order_relaxed);
+#endif
+
+      if (pTask != nullptr)
+      {
+        RunTask(pTask);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock = LockSleep();
+#ifdef DG_WORKERPOOL_TELEMETRY
+      uint64_t sleepStartNs = NowNs();
+#endif
+      ++sleepingWorkers;
+      cv.wait(lock, [this] { return PendingTotal() > 0 || shouldQuit; });
+      --sleepingWorkers;
+#ifdef DG_WORKERPOOL_TELEMETRY
+      workers[a_workerIndex]->stats.idleNs.fetch_add(NowNs() - sleepStartNs, std::memory_order_relaxed);
+#endif
+    }
+
+    t_workerContext.pPool = nullptr;
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // WorkerPool
+  //------------------------------------------------------------------------------------------------
+
+  static WorkerPoolConfig ThreadCountConfig(uint32_t a_totalThreads)
+  {
+    WorkerPoolConfig config;
+    config.threadCount = a_totalThreads;
+    return config;
+  }
+
+  WorkerPool::WorkerPool(uint32_t a_totalThreads)
+    : WorkerPool(ThreadCountConfig(a_totalThreads))
+  {
+
+  }
+
+  WorkerPool::WorkerPool(WorkerPoolConfig const & a_config)
+    : m_pimpl(nullptr)
+  {
+    if (a_config.threadCount == 0)
+      throw std::invalid_argument("Worker pool initialised with 0 threads!");
+
+    m_pimpl = new PIMPL();
+    m_pimpl->Init(a_config);
   }
 
   WorkerPool::~WorkerPool()
   {
     {
-      std::unique_lock<std::mutex> lock(m_pimpl->queuedTasksMutex);
+      std::unique_lock<std::mutex> lock(m_pimpl->sleepMutex);
       m_pimpl->shouldQuit = true;
     }
 
@@ -100,20 +888,38 @@ namespace Dg
     delete m_pimpl;
   }
 
-  ErrorCode WorkerPool::AddTask(WorkerPoolCallback a_func, void * a_pUserData, bool a_clearMemory, WorkerPoolCallback a_postFunction)
+  ErrorCode WorkerPool::AddTask(WorkerPoolCallback a_func, void * a_pUserData, bool a_clearMemory, WorkerPoolCallback a_postFunction,
+                                TaskHint a_hint)
   {
-    WorkerPoolTask temp{};
-    temp.freeUserData = a_clearMemory;
-    temp.function = a_func;
-    temp.postFunction = a_postFunction;
-    temp.pUserData = a_pUserData;
+    WorkerPoolTask * pTask = WorkerPoolTask::Create();
+    if (pTask == nullptr)
+      return ErrorCode::FailedToAllocMem;
 
-    {
-      std::unique_lock<std::mutex> lock(m_pimpl->queuedTasksMutex);
-      m_pimpl->queuedTasks.push_back(temp);
-    }
+    pTask->freeUserData = a_clearMemory;
+    pTask->function = a_func;
+    pTask->postFunction = a_postFunction;
+    pTask->pUserData = a_pUserData;
+    pTask->priority = a_hint.priority;
+    pTask->cacheGroup = a_hint.cacheGroup;
 
-    m_pimpl->cv.notify_one();
+    return Submit(pTask);
+  }
+
+  ErrorCode WorkerPool::AddMainThreadTask(WorkerPoolCallback a_func, void * a_pUserData)
+  {
+    WorkerPoolTask * pTask = WorkerPoolTask::Create();
+    if (pTask == nullptr)
+      return ErrorCode::FailedToAllocMem;
+
+    pTask->postFunction = a_func;
+    pTask->pUserData = a_pUserData;
+    m_pimpl->PushPostTask(pTask);
+    return ErrorCode::None;
+  }
+
+  ErrorCode WorkerPool::Submit(WorkerPoolTask * a_pTask)
+  {
+    m_pimpl->Submit(a_pTask);
     return ErrorCode::None;
   }
 
@@ -122,34 +928,122 @@ namespace Dg
     uint32_t doneTasks = 0;
     for (uint32_t i = 0; i < a_processLimit; i++)
     {
-      bool newTask = false;
-      WorkerPoolTask temp = {};
-      {
-        std::unique_lock<std::mutex> lock(m_pimpl->queuedPostTasksMutex);
-
-        if (!m_pimpl->queuedPostTasks.empty())
-        {
-          temp = m_pimpl->queuedPostTasks.front();
-          m_pimpl->queuedPostTasks.pop_front();
-          newTask = true;
-        }
-      }
-
-      if (!newTask)
+      WorkerPoolTask * pTask = m_pimpl->PopPostTask();
+      if (pTask == nullptr)
         break;
 
-      temp.postFunction(temp.pUserData);
-      if (temp.freeUserData)
-        delete temp.pUserData;
-
+      PIMPL::RunPostTask(pTask);
       doneTasks++;
     }
     return doneTasks;
   }
 
+  uint32_t WorkerPool::DoPostWork(std::chrono::microseconds a_budget)
+  {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + a_budget;
+
+    uint32_t doneTasks = 0;
+    do
+    {
+      WorkerPoolTask * pTask = m_pimpl->PopPostTask();
+      if (pTask == nullptr)
+        break;
+
+      PIMPL::RunPostTask(pTask);
+      doneTasks++;
+    } while (std::chrono::steady_clock::now() < deadline);
+    return doneTasks;
+  }
+
+  bool WorkerPool::RunPendingTask()
+  {
+    uint32_t workerIndex = t_workerContext.pPool == m_pimpl ? t_workerContext.workerIndex : s_externalThread;
+    WorkerPoolTask * pTask = m_pimpl->FindTask(workerIndex);
+    if (pTask == nullptr)
+      return false;
+
+    if (workerIndex == s_externalThread)
+      t_externalTaskDepth++;
+    m_pimpl->RunTask(pTask);
+    if (workerIndex == s_externalThread)
+      t_externalTaskDepth--;
+    return true;
+  }
+
+  ErrorCode WorkerPool::WaitAll()
+  {
+    // From inside a task, the caller would be waiting on itself.
+    if (t_workerContext.pPool == m_pimpl || t_externalTaskDepth != 0)
+      return ErrorCode::Disallowed;
+
+    while (HasActiveWorkers())
+    {
+      if (RunPendingTask())
+        continue;
+
+      // RunTask() decrements runningTasks before checking idleWaiters, and we
+      // increment idleWaiters before checking runningTasks.
+      uint32_t epoch = m_pimpl->idleEpoch.load();
+      ++m_pimpl->idleWaiters;
+      if (HasActiveWorkers())
+        impl::Futex::Wait(m_pimpl->idleEpoch, epoch, s_waitAllParkUs);
+      --m_pimpl->idleWaiters;
+    }
+    return ErrorCode::None;
+  }
+
   bool WorkerPool::HasActiveWorkers()
   {
-    std::unique_lock<std::mutex> lock(m_pimpl->queuedTasksMutex);
-    return (!m_pimpl->queuedTasks.empty() || (m_pimpl->threadsWaiting != (uint32_t)m_pimpl->workerThreads.size()));
+    // Read pending before running; see FindTask().
+    if (m_pimpl->PendingTotal() > 0)
+      return true;
+    return m_pimpl->runningTasks.load() != 0;
   }
-}
\ No newline at end of file
+
+  uint32_t WorkerPool::GetThreadCount() const
+  {
+    return (uint32_t)m_pimpl->workerThreads.size();
+  }
+
+  uint32_t WorkerPool::GetCacheGroupCount() const
+  {
+    return m_pimpl->groupCount;
+  }
+
+  uint32_t WorkerPool::GetCacheGroup(uint32_t a_workerIndex) const
+  {
+    if (a_workerIndex >= m_pimpl->workers.size())
+      throw std::out_of_range("Worker index out of range");
+    return m_pimpl->workers[a_workerIndex]->cacheGroup;
+  }
+
+#ifdef DG_WORKERPOOL_TELEMETRY
+
+  void WorkerPool::GetTelemetry(WorkerPoolTelemetry & a_out) const
+  {
+    a_out.workers.clear();
+    for (WorkerPoolWorker * pWorker : m_pimpl->workers)
+    {
+      WorkerPoolWorkerTelemetry worker;
+      pWorker->stats.Snapshot(worker);
+      a_out.workers.push_back(worker);
+    }
+
+    WorkerPoolWorkerTelemetry external;
+    m_pimpl->externalStats.Snapshot(external);
+    a_out.workers.push_back(external);
+
+    for (uint32_t level = 0; level < s_priorityCount; level++)
+      a_out.queueDepthHighWater[level] = m_pimpl->depthHighWater[level].load(std::memory_order_relaxed);
+    a_out.overflowHighWater = m_pimpl->overflowHighWater.load(std::memory_order_relaxed);
+    a_out.overflowLockContention = m_pimpl->overflowContention.load(std::memory_order_relaxed);
+    a_out.sleepLockContention = m_pimpl->sleepContention.load(std::memory_order_relaxed);
+  }
+
+  void WorkerPool::ResetTelemetry()
+  {
+    m_pimpl->ResetTelemetry();
+  }
+
+#endif
+}
@@ -0,0 +1,136 @@
+//@group Misc/impl
+
+#ifndef DGWORKERPOOLDISPATCH_H
+#define DGWORKERPOOLDISPATCH_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../DgWorkerPool.h"
+
+namespace Dg
+{
+  namespace impl
+  {
+    // Shared state for one call to DispatchWork. Lives on the caller's stack;
+    // DispatchWork does not return until every task it submitted has exited.
+    template<typename Work>
+    struct DispatchJob
+    {
+      // How long a joining thread with nothing to run sleeps before looking
+      // for queued tasks again.
+      static constexpr uint32_t s_parkUs = 1000;
+
+      Work *                  pWork;
+      uint32_t                runningTasks;
+      std::mutex              mutex;
+      std::condition_variable cv;
+
+      static void Task(void * a_pJob)
+      {
+        DispatchJob * pJob = static_cast<DispatchJob *>(a_pJob);
+        (*pJob->pWork)();
+
+        // The count is only touched under the lock, so the caller cannot see
+        // zero, and free the job, before this task has let go of it.
+        std::unique_lock<std::mutex> lock(pJob->mutex);
+        pJob->runningTasks--;
+        if (pJob->runningTasks == 0)
+          pJob->cv.notify_one();
+      }
+
+      // Runs other queued pool tasks until the submitted tasks have exited,
+      // parking only when there is nothing to run. As the joining thread keeps
+      // working, it is safe to join from inside a pool task.
+      void Join(WorkerPool & a_pool)
+      {
+        while (true)
+        {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (runningTasks == 0)
+              return;
+          }
+
+          if (a_pool.RunPendingTask())
+            continue;
+
+          std::unique_lock<std::mutex> lock(mutex);
+          if (runningTasks == 0)
+            return;
+          cv.wait_for(lock, std::chrono::microseconds(s_parkUs));
+        }
+      }
+    };
+
+    // Calls a_work() on up to a_nTasks pool tasks and on the calling thread,
+    // then returns once every call has returned. a_work is shared by all of
+    // them, so it must hand out the job itself, for example from an atomic
+    // counter.
+    template<typename Work>
+    void DispatchWork(WorkerPool & a_pool, size_t a_nTasks, Work & a_work)
+    {
+      DispatchJob<Work> job;
+      job.pWork = &a_work;
+      job.runningTasks = 0;
+
+      for (size_t i = 0; i < a_nTasks; i++)
+      {
+        {
+          std::unique_lock<std::mutex> lock(job.mutex);
+          job.runningTasks++;
+        }
+
+        if (a_pool.AddTask(DispatchJob<Work>::Task, &job, false) != ErrorCode::None)
+        {
+          std::unique_lock<std::mutex> lock(job.mutex);
+          job.runningTasks--;
+          break;
+        }
+      }
+
+      a_work();
+      job.Join(a_pool);
+    }
+
+    // Calls a_fn(blockIndex) for every block in [0, blockCount). Blocks are handed
+    // out through an atomic counter to pool tasks and to the calling thread, which
+    // works alongside them. At most one task per worker is submitted, and no more
+    // than a_maxTasks. Returns once all blocks are done. May be called from a
+    // pool task.
+    template<typename Fn>
+    void DispatchBlocks(WorkerPool & a_pool, size_t a_blockCount, Fn const & a_fn,
+                        uint32_t a_maxTasks = 0xFFFFFFFF)
+    {
+      if (a_blockCount == 0)
+        return;
+
+      std::atomic<size_t> nextBlock(0);
+      auto work = [&nextBlock, a_blockCount, &a_fn]()
+      {
+        while (true)
+        {
+          size_t block = nextBlock.fetch_add(1, std::memory_order_relaxed);
+          if (block >= a_blockCount)
+            break;
+          a_fn(block);
+        }
+      };
+
+      // The calling thread takes a share of the blocks, so one task fewer is needed.
+      size_t nTasks = a_blockCount - 1;
+      if (nTasks > a_maxTasks)
+        nTasks = a_maxTasks;
+      if (nTasks > a_pool.GetThreadCount())
+        nTasks = a_pool.GetThreadCount();
+
+      DispatchWork(a_pool, nTasks, work);
+    }
+  }
+}
+
+#endif